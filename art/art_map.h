@@ -0,0 +1,784 @@
+#ifndef TOOLS_ART_MAP_H
+#define TOOLS_ART_MAP_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "../memory/pool.h"
+#include "../vec/vec.h"
+
+namespace art {
+    /// Encodes an unsigned integer as a key whose byte order matches its numeric order.
+    inline auto encode(std::uint64_t key) -> std::string {
+        std::string result(8, '\0');
+        for (int i = 0; i < 8; i++) {
+            result[i] = static_cast<char>(key >> (56 - 8 * i));
+        }
+        return result;
+    }
+
+    /// Encodes a signed integer as a key whose byte order matches its numeric order.
+    inline auto encode(std::int64_t key) -> std::string {
+        return encode(static_cast<std::uint64_t>(key) ^ (std::uint64_t(1) << 63));
+    }
+}
+
+/// `ArtMap` is an ordered map from byte-string keys to values, implemented as an adaptive radix tree. Each inner node
+/// branches on one key byte and picks the smallest of four layouts (4, 16, 48 or 256 children) that fits its fan-out,
+/// and chains of single-child nodes are collapsed into a stored prefix. Lookups cost O(key length) regardless of the
+/// number of keys, and entries are visited in lexicographic byte order, which makes prefix and range scans cheap.
+/// Integer keys can be stored by encoding them with `art::encode`. Nodes can be drawn from a `SizeClassPool`.
+template <class V>
+class ArtMap {
+public:
+    using Size = std::size_t;
+private:
+    enum class Kind : std::uint8_t { leaf, node4, node16, node48, node256 };
+
+    /// A compressed path. Up to `inline_bytes` bytes are stored in place; longer paths live in a heap array whose
+    /// address takes their place. It takes 12 bytes where a `std::string` takes 32.
+    class Prefix {
+    private:
+        static constexpr Size inline_bytes = 8;
+        static_assert(sizeof(char*) <= inline_bytes);
+
+        std::uint32_t length = 0;
+        char bytes[inline_bytes] = {};
+
+        auto heap() const -> char* {
+            char* ptr = nullptr;
+            std::memcpy(&ptr, bytes, sizeof(ptr));
+            return ptr;
+        }
+
+        auto release() -> void {
+            if (length > inline_bytes) {
+                delete[] heap();
+            }
+            length = 0;
+        }
+    public:
+        Prefix() = default;
+        Prefix(const Prefix&) = delete;
+        auto operator=(const Prefix&) -> Prefix& = delete;
+
+        ~Prefix() {
+            release();
+        }
+
+        auto operator=(Prefix&& other) noexcept -> Prefix& {
+            if (this != &other) {
+                release();
+                length = std::exchange(other.length, 0);
+                std::memcpy(bytes, other.bytes, inline_bytes);
+            }
+            return *this;
+        }
+
+        /// Replaces the path with a copy of `path`, which may be part of this path.
+        auto operator=(std::string_view path) -> Prefix& {
+            char copy[inline_bytes] = {};
+            if (path.size() > inline_bytes) {
+                char* ptr = new char[path.size()];
+                std::memcpy(ptr, path.data(), path.size());
+                std::memcpy(copy, &ptr, sizeof(ptr));
+            } else {
+                std::memcpy(copy, path.data(), path.size());
+            }
+            release();
+            length = static_cast<std::uint32_t>(path.size());
+            std::memcpy(bytes, copy, inline_bytes);
+            return *this;
+        }
+
+        auto view() const -> std::string_view {
+            return std::string_view(length > inline_bytes ? heap() : bytes, length);
+        }
+
+        auto size() const -> Size {
+            return length;
+        }
+
+        /// Returns the number of bytes held on the heap.
+        auto heap_bytes() const -> Size {
+            return length > inline_bytes ? length : 0;
+        }
+    };
+
+    /// A node consumes `prefix` and then holds the value of the key ending there (if any) and the children branching
+    /// on the next byte. Nodes are not polymorphic, to keep leaves small: `NodeDeleter` destroys them by `kind`.
+    struct Node {
+        Kind kind;
+        std::uint16_t count = 0;
+        Prefix prefix;
+        std::optional<V> value;
+
+        explicit Node(Kind kind) : kind(kind) {}
+    };
+
+    /// Destroys a node and returns its memory to the pool it came from, if any.
+    struct NodeDeleter {
+        SizeClassPool* pool = nullptr;
+
+        auto operator()(Node* node) const -> void {
+            switch (node->kind) {
+                case Kind::leaf: destroy(static_cast<Leaf*>(node)); break;
+                case Kind::node4: destroy(static_cast<Node4*>(node)); break;
+                case Kind::node16: destroy(static_cast<Node16*>(node)); break;
+                case Kind::node48: destroy(static_cast<Node48*>(node)); break;
+                case Kind::node256: destroy(static_cast<Node256*>(node)); break;
+            }
+        }
+
+        template <class N>
+        auto destroy(N* node) const -> void {
+            if (pool == nullptr) {
+                delete node;
+                return;
+            }
+            node->~N();
+            pool->deallocate(node, sizeof(N));
+        }
+    };
+
+    using Link = std::unique_ptr<Node, NodeDeleter>;
+
+    /// A node without children, holding only the rest of its key (as the prefix) and the value. Most keys end in one,
+    /// so it carries no child slots. Adding a child grows it into a `Node4`.
+    struct Leaf : Node {
+        Leaf() : Node(Kind::leaf) {}
+    };
+
+    /// Children are kept sorted by key byte.
+    struct Node4 : Node {
+        std::uint8_t keys[4] = {};
+        Link children[4];
+
+        Node4() : Node(Kind::node4) {}
+    };
+
+    /// Children are kept sorted by key byte.
+    struct Node16 : Node {
+        std::uint8_t keys[16] = {};
+        Link children[16];
+
+        Node16() : Node(Kind::node16) {}
+    };
+
+    /// `index` maps a key byte to one plus the position of its child, or to zero if there is none. The first `count`
+    /// positions of `children` are occupied.
+    struct Node48 : Node {
+        std::uint8_t index[256] = {};
+        Link children[48];
+
+        Node48() : Node(Kind::node48) {}
+    };
+
+    struct Node256 : Node {
+        Link children[256];
+
+        Node256() : Node(Kind::node256) {}
+    };
+
+    Link root;
+    Size length = 0;
+    /// Where new nodes come from; `nullptr` for the global heap.
+    SizeClassPool* pool = nullptr;
+
+    template <class N>
+    static auto create(SizeClassPool* from) -> Link {
+        if (from == nullptr) {
+            return Link(new N(), NodeDeleter());
+        }
+        void* memory = from->allocate(sizeof(N), alignof(N));
+        return Link(new (memory) N(), NodeDeleter { from });
+    }
+
+    static auto make_node(Size fanout, SizeClassPool* from) -> Link {
+        if (fanout == 0) {
+            return create<Leaf>(from);
+        }
+        if (fanout <= 4) {
+            return create<Node4>(from);
+        }
+        if (fanout <= 16) {
+            return create<Node16>(from);
+        }
+        if (fanout <= 48) {
+            return create<Node48>(from);
+        }
+        return create<Node256>(from);
+    }
+
+    static auto make_leaf(std::string_view prefix, const V& val, SizeClassPool* from) -> Link {
+        auto leaf = create<Leaf>(from);
+        leaf->prefix = prefix;
+        leaf->value = val;
+        return leaf;
+    }
+
+    /// Returns the slot holding the child of `node` for `byte`, or `nullptr` if there is none.
+    static auto find_child(Node* node, std::uint8_t byte) -> Link* {
+        switch (node->kind) {
+            case Kind::leaf:
+                return nullptr;
+            case Kind::node4: {
+                auto* n = static_cast<Node4*>(node);
+                for (int i = 0; i < n->count; i++) {
+                    if (n->keys[i] == byte) {
+                        return &n->children[i];
+                    }
+                }
+                return nullptr;
+            }
+            case Kind::node16: {
+                auto* n = static_cast<Node16*>(node);
+#if defined(__SSE2__)
+                __m128i matches = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)),
+                                                 _mm_loadu_si128(reinterpret_cast<const __m128i*>(n->keys)));
+                unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(matches)) & ((1u << n->count) - 1);
+                return mask ? &n->children[std::countr_zero(mask)] : nullptr;
+#else
+                for (int i = 0; i < n->count; i++) {
+                    if (n->keys[i] == byte) {
+                        return &n->children[i];
+                    }
+                }
+                return nullptr;
+#endif
+            }
+            case Kind::node48: {
+                auto* n = static_cast<Node48*>(node);
+                return n->index[byte] ? &n->children[n->index[byte] - 1] : nullptr;
+            }
+            case Kind::node256: {
+                auto* n = static_cast<Node256*>(node);
+                return n->children[byte] ? &n->children[byte] : nullptr;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Calls `fn(byte, child)` for each child of `node` in key byte order, stopping early if `fn` returns `false`.
+    /// Returns `false` if stopped early.
+    template <class Fn>
+    static auto for_each_child(const Node* node, Fn fn) -> bool {
+        switch (node->kind) {
+            case Kind::leaf:
+                break;
+            case Kind::node4: {
+                auto* n = static_cast<const Node4*>(node);
+                for (int i = 0; i < n->count; i++) {
+                    if (!fn(n->keys[i], n->children[i].get())) {
+                        return false;
+                    }
+                }
+                break;
+            }
+            case Kind::node16: {
+                auto* n = static_cast<const Node16*>(node);
+                for (int i = 0; i < n->count; i++) {
+                    if (!fn(n->keys[i], n->children[i].get())) {
+                        return false;
+                    }
+                }
+                break;
+            }
+            case Kind::node48: {
+                auto* n = static_cast<const Node48*>(node);
+                for (int byte = 0; byte < 256; byte++) {
+                    if (n->index[byte] && !fn(static_cast<std::uint8_t>(byte), n->children[n->index[byte] - 1].get())) {
+                        return false;
+                    }
+                }
+                break;
+            }
+            case Kind::node256: {
+                auto* n = static_cast<const Node256*>(node);
+                for (int byte = 0; byte < 256; byte++) {
+                    if (n->children[byte] && !fn(static_cast<std::uint8_t>(byte), n->children[byte].get())) {
+                        return false;
+                    }
+                }
+                break;
+            }
+        }
+        return true;
+    }
+
+    /// Moves the prefix, value and children of `from` into the empty node `to`.
+    static auto move_into(Node* from, Link& to) -> void {
+        to->prefix = std::move(from->prefix);
+        to->value = std::move(from->value);
+        auto* source = from;
+        Node* target = to.get();
+        auto moved = [source, target](std::uint8_t byte, const Node*) {
+            add_child(target, byte, std::move(*find_child(source, byte)));
+            return true;
+        };
+        for_each_child(from, moved);
+    }
+
+    /// Inserts `child` under `byte` into `node`, which must have room for it (so it is not a leaf).
+    static auto add_child(Node* node, std::uint8_t byte, Link child) -> void {
+        switch (node->kind) {
+            case Kind::leaf:
+                return;
+            case Kind::node4:
+            case Kind::node16: {
+                std::uint8_t* keys = node->kind == Kind::node4 ? static_cast<Node4*>(node)->keys
+                                                                : static_cast<Node16*>(node)->keys;
+                Link* children = node->kind == Kind::node4 ? static_cast<Node4*>(node)->children
+                                                            : static_cast<Node16*>(node)->children;
+                int at = 0;
+                while (at < node->count && keys[at] < byte) {
+                    at++;
+                }
+                std::move_backward(keys + at, keys + node->count, keys + node->count + 1);
+                std::move_backward(children + at, children + node->count, children + node->count + 1);
+                keys[at] = byte;
+                children[at] = std::move(child);
+                break;
+            }
+            case Kind::node48: {
+                auto* n = static_cast<Node48*>(node);
+                n->children[n->count] = std::move(child);
+                n->index[byte] = static_cast<std::uint8_t>(n->count + 1);
+                break;
+            }
+            case Kind::node256:
+                static_cast<Node256*>(node)->children[byte] = std::move(child);
+                break;
+        }
+        node->count++;
+    }
+
+    static auto capacity_of(Kind kind) -> int {
+        switch (kind) {
+            case Kind::leaf: return 0;
+            case Kind::node4: return 4;
+            case Kind::node16: return 16;
+            case Kind::node48: return 48;
+            case Kind::node256: return 256;
+        }
+        return 0;
+    }
+
+    /// Inserts `child` under `byte` into the node held by `ref`, first growing it to the next layout if full.
+    static auto add_child(Link& ref, std::uint8_t byte, Link child) -> void {
+        if (ref->count == capacity_of(ref->kind)) {
+            Link grown = make_node(ref->count + 1, ref.get_deleter().pool);
+            move_into(ref.get(), grown);
+            ref = std::move(grown);
+        }
+        add_child(ref.get(), byte, std::move(child));
+    }
+
+    /// Removes the (empty) child under `byte` from the node held by `ref`, shrinking it to a smaller layout once it
+    /// is well under capacity, or to a leaf once it has no children left but still holds a value.
+    static auto remove_child(Link& ref, std::uint8_t byte) -> void {
+        Node* node = ref.get();
+        switch (node->kind) {
+            case Kind::leaf:
+                return;
+            case Kind::node4:
+            case Kind::node16: {
+                std::uint8_t* keys = node->kind == Kind::node4 ? static_cast<Node4*>(node)->keys
+                                                                : static_cast<Node16*>(node)->keys;
+                Link* children = node->kind == Kind::node4 ? static_cast<Node4*>(node)->children
+                                                            : static_cast<Node16*>(node)->children;
+                int at = static_cast<int>(std::find(keys, keys + node->count, byte) - keys);
+                std::move(keys + at + 1, keys + node->count, keys + at);
+                std::move(children + at + 1, children + node->count, children + at);
+                children[node->count - 1].reset();
+                break;
+            }
+            case Kind::node48: {
+                // Fill the hole with the last occupied position so the occupied positions stay contiguous.
+                auto* n = static_cast<Node48*>(node);
+                int hole = n->index[byte] - 1;
+                int last = n->count - 1;
+                n->index[byte] = 0;
+                if (hole != last) {
+                    n->children[hole] = std::move(n->children[last]);
+                    *std::find(n->index, n->index + 256, static_cast<std::uint8_t>(last + 1))
+                        = static_cast<std::uint8_t>(hole + 1);
+                }
+                n->children[last].reset();
+                break;
+            }
+            case Kind::node256:
+                static_cast<Node256*>(node)->children[byte].reset();
+                break;
+        }
+        node->count--;
+        bool sparse = (node->kind == Kind::node256 && node->count <= 37)
+            || (node->kind == Kind::node48 && node->count <= 12)
+            || (node->kind == Kind::node16 && node->count <= 3)
+            || (node->kind == Kind::node4 && node->count == 0 && node->value);
+        if (sparse) {
+            Link shrunk = make_node(node->count, ref.get_deleter().pool);
+            move_into(node, shrunk);
+            ref = std::move(shrunk);
+        }
+    }
+
+    static auto common_prefix(std::string_view a, std::string_view b) -> Size {
+        Size limit = std::min(a.size(), b.size());
+        return static_cast<Size>(std::mismatch(a.begin(), a.begin() + limit, b.begin()).first - a.begin());
+    }
+
+    auto insert_into(Link& ref, std::string_view key, Size depth, const V& val, bool assign) -> bool {
+        if (!ref) {
+            ref = make_leaf(key.substr(depth), val, pool);
+            return true;
+        }
+        Node* node = ref.get();
+        Size matched = common_prefix(node->prefix.view(), key.substr(depth));
+        if (matched < node->prefix.size()) {
+            // The key leaves the compressed path part way: split the path at the mismatch.
+            Link parent = create<Node4>(pool);
+            parent->prefix = node->prefix.view().substr(0, matched);
+            auto edge = static_cast<std::uint8_t>(node->prefix.view()[matched]);
+            node->prefix = node->prefix.view().substr(matched + 1);
+            add_child(parent.get(), edge, std::move(ref));
+            if (depth + matched == key.size()) {
+                parent->value = val;
+            } else {
+                add_child(parent.get(), static_cast<std::uint8_t>(key[depth + matched]),
+                          make_leaf(key.substr(depth + matched + 1), val, pool));
+            }
+            ref = std::move(parent);
+            return true;
+        }
+        depth += matched;
+        if (depth == key.size()) {
+            if (node->value) {
+                if (assign) {
+                    node->value = val;
+                }
+                return false;
+            }
+            node->value = val;
+            return true;
+        }
+        auto byte = static_cast<std::uint8_t>(key[depth]);
+        if (Link* child = find_child(node, byte)) {
+            return insert_into(*child, key, depth + 1, val, assign);
+        }
+        add_child(ref, byte, make_leaf(key.substr(depth + 1), val, pool));
+        return true;
+    }
+
+    auto remove_from(Link& ref, std::string_view key, Size depth) -> std::optional<V> {
+        Node* node = ref.get();
+        if (!node || key.substr(depth, node->prefix.size()) != node->prefix.view()) {
+            return std::nullopt;
+        }
+        depth += node->prefix.size();
+        std::optional<V> result;
+        if (depth == key.size()) {
+            result.swap(node->value);
+        } else {
+            auto byte = static_cast<std::uint8_t>(key[depth]);
+            Link* child = find_child(node, byte);
+            if (!child) {
+                return std::nullopt;
+            }
+            result = remove_from(*child, key, depth + 1);
+            if (!*child) {
+                remove_child(ref, byte);
+            }
+        }
+        if (!result) {
+            return std::nullopt;
+        }
+        node = ref.get();
+        if (!node->value && node->count == 0) {
+            ref.reset();
+        } else if (!node->value && node->count == 1) {
+            // Collapse a node left with a single child into that child's prefix.
+            std::uint8_t byte = 0;
+            for_each_child(node, [&byte](std::uint8_t b, const Node*) {
+                byte = b;
+                return false;
+            });
+            Link child = std::move(*find_child(node, byte));
+            auto path = std::string(node->prefix.view());
+            path += static_cast<char>(byte);
+            path += child->prefix.view();
+            child->prefix = path;
+            ref = std::move(child);
+        }
+        return result;
+    }
+
+    /// Returns the node reached after consuming all of `key`, and the part of its prefix left unconsumed.
+    auto descend(std::string_view key, Size& consumed) const -> const Node* {
+        Node* node = root.get();
+        Size depth = 0;
+        while (node) {
+            Size matched = common_prefix(node->prefix.view(), key.substr(depth));
+            if (depth + matched == key.size()) {
+                consumed = matched;
+                return node;
+            }
+            if (matched < node->prefix.size()) {
+                return nullptr;
+            }
+            depth += matched;
+            Link* child = find_child(node, static_cast<std::uint8_t>(key[depth]));
+            node = child ? child->get() : nullptr;
+            depth++;
+        }
+        return nullptr;
+    }
+
+    /// Visits the entries under `node` in order, with `key` holding the bytes leading to it. Entries below `low` are
+    /// skipped, and the walk stops (returning `false`) at the first key not below `high`, if bounded.
+    template <class Fn>
+    static auto walk(const Node* node, std::string& key, std::string_view low, const std::string_view* high, Fn& fn)
+        -> bool {
+        Size base = key.size();
+        key += node->prefix.view();
+        // `key` is the common prefix of every key in this subtree.
+        bool below = key.compare(0, std::string::npos, low.substr(0, key.size())) < 0;
+        if (below) {
+            key.resize(base);
+            return true;
+        }
+        if (high && key.compare(0, std::string::npos, high->substr(0, key.size())) > 0) {
+            key.resize(base);
+            return false;
+        }
+        bool keep_going = true;
+        if (node->value && key >= low) {
+            if (high && key >= *high) {
+                key.resize(base);
+                return false;
+            }
+            fn(std::string_view(key), *node->value);
+        }
+        keep_going = for_each_child(node, [&](std::uint8_t byte, const Node* child) {
+            key.push_back(static_cast<char>(byte));
+            bool more = walk(child, key, low, high, fn);
+            key.pop_back();
+            return more;
+        });
+        key.resize(base);
+        return keep_going;
+    }
+
+    static auto footprint(const Node* node) -> Size {
+        Size bytes = node->prefix.heap_bytes();
+        switch (node->kind) {
+            case Kind::leaf: bytes += sizeof(Leaf); break;
+            case Kind::node4: bytes += sizeof(Node4); break;
+            case Kind::node16: bytes += sizeof(Node16); break;
+            case Kind::node48: bytes += sizeof(Node48); break;
+            case Kind::node256: bytes += sizeof(Node256); break;
+        }
+        for_each_child(node, [&bytes](std::uint8_t, const Node* child) {
+            bytes += footprint(child);
+            return true;
+        });
+        return bytes;
+    }
+
+    /// Builds the subtree for the sorted, unique entries [first, last), whose keys share their first `depth` bytes.
+    static auto build(const std::pair<std::string, V>* first, const std::pair<std::string, V>* last, Size depth,
+                      SizeClassPool* from) -> Link {
+        if (last - first == 1) {
+            return make_leaf(std::string_view(first->first).substr(depth), first->second, from);
+        }
+        std::string_view low = std::string_view(first->first).substr(depth);
+        std::string_view high = std::string_view((last - 1)->first).substr(depth);
+        Size shared = common_prefix(low, high);
+        Size end = depth + shared;
+        const std::pair<std::string, V>* at = first;
+        std::optional<V> value;
+        if (at->first.size() == end) {
+            value = at->second;
+            at++;
+        }
+        Size fanout = 0;
+        for (auto* group = at; group != last; fanout++) {
+            auto byte = group->first[end];
+            group = std::find_if(group, last, [byte, end](const auto& entry) { return entry.first[end] != byte; });
+        }
+        Link node = make_node(fanout, from);
+        node->prefix = low.substr(0, shared);
+        node->value = std::move(value);
+        while (at != last) {
+            auto byte = at->first[end];
+            auto* group_end = std::find_if(at, last, [byte, end](const auto& entry) { return entry.first[end] != byte; });
+            add_child(node.get(), static_cast<std::uint8_t>(byte), build(at, group_end, end + 1, from));
+            at = group_end;
+        }
+        return node;
+    }
+
+    /// Fills the empty map with `entries` (see `from_sorted`).
+    auto load(const Vec<std::pair<std::string, V>>& entries) -> void {
+        const std::pair<std::string, V>* data = entries.raw_ptr_begin();
+        Size n = entries.size();
+        bool strictly_sorted = std::adjacent_find(data, data + n, [](const auto& a, const auto& b) {
+            return a.first >= b.first;
+        }) == data + n;
+        if (!strictly_sorted) {
+            for (Size i = 0; i < n; i++) {
+                insert(data[i].first, data[i].second);
+            }
+        } else if (n > 0) {
+            root = build(data, data + n, 0, pool);
+            length = n;
+        }
+    }
+public:
+    /// Constructs an empty map.
+    ArtMap() = default;
+
+    /// Constructs an empty map whose nodes are drawn from `pool`, which must outlive the map.
+    explicit ArtMap(SizeClassPool& pool) : pool(&pool) {}
+
+    /// Constructs a map from `entries`. If the keys are strictly increasing, each node is built once with its final
+    /// layout; otherwise the entries are inserted one at a time (later duplicates are ignored).
+    static auto from_sorted(const Vec<std::pair<std::string, V>>& entries) -> ArtMap<V> {
+        auto result = ArtMap<V>();
+        result.load(entries);
+        return result;
+    }
+
+    /// Constructs a map from `entries` as above, with nodes drawn from `pool`.
+    static auto from_sorted(const Vec<std::pair<std::string, V>>& entries, SizeClassPool& pool) -> ArtMap<V> {
+        auto result = ArtMap<V>(pool);
+        result.load(entries);
+        return result;
+    }
+
+    /// Inserts `key` mapped to a copy of `val` if `key` is not present. Returns `true` if an insertion took place.
+    auto insert(std::string_view key, const V& val) -> bool {
+        bool inserted = insert_into(root, key, 0, val, false);
+        length += inserted;
+        return inserted;
+    }
+
+    /// Maps `key` to a copy of `val`, replacing any existing value. Returns `true` if `key` was not present.
+    auto insert_or_assign(std::string_view key, const V& val) -> bool {
+        bool inserted = insert_into(root, key, 0, val, true);
+        length += inserted;
+        return inserted;
+    }
+
+    /// Removes `key` and returns its value, or `std::nullopt` if `key` is not present.
+    auto remove(std::string_view key) -> std::optional<V> {
+        auto result = remove_from(root, key, 0);
+        length -= result.has_value();
+        return result;
+    }
+
+    /// Returns a pointer to the value mapped to `key`, or `nullptr` if `key` is not present.
+    auto find(std::string_view key) const -> const V* {
+        Size consumed = 0;
+        const Node* node = descend(key, consumed);
+        return node && consumed == node->prefix.size() && node->value ? &*node->value : nullptr;
+    }
+
+    /// Returns a pointer to the value mapped to `key`, or `nullptr` if `key` is not present.
+    auto find(std::string_view key) -> V* {
+        return const_cast<V*>(std::as_const(*this).find(key));
+    }
+
+    /// Returns if `key` is present.
+    auto contains(std::string_view key) const -> bool {
+        return find(key) != nullptr;
+    }
+
+    /// Returns a reference to the value mapped to `key`.
+    /// @throws NoSuchElement if `key` is not present.
+    auto at(std::string_view key) const -> const V& {
+        const V* val = find(key);
+        if (val == nullptr) {
+            throw error::NoSuchElement("key not found in map.");
+        }
+        return *val;
+    }
+
+    /// Calls `fn(key, value)` for every entry, in key order.
+    template <class Fn>
+    auto for_each(Fn fn) const -> void {
+        if (root) {
+            std::string key;
+            walk(root.get(), key, std::string_view(), nullptr, fn);
+        }
+    }
+
+    /// Calls `fn(key, value)` for every entry whose key starts with `prefix`, in key order. Only the subtree below
+    /// `prefix` is visited.
+    template <class Fn>
+    auto for_each_prefix(std::string_view prefix, Fn fn) const -> void {
+        Size consumed = 0;
+        const Node* node = descend(prefix, consumed);
+        if (node) {
+            std::string key(prefix.substr(0, prefix.size() - consumed));
+            walk(node, key, std::string_view(), nullptr, fn);
+        }
+    }
+
+    /// Calls `fn(key, value)` for every entry whose key lies in [`low`, `high`), in key order.
+    template <class Fn>
+    auto for_each_range(std::string_view low, std::string_view high, Fn fn) const -> void {
+        if (root && low < high) {
+            std::string key;
+            walk(root.get(), key, low, &high, fn);
+        }
+    }
+
+    /// Returns the number of bytes used by the tree's nodes (excluding heap memory owned by values).
+    auto memory_usage() const -> Size {
+        return root ? footprint(root.get()) : 0;
+    }
+
+    /// Removes all entries.
+    auto clear() -> void {
+        root.reset();
+        length = 0;
+    }
+
+    /// Returns if the map is empty.
+    [[nodiscard]]
+    auto is_empty() const -> bool {
+        return length == 0;
+    }
+
+    /// Returns the number of entries.
+    auto size() const -> Size {
+        return length;
+    }
+
+    /// Send the entries as a string of `key: value` pairs to std::ostream.
+    friend auto operator<<(std::ostream& os, const ArtMap<V>& map) -> std::ostream& {
+        os << "{";
+        bool first = true;
+        map.for_each([&os, &first](std::string_view key, const V& val) {
+            os << (first ? "" : ", ") << key << ": " << val;
+            first = false;
+        });
+        os << "}";
+        return os;
+    }
+};
+
+#endif //TOOLS_ART_MAP_H
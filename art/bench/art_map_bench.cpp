@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "../art_map.h"
+#include "../../bench/bench.h"
+
+// Point lookups, range scans and memory of ArtMap against std::map and std::unordered_map, for a million random
+// integer keys and a million URL-like string keys.
+
+constexpr bench::Size key_count = 1'000'000;
+constexpr bench::Size lookups = 1'000'000;
+constexpr bench::Size scans = 10'000;
+constexpr bench::Size scan_length = 100;
+
+// Every heap allocation in the process is counted, so the maps' memory includes their nodes and key strings. The
+// replacements are kept out of line, where they cost every container the same.
+static std::size_t live_bytes = 0;
+
+[[gnu::noinline]] auto operator new(std::size_t bytes) -> void* {
+    auto* block = static_cast<std::max_align_t*>(std::malloc(bytes + sizeof(std::max_align_t)));
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<std::size_t*>(block) = bytes;
+    live_bytes += bytes;
+    return block + 1;
+}
+
+[[gnu::noinline]] auto operator delete(void* ptr) noexcept -> void {
+    if (ptr != nullptr) {
+        auto* block = static_cast<std::max_align_t*>(ptr) - 1;
+        live_bytes -= *reinterpret_cast<std::size_t*>(block);
+        std::free(block);
+    }
+}
+
+auto operator delete(void* ptr, std::size_t) noexcept -> void {
+    operator delete(ptr);
+}
+
+template <class Build>
+auto measure(Build build) {
+    std::size_t before = live_bytes;
+    auto map = build();
+    return std::pair(std::move(map), live_bytes - before);
+}
+
+auto run(const char* name, const Vec<std::string>& keys) -> void {
+    auto rng = std::mt19937_64(7);
+    auto probes = Vec<std::string>();
+    for (bench::Size i = 0; i < lookups; i++) {
+        probes.push_back(keys.raw_ptr_begin()[rng() % keys.size()]);
+    }
+    auto [art, art_bytes] = measure([&] {
+        auto map = ArtMap<std::uint64_t>();
+        for (bench::Size i = 0; i < keys.size(); i++) {
+            map.insert(keys.raw_ptr_begin()[i], i);
+        }
+        return map;
+    });
+    auto [ordered, ordered_bytes] = measure([&] {
+        auto map = std::map<std::string, std::uint64_t>();
+        for (bench::Size i = 0; i < keys.size(); i++) {
+            map.emplace(keys.raw_ptr_begin()[i], i);
+        }
+        return map;
+    });
+    auto [hashed, hashed_bytes] = measure([&] {
+        auto map = std::unordered_map<std::string, std::uint64_t>();
+        for (bench::Size i = 0; i < keys.size(); i++) {
+            map.emplace(keys.raw_ptr_begin()[i], i);
+        }
+        return map;
+    });
+
+    std::uint64_t sum = 0;
+    double art_find = bench::seconds([&] {
+        for (const std::string& key : probes) {
+            sum += *art.find(key);
+        }
+    });
+    double ordered_find = bench::seconds([&] {
+        for (const std::string& key : probes) {
+            sum += ordered.find(key)->second;
+        }
+    });
+    double hashed_find = bench::seconds([&] {
+        for (const std::string& key : probes) {
+            sum += hashed.find(key)->second;
+        }
+    });
+
+    // Each scan visits the `scan_length` keys from a random existing key on.
+    auto sorted = Vec<std::string>::from(keys);
+    std::sort(sorted.begin(), sorted.end());
+    double art_scan = bench::seconds([&] {
+        for (bench::Size i = 0; i < scans; i++) {
+            bench::Size first = probes.size() * i / scans % (sorted.size() - scan_length);
+            art.for_each_range(sorted.raw_ptr_begin()[first], sorted.raw_ptr_begin()[first + scan_length],
+                               [&](std::string_view, std::uint64_t val) { sum += val; });
+        }
+    });
+    double ordered_scan = bench::seconds([&] {
+        for (bench::Size i = 0; i < scans; i++) {
+            bench::Size first = probes.size() * i / scans % (sorted.size() - scan_length);
+            auto it = ordered.lower_bound(sorted.raw_ptr_begin()[first]);
+            for (bench::Size j = 0; j < scan_length; j++, ++it) {
+                sum += it->second;
+            }
+        }
+    });
+    bench::keep(sum);
+
+    auto ns = [](double time, bench::Size n) {
+        return time / static_cast<double>(n) * 1e9;
+    };
+    auto mib = [](std::size_t bytes) {
+        return static_cast<double>(bytes) / (1 << 20);
+    };
+    std::cout << name << " keys: lookup " << ns(art_find, lookups) << " ns ArtMap, " << ns(ordered_find, lookups)
+              << " ns std::map, " << ns(hashed_find, lookups) << " ns std::unordered_map; " << scan_length
+              << "-key scan " << ns(art_scan, scans) / 1e3 << " us ArtMap, " << ns(ordered_scan, scans) / 1e3
+              << " us std::map; memory " << mib(art_bytes) << " MiB ArtMap, " << mib(ordered_bytes)
+              << " MiB std::map, " << mib(hashed_bytes) << " MiB std::unordered_map\n";
+}
+
+auto main() -> int {
+    std::cout << std::fixed << std::setprecision(1);
+    auto rng = std::mt19937_64(42);
+    auto integers = Vec<std::string>();
+    auto urls = Vec<std::string>();
+    const char* hosts[] = { "https://example.com/", "https://docs.example.org/", "http://mirror.example.net/" };
+    const char* sections[] = { "users/", "posts/", "api/v2/items/", "static/img/" };
+    for (bench::Size i = 0; i < key_count; i++) {
+        integers.push_back(art::encode(static_cast<std::uint64_t>(rng())));
+        urls.push_back(std::string(hosts[rng() % 3]) + sections[rng() % 4] + std::to_string(rng() % 100'000'000));
+    }
+    run("integer", integers);
+    run("URL", urls);
+    return 0;
+}
@@ -0,0 +1,36 @@
+#include <iostream>
+
+#include "../art_map.h"
+
+auto test() -> int {
+    auto map = ArtMap<int>();
+    map.insert("romane", 1);
+    map.insert("romanus", 2);
+    map.insert("romulus", 3);
+    map.insert("rubens", 4);
+    map.insert("ruber", 5);
+    map.insert("rom", 6);
+    map.remove("romulus");
+    // {rom: 6, romane: 1, romanus: 2, rubens: 4, ruber: 5}
+    std::cout << map << '\n';
+    // romane romanus
+    map.for_each_prefix("roman", [](std::string_view key, int) { std::cout << key << ' '; });
+    std::cout << '\n';
+    if (map.size() != 5 || map.contains("romulus") || map.at("rom") != 6) {
+        return 1;
+    }
+
+    auto ids = Vec<std::pair<std::string, int>>();
+    for (std::int64_t i = -2; i < 1000; i++) {
+        ids.push_back({ art::encode(i), static_cast<int>(i) });
+    }
+    auto loaded = ArtMap<int>::from_sorted(ids);
+    int sum = 0;
+    loaded.for_each_range(art::encode(std::int64_t(-1)), art::encode(std::int64_t(3)),
+                          [&sum](std::string_view, int val) { sum += val; });
+    return sum == 2 && loaded.size() == 1002 ? 0 : 1;
+}
+
+auto main() -> int {
+    return test();
+}
@@ -0,0 +1,67 @@
+#ifndef TOOLS_BENCH_H
+#define TOOLS_BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <random>
+
+#include "../vec/vec.h"
+
+/// Helpers shared by the benchmark executables under `<module>/bench/`.
+namespace bench {
+    using Size = std::size_t;
+
+    /// Runs `fn` `repeats` times and returns the fastest run in seconds, the one least disturbed by the rest of the
+    /// machine.
+    template <class Fn>
+    auto seconds(Fn fn, Size repeats = 3) -> double {
+        double best = 0;
+        for (Size i = 0; i < repeats; i++) {
+            auto start = std::chrono::steady_clock::now();
+            fn();
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = i == 0 ? elapsed.count() : std::min(best, elapsed.count());
+        }
+        return best;
+    }
+
+    /// Keeps the compiler from discarding the computation that produced `val`.
+    template <class T>
+    auto keep(const T& val) -> void {
+#if defined(__GNUC__)
+        asm volatile("" : : "r"(&val) : "memory");
+#else
+        static const volatile void* sink;
+        sink = &val;
+#endif
+    }
+
+    /// Draws ranks in [0, `n`) with probability proportional to `1 / (rank + 1)^s`. This Zipfian distribution models
+    /// key popularity in caches, term frequencies in text and vertex degrees in power-law graphs.
+    class Zipf {
+    private:
+        Vec<double> cdf;
+    public:
+        Zipf(Size n, double s) : cdf(Vec<double>::of(n)) {
+            double total = 0;
+            for (Size rank = 0; rank < n; rank++) {
+                total += 1 / std::pow(static_cast<double>(rank + 1), s);
+                cdf.raw_ptr_begin()[rank] = total;
+            }
+            for (double& p : cdf) {
+                p /= total;
+            }
+        }
+
+        template <class Rng>
+        auto operator()(Rng& rng) const -> Size {
+            double u = std::uniform_real_distribution<double>(0, 1)(rng);
+            auto it = std::lower_bound(cdf.begin(), cdf.end(), u);
+            return std::min(static_cast<Size>(it - cdf.begin()), cdf.size() - 1);
+        }
+    };
+}
+
+#endif //TOOLS_BENCH_H
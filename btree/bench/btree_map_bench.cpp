@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <utility>
+
+#include "../btree_map.h"
+#include "../../bench/bench.h"
+
+// Random inserts, point lookups and range scans of BTreeMap against std::map and a sorted Vec kept in order with
+// insert, for 10K to 10M integer keys; and bulk loading from a sorted Vec.
+
+constexpr bench::Size lookups = 1'000'000;
+constexpr bench::Size scans = 10'000;
+constexpr bench::Size scan_length = 100;
+/// Inserting into a sorted Vec moves half of it on average, so it is only measured up to this many keys.
+constexpr bench::Size max_sorted_vec = 100'000;
+
+using Entry = std::pair<std::uint64_t, std::uint64_t>;
+
+auto main() -> int {
+    std::cout << std::fixed << std::setprecision(1);
+    for (bench::Size n : { 10'000, 100'000, 1'000'000, 10'000'000 }) {
+        auto rng = std::mt19937_64(n);
+        auto keys = Vec<std::uint64_t>();
+        keys.request_cap(n);
+        for (bench::Size i = 0; i < n; i++) {
+            keys.push_back(rng());
+        }
+        auto probes = Vec<std::uint64_t>();
+        for (bench::Size i = 0; i < lookups; i++) {
+            probes.push_back(keys.raw_ptr_begin()[rng() % n]);
+        }
+        auto ns = [](double time, bench::Size count) {
+            return time / static_cast<double>(count) * 1e9;
+        };
+
+        auto tree = BTreeMap<std::uint64_t, std::uint64_t>();
+        double tree_insert = bench::seconds([&] {
+            tree = BTreeMap<std::uint64_t, std::uint64_t>();
+            for (bench::Size i = 0; i < n; i++) {
+                tree.insert(keys.raw_ptr_begin()[i], i);
+            }
+        }, 1);
+        auto ordered = std::map<std::uint64_t, std::uint64_t>();
+        double map_insert = bench::seconds([&] {
+            ordered.clear();
+            for (bench::Size i = 0; i < n; i++) {
+                ordered.emplace(keys.raw_ptr_begin()[i], i);
+            }
+        }, 1);
+        bool sorted_vec = n <= max_sorted_vec;
+        auto sorted = Vec<Entry>();
+        double vec_insert = !sorted_vec ? 0 : bench::seconds([&] {
+            sorted.clear();
+            for (bench::Size i = 0; i < n; i++) {
+                auto entry = Entry { keys.raw_ptr_begin()[i], i };
+                auto at = std::lower_bound(sorted.begin(), sorted.end(), entry);
+                if (at == sorted.end() || at->first != entry.first) {
+                    sorted.insert(at, entry);
+                }
+            }
+        }, 1);
+        if (!sorted_vec) {
+            for (bench::Size i = 0; i < n; i++) {
+                sorted.push_back(Entry { keys.raw_ptr_begin()[i], i });
+            }
+            std::sort(sorted.begin(), sorted.end());
+        }
+
+        std::uint64_t sum = 0;
+        double tree_find = bench::seconds([&] {
+            for (std::uint64_t key : probes) {
+                sum += *tree.find(key);
+            }
+        });
+        double map_find = bench::seconds([&] {
+            for (std::uint64_t key : probes) {
+                sum += ordered.find(key)->second;
+            }
+        });
+        double vec_find = bench::seconds([&] {
+            for (std::uint64_t key : probes) {
+                sum += std::lower_bound(sorted.begin(), sorted.end(), Entry { key, 0 })->second;
+            }
+        });
+
+        // Each scan visits the `scan_length` entries from a random existing key on.
+        auto starts = Vec<bench::Size>();
+        for (bench::Size i = 0; i < scans; i++) {
+            starts.push_back(rng() % (n - scan_length));
+        }
+        double tree_scan = bench::seconds([&] {
+            for (bench::Size first : starts) {
+                auto it = tree.lower_bound(sorted.raw_ptr_begin()[first].first);
+                for (bench::Size j = 0; j < scan_length; j++, ++it) {
+                    sum += it.value();
+                }
+            }
+        });
+        double map_scan = bench::seconds([&] {
+            for (bench::Size first : starts) {
+                auto it = ordered.lower_bound(sorted.raw_ptr_begin()[first].first);
+                for (bench::Size j = 0; j < scan_length; j++, ++it) {
+                    sum += it->second;
+                }
+            }
+        });
+        double vec_scan = bench::seconds([&] {
+            for (bench::Size first : starts) {
+                auto it = std::lower_bound(sorted.begin(), sorted.end(), sorted.raw_ptr_begin()[first]);
+                for (bench::Size j = 0; j < scan_length; j++, ++it) {
+                    sum += it->second;
+                }
+            }
+        });
+        double bulk = bench::seconds([&] { tree = BTreeMap<std::uint64_t, std::uint64_t>::from_sorted(sorted); }, 1);
+        bench::keep(sum);
+
+        std::cout << n << " keys: insert " << ns(tree_insert, n) << " ns BTreeMap, " << ns(map_insert, n)
+                  << " ns std::map, ";
+        if (sorted_vec) {
+            std::cout << ns(vec_insert, n) << " ns sorted Vec";
+        } else {
+            std::cout << "sorted Vec skipped";
+        }
+        std::cout << "; lookup " << ns(tree_find, lookups) << " ns BTreeMap, " << ns(map_find, lookups)
+                  << " ns std::map, " << ns(vec_find, lookups) << " ns sorted Vec; " << scan_length << "-entry scan "
+                  << ns(tree_scan, scans) << " ns BTreeMap, " << ns(map_scan, scans) << " ns std::map, "
+                  << ns(vec_scan, scans) << " ns sorted Vec; from_sorted " << ns(bulk, n) << " ns per entry\n";
+    }
+    return 0;
+}
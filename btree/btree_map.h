@@ -0,0 +1,497 @@
+#ifndef TOOLS_BTREE_MAP_H
+#define TOOLS_BTREE_MAP_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+#include "../vec/vec.h"
+
+/// `BTreeMap` is an ordered map implemented as a B+tree. Keys are kept in wide nodes (a few cache lines of keys per
+/// node) so a lookup touches few nodes, and every node lives in one of two `Vec` pools, so nodes are referred to by
+/// index and allocated without calling the global allocator for each one.
+/// @note `K` and `V` must be default constructible, and `K` must be ordered by `operator<`.
+template <class K, class V>
+class BTreeMap {
+public:
+    using Size = typename Vec<K>::Size;
+private:
+    using NodeId = std::uint32_t;
+
+    static constexpr NodeId no_node = std::numeric_limits<NodeId>::max();
+    /// The number of bytes of keys held by a node; keys are searched linearly, so this is kept to a few cache lines.
+    static constexpr std::size_t key_bytes = 256;
+    static constexpr std::uint32_t capacity = std::max<std::size_t>(8, key_bytes / sizeof(K));
+
+    struct Leaf {
+        std::uint32_t count = 0;
+        NodeId next = no_node;
+        std::array<K, capacity> keys;
+        std::array<V, capacity> values;
+    };
+
+    /// An inner node with `count` separator keys and `count + 1` children. Child `i` holds the keys in
+    /// [keys[i - 1], keys[i]).
+    struct Inner {
+        std::uint32_t count = 0;
+        std::array<K, capacity> keys;
+        std::array<NodeId, capacity + 1> children;
+    };
+
+    struct Split {
+        K key;
+        NodeId right;
+    };
+
+    Vec<Leaf> leaves;
+    Vec<Inner> inners;
+    NodeId root = no_node;
+    /// The number of inner levels above the leaves.
+    std::uint32_t height = 0;
+    Size length = 0;
+
+    auto leaf(NodeId id) -> Leaf& {
+        return leaves.raw_ptr_begin()[id];
+    }
+
+    auto leaf(NodeId id) const -> const Leaf& {
+        return leaves.raw_ptr_begin()[id];
+    }
+
+    auto inner(NodeId id) -> Inner& {
+        return inners.raw_ptr_begin()[id];
+    }
+
+    auto inner(NodeId id) const -> const Inner& {
+        return inners.raw_ptr_begin()[id];
+    }
+
+    /// Returns the number of keys in `keys[0, count)` that are less than `key` (or not greater, if `inclusive`).
+    /// Arithmetic keys are counted without branches, a loop the compiler vectorizes.
+    template <bool inclusive>
+    static auto rank(const K* keys, std::uint32_t count, const K& key) -> std::uint32_t {
+        if constexpr (std::is_arithmetic_v<K>) {
+            std::uint32_t result = 0;
+            for (std::uint32_t i = 0; i < count; i++) {
+                result += inclusive ? !(key < keys[i]) : keys[i] < key;
+            }
+            return result;
+        } else if constexpr (inclusive) {
+            return static_cast<std::uint32_t>(std::upper_bound(keys, keys + count, key) - keys);
+        } else {
+            return static_cast<std::uint32_t>(std::lower_bound(keys, keys + count, key) - keys);
+        }
+    }
+
+    auto new_leaf() -> NodeId {
+        leaves.push_back(Leaf());
+        return static_cast<NodeId>(leaves.size() - 1);
+    }
+
+    auto new_inner() -> NodeId {
+        inners.push_back(Inner());
+        return static_cast<NodeId>(inners.size() - 1);
+    }
+
+    /// Descends from the root to the leaf that would hold `key`.
+    auto find_leaf(const K& key) const -> NodeId {
+        NodeId node = root;
+        for (std::uint32_t level = height; level > 0; level--) {
+            const Inner& in = inner(node);
+            node = in.children[rank<true>(in.keys.data(), in.count, key)];
+        }
+        return node;
+    }
+
+    auto insert_leaf(NodeId id, const K& key, const V& val, bool assign, bool& inserted) -> std::optional<Split> {
+        Leaf* node = &leaf(id);
+        std::uint32_t pos = rank<false>(node->keys.data(), node->count, key);
+        if (pos < node->count && !(key < node->keys[pos])) {
+            if (assign) {
+                node->values[pos] = val;
+            }
+            inserted = false;
+            return std::nullopt;
+        }
+        inserted = true;
+        if (node->count < capacity) {
+            std::move_backward(node->keys.begin() + pos, node->keys.begin() + node->count,
+                               node->keys.begin() + node->count + 1);
+            std::move_backward(node->values.begin() + pos, node->values.begin() + node->count,
+                               node->values.begin() + node->count + 1);
+            node->keys[pos] = key;
+            node->values[pos] = val;
+            node->count++;
+            return std::nullopt;
+        }
+        NodeId right_id = new_leaf();
+        node = &leaf(id);
+        Leaf& right = leaf(right_id);
+        std::uint32_t half = capacity / 2;
+        right.count = capacity - half;
+        std::move(node->keys.begin() + half, node->keys.end(), right.keys.begin());
+        std::move(node->values.begin() + half, node->values.end(), right.values.begin());
+        node->count = half;
+        right.next = node->next;
+        node->next = right_id;
+        Leaf& target = pos <= half ? *node : right;
+        std::uint32_t at = pos <= half ? pos : pos - half;
+        std::move_backward(target.keys.begin() + at, target.keys.begin() + target.count,
+                           target.keys.begin() + target.count + 1);
+        std::move_backward(target.values.begin() + at, target.values.begin() + target.count,
+                           target.values.begin() + target.count + 1);
+        target.keys[at] = key;
+        target.values[at] = val;
+        target.count++;
+        return Split { right.keys[0], right_id };
+    }
+
+    auto insert_into(NodeId id, std::uint32_t level, const K& key, const V& val, bool assign, bool& inserted)
+        -> std::optional<Split> {
+        if (level == 0) {
+            return insert_leaf(id, key, val, assign, inserted);
+        }
+        std::uint32_t child = rank<true>(inner(id).keys.data(), inner(id).count, key);
+        auto split = insert_into(inner(id).children[child], level - 1, key, val, assign, inserted);
+        if (!split) {
+            return std::nullopt;
+        }
+        Inner* node = &inner(id);
+        if (node->count < capacity) {
+            std::move_backward(node->keys.begin() + child, node->keys.begin() + node->count,
+                               node->keys.begin() + node->count + 1);
+            std::move_backward(node->children.begin() + child + 1, node->children.begin() + node->count + 1,
+                               node->children.begin() + node->count + 2);
+            node->keys[child] = split->key;
+            node->children[child + 1] = split->right;
+            node->count++;
+            return std::nullopt;
+        }
+        // Lay out the overfull node in scratch arrays, then promote its middle key.
+        std::array<K, capacity + 1> keys;
+        std::array<NodeId, capacity + 2> children;
+        std::move(node->keys.begin(), node->keys.begin() + child, keys.begin());
+        keys[child] = split->key;
+        std::move(node->keys.begin() + child, node->keys.end(), keys.begin() + child + 1);
+        std::copy(node->children.begin(), node->children.begin() + child + 1, children.begin());
+        children[child + 1] = split->right;
+        std::copy(node->children.begin() + child + 1, node->children.end(), children.begin() + child + 2);
+        NodeId right_id = new_inner();
+        node = &inner(id);
+        Inner& right = inner(right_id);
+        std::uint32_t mid = (capacity + 1) / 2;
+        node->count = mid;
+        std::move(keys.begin(), keys.begin() + mid, node->keys.begin());
+        std::copy(children.begin(), children.begin() + mid + 1, node->children.begin());
+        right.count = capacity - mid;
+        std::move(keys.begin() + mid + 1, keys.end(), right.keys.begin());
+        std::copy(children.begin() + mid + 1, children.end(), right.children.begin());
+        return Split { std::move(keys[mid]), right_id };
+    }
+
+    auto insert_impl(const K& key, const V& val, bool assign) -> bool {
+        if (root == no_node) {
+            root = new_leaf();
+        }
+        bool inserted = false;
+        auto split = insert_into(root, height, key, val, assign, inserted);
+        if (split) {
+            NodeId top = new_inner();
+            Inner& node = inner(top);
+            node.count = 1;
+            node.keys[0] = split->key;
+            node.children[0] = root;
+            node.children[1] = split->right;
+            root = top;
+            height++;
+        }
+        length += inserted;
+        return inserted;
+    }
+public:
+    /// A forward iterator over the entries of the map, in key order. Dereferencing yields a pair of references to
+    /// the key and the value.
+    class ConstIterator {
+        friend class BTreeMap;
+
+        const BTreeMap* map = nullptr;
+        NodeId node = no_node;
+        std::uint32_t pos = 0;
+
+        ConstIterator(const BTreeMap* owner, NodeId id, std::uint32_t at) : map(owner), node(id), pos(at) {
+            skip_exhausted();
+        }
+
+        /// Moves past leaves that have no entry left at or after `pos`.
+        auto skip_exhausted() -> void {
+            while (node != no_node && pos >= map->leaf(node).count) {
+                node = map->leaf(node).next;
+                pos = 0;
+            }
+        }
+    public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = std::pair<const K&, const V&>;
+        using iterator_category = std::forward_iterator_tag;
+
+        ConstIterator() = default;
+
+        auto key() const -> const K& {
+            return map->leaf(node).keys[pos];
+        }
+
+        auto value() const -> const V& {
+            return map->leaf(node).values[pos];
+        }
+
+        auto operator*() const -> value_type {
+            return value_type(key(), value());
+        }
+
+        auto operator++() -> ConstIterator& {
+            pos++;
+            skip_exhausted();
+            return *this;
+        }
+
+        auto operator++(int) -> ConstIterator {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        auto operator==(const ConstIterator& other) const -> bool {
+            return node == other.node && (node == no_node || pos == other.pos);
+        }
+    };
+
+    /// A pair of iterators delimiting a sub-range of the map, usable in a range-based for loop.
+    struct Range {
+        ConstIterator first;
+        ConstIterator last;
+
+        auto begin() const -> ConstIterator {
+            return first;
+        }
+
+        auto end() const -> ConstIterator {
+            return last;
+        }
+    };
+
+    /// Constructs an empty map.
+    BTreeMap() = default;
+
+    /// Constructs a map from `entries`. If the entries are sorted by strictly increasing key, the tree is built
+    /// bottom-up in linear time with full nodes; otherwise each entry is inserted in turn (later duplicates are
+    /// ignored).
+    static auto from_sorted(const Vec<std::pair<K, V>>& entries) -> BTreeMap<K, V> {
+        auto result = BTreeMap<K, V>();
+        const std::pair<K, V>* data = entries.raw_ptr_begin();
+        Size n = entries.size();
+        bool strictly_sorted = std::adjacent_find(data, data + n, [](const auto& a, const auto& b) {
+            return !(a.first < b.first);
+        }) == data + n;
+        if (!strictly_sorted) {
+            for (Size i = 0; i < n; i++) {
+                result.insert(data[i].first, data[i].second);
+            }
+            return result;
+        }
+        if (n == 0) {
+            return result;
+        }
+        // Spread the entries evenly over the fewest leaves that can hold them.
+        Size leaf_count = (n + capacity - 1) / capacity;
+        result.leaves.request_cap(leaf_count);
+        auto level = Vec<NodeId>();
+        auto mins = Vec<K>();
+        level.request_cap(leaf_count);
+        mins.request_cap(leaf_count);
+        Size at = 0;
+        for (Size i = 0; i < leaf_count; i++) {
+            NodeId id = result.new_leaf();
+            Leaf& node = result.leaf(id);
+            node.count = static_cast<std::uint32_t>(n / leaf_count + (i < n % leaf_count));
+            for (std::uint32_t j = 0; j < node.count; j++, at++) {
+                node.keys[j] = data[at].first;
+                node.values[j] = data[at].second;
+            }
+            node.next = i + 1 < leaf_count ? id + 1 : no_node;
+            level.push_back(id);
+            mins.push_back(node.keys[0]);
+        }
+        // Group each level under inner nodes until a single root remains.
+        while (level.size() > 1) {
+            Size parent_count = (level.size() + capacity) / (capacity + 1);
+            auto parents = Vec<NodeId>();
+            auto parent_mins = Vec<K>();
+            Size child = 0;
+            for (Size i = 0; i < parent_count; i++) {
+                NodeId id = result.new_inner();
+                Inner& node = result.inner(id);
+                auto fanout = static_cast<std::uint32_t>(
+                    level.size() / parent_count + (i < level.size() % parent_count));
+                node.count = fanout - 1;
+                parents.push_back(id);
+                parent_mins.push_back(mins.raw_ptr_begin()[child]);
+                for (std::uint32_t j = 0; j < fanout; j++, child++) {
+                    node.children[j] = level.raw_ptr_begin()[child];
+                    if (j > 0) {
+                        node.keys[j - 1] = mins.raw_ptr_begin()[child];
+                    }
+                }
+            }
+            level = std::move(parents);
+            mins = std::move(parent_mins);
+            result.height++;
+        }
+        result.root = level[0];
+        result.length = n;
+        return result;
+    }
+
+    /// Inserts `key` mapped to a copy of `val` if `key` is not present. Returns `true` if an insertion took place.
+    auto insert(const K& key, const V& val) -> bool {
+        return insert_impl(key, val, false);
+    }
+
+    /// Maps `key` to a copy of `val`, replacing any existing value. Returns `true` if `key` was not present.
+    auto insert_or_assign(const K& key, const V& val) -> bool {
+        return insert_impl(key, val, true);
+    }
+
+    /// Removes `key` and returns its value, or `std::nullopt` if `key` is not present. Nodes are not merged when
+    /// they become underfull; later insertions into the same key range refill them.
+    auto remove(const K& key) -> std::optional<V> {
+        if (root == no_node) {
+            return std::nullopt;
+        }
+        Leaf& node = leaf(find_leaf(key));
+        std::uint32_t pos = rank<false>(node.keys.data(), node.count, key);
+        if (pos == node.count || key < node.keys[pos]) {
+            return std::nullopt;
+        }
+        std::optional<V> result(std::move(node.values[pos]));
+        std::move(node.keys.begin() + pos + 1, node.keys.begin() + node.count, node.keys.begin() + pos);
+        std::move(node.values.begin() + pos + 1, node.values.begin() + node.count, node.values.begin() + pos);
+        node.count--;
+        length--;
+        return result;
+    }
+
+    /// Returns a pointer to the value mapped to `key`, or `nullptr` if `key` is not present.
+    auto find(const K& key) -> V* {
+        return const_cast<V*>(std::as_const(*this).find(key));
+    }
+
+    /// Returns a pointer to the value mapped to `key`, or `nullptr` if `key` is not present.
+    auto find(const K& key) const -> const V* {
+        if (root == no_node) {
+            return nullptr;
+        }
+        const Leaf& node = leaf(find_leaf(key));
+        std::uint32_t pos = rank<false>(node.keys.data(), node.count, key);
+        return pos < node.count && !(key < node.keys[pos]) ? &node.values[pos] : nullptr;
+    }
+
+    /// Returns if `key` is present.
+    auto contains(const K& key) const -> bool {
+        return find(key) != nullptr;
+    }
+
+    /// Returns a reference to the value mapped to `key`.
+    /// @throws NoSuchElement if `key` is not present.
+    auto at(const K& key) -> V& {
+        V* val = find(key);
+        if (val == nullptr) {
+            throw error::NoSuchElement("key not found in map.");
+        }
+        return *val;
+    }
+
+    /// Returns a reference to the value mapped to `key`.
+    /// @throws NoSuchElement if `key` is not present.
+    auto at(const K& key) const -> const V& {
+        const V* val = find(key);
+        if (val == nullptr) {
+            throw error::NoSuchElement("key not found in map.");
+        }
+        return *val;
+    }
+
+    /// Returns a `ConstIterator` to the first entry whose key is not less than `key`.
+    auto lower_bound(const K& key) const -> ConstIterator {
+        if (root == no_node) {
+            return end();
+        }
+        NodeId id = find_leaf(key);
+        const Leaf& node = leaf(id);
+        return ConstIterator(this, id, rank<false>(node.keys.data(), node.count, key));
+    }
+
+    /// Returns the entries whose keys lie in [`low`, `high`), in key order.
+    auto range(const K& low, const K& high) const -> Range {
+        if (high < low) {
+            return Range { end(), end() };
+        }
+        return Range { lower_bound(low), lower_bound(high) };
+    }
+
+    /// Removes all entries. The node pools keep their capacity.
+    auto clear() -> void {
+        leaves.clear();
+        inners.clear();
+        root = no_node;
+        height = 0;
+        length = 0;
+    }
+
+    /// Returns if the map is empty.
+    [[nodiscard]]
+    auto is_empty() const -> bool {
+        return length == 0;
+    }
+
+    /// Returns the number of entries.
+    auto size() const -> Size {
+        return length;
+    }
+
+    /// Returns a `ConstIterator` pointing to the entry with the smallest key.
+    auto begin() const -> ConstIterator {
+        if (root == no_node) {
+            return end();
+        }
+        NodeId node = root;
+        for (std::uint32_t level = height; level > 0; level--) {
+            node = inner(node).children[0];
+        }
+        return ConstIterator(this, node, 0);
+    }
+
+    /// Returns a `ConstIterator` referring to the past-the-end entry.
+    auto end() const -> ConstIterator {
+        return ConstIterator(this, no_node, 0);
+    }
+
+    /// Send the entries as a string of `key: value` pairs to std::ostream.
+    friend auto operator<<(std::ostream& os, const BTreeMap<K, V>& map) -> std::ostream& {
+        os << "{";
+        for (auto iter = map.begin(); iter != map.end();) {
+            os << iter.key() << ": " << iter.value();
+            if (++iter != map.end()) {
+                os << ", ";
+            }
+        }
+        os << "}";
+        return os;
+    }
+};
+
+#endif //TOOLS_BTREE_MAP_H
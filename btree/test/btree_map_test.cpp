@@ -0,0 +1,34 @@
+#include <iostream>
+
+#include "../btree_map.h"
+
+auto test() -> int {
+    auto map = BTreeMap<int, int>();
+    for (int i = 0; i < 1000; i++) {
+        map.insert((i * 7919) % 1000, i);
+    }
+    map.remove(500);
+    if (map.size() != 999 || map.contains(500) || map.at(7919 % 1000) != 1) {
+        return 1;
+    }
+    // {10: 790, 11: 469, 12: 148}
+    std::cout << "{";
+    for (auto [key, val] : map.range(10, 13)) {
+        std::cout << key << ": " << val << (key != 12 ? ", " : "");
+    }
+    std::cout << "}\n";
+
+    auto entries = Vec<std::pair<int, int>>();
+    for (int i = 0; i < 5; i++) {
+        entries.push_back({ i * 10, i });
+    }
+    auto loaded = BTreeMap<int, int>::from_sorted(entries);
+    loaded.insert(15, 100);
+    // {0: 0, 10: 1, 15: 100, 20: 2, 30: 3, 40: 4}
+    std::cout << loaded << '\n';
+    return loaded.size() == 6 ? 0 : 1;
+}
+
+auto main() -> int {
+    return test();
+}
@@ -0,0 +1,115 @@
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <optional>
+#include <random>
+#include <unordered_map>
+
+#include "../lru_cache.h"
+#include "../../bench/bench.h"
+#include "../../parallel/parallel.h"
+
+// Hit rate and throughput of LruCache on Zipfian key traces: a read-through cache that puts every missed key.
+
+constexpr bench::Size keys = 1'000'000;
+constexpr bench::Size requests = 4'000'000;
+
+/// The `std::unordered_map` + `std::list` LRU cache that `LruCache` replaces.
+class ListLru {
+private:
+    std::size_t capacity;
+    std::list<std::pair<std::uint64_t, std::uint64_t>> order;
+    std::unordered_map<std::uint64_t, decltype(order)::iterator> index;
+public:
+    explicit ListLru(std::size_t capacity) : capacity(capacity) {}
+
+    auto get(std::uint64_t key) -> std::optional<std::uint64_t> {
+        auto it = index.find(key);
+        if (it == index.end()) {
+            return std::nullopt;
+        }
+        order.splice(order.begin(), order, it->second);
+        return it->second->second;
+    }
+
+    auto put(std::uint64_t key, std::uint64_t val) -> void {
+        if (order.size() == capacity) {
+            index.erase(order.back().first);
+            order.pop_back();
+        }
+        order.emplace_front(key, val);
+        index[key] = order.begin();
+    }
+};
+
+template <class Cache>
+auto replay(Cache& cache, const Vec<std::uint64_t>& trace) -> std::uint64_t {
+    std::uint64_t hits = 0;
+    for (std::uint64_t key : trace) {
+        if (cache.get(key)) {
+            hits++;
+        } else {
+            cache.put(key, key);
+        }
+    }
+    return hits;
+}
+
+auto main() -> int {
+    std::cout << std::fixed << std::setprecision(3);
+    for (double skew : { 0.8, 0.99, 1.2 }) {
+        auto zipf = bench::Zipf(keys, skew);
+        auto rng = std::mt19937_64(skew * 100);
+        auto trace = Vec<std::uint64_t>();
+        trace.request_cap(requests);
+        for (bench::Size i = 0; i < requests; i++) {
+            // Scramble ranks so that popular keys do not hash to neighbouring buckets.
+            trace.push_back(zipf(rng) * 0x9E3779B97F4A7C15ull);
+        }
+        for (bench::Size capacity : { keys / 1000, keys / 100, keys / 10 }) {
+            std::uint64_t lru_hits = 0;
+            std::uint64_t lfu_hits = 0;
+            std::uint64_t list_hits = 0;
+            double lru_time = bench::seconds([&] {
+                auto cache = LruCache<std::uint64_t, std::uint64_t>(capacity);
+                lru_hits = replay(cache, trace);
+            });
+            double lfu_time = bench::seconds([&] {
+                auto cache = LruCache<std::uint64_t, std::uint64_t, cache::TinyLfu<std::uint64_t>>(capacity);
+                lfu_hits = replay(cache, trace);
+            });
+            double list_time = bench::seconds([&] {
+                auto cache = ListLru(capacity);
+                list_hits = replay(cache, trace);
+            });
+            auto rate = [](std::uint64_t hits) {
+                return static_cast<double>(hits) / static_cast<double>(requests);
+            };
+            auto mops = [](double time) {
+                return static_cast<double>(requests) / time / 1e6;
+            };
+            std::cout << "zipf " << skew << ", capacity " << capacity << ": hit rate LRU " << rate(lru_hits)
+                      << ", TinyLFU " << rate(lfu_hits) << ", list LRU " << rate(list_hits) << "; Mops/s LRU "
+                      << mops(lru_time) << ", TinyLFU " << mops(lfu_time) << ", list LRU " << mops(list_time) << '\n';
+        }
+
+        // The sharded cache under every hardware thread, each replaying its own slice of the trace.
+        bench::Size threads = parallel::hardware_threads();
+        auto shared = ConcurrentLruCache<std::uint64_t, std::uint64_t, cache::TinyLfu<std::uint64_t>>(keys / 100, 64);
+        double shared_time = bench::seconds([&] {
+            parallel::for_ranges(requests, threads, 4096, [&](bench::Size, bench::Size first, bench::Size last) {
+                for (bench::Size i = first; i < last; i++) {
+                    std::uint64_t key = trace.raw_ptr_begin()[i];
+                    if (!shared.get(key)) {
+                        shared.put(key, key);
+                    }
+                }
+            });
+        }, 1);
+        std::cout << "zipf " << skew << ", sharded TinyLFU on " << threads << " thread(s): hit rate "
+                  << shared.stats().hit_rate() << ", " << static_cast<double>(requests) / shared_time / 1e6
+                  << " Mops/s\n";
+    }
+    return 0;
+}
@@ -0,0 +1,407 @@
+#ifndef TOOLS_LRU_CACHE_H
+#define TOOLS_LRU_CACHE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include "../vec/vec.h"
+
+namespace cache {
+    /// Admission policy that admits every new key, giving plain LRU eviction.
+    template <class K>
+    struct AdmitAll {
+        explicit AdmitAll(std::size_t) {}
+
+        auto record(const K&) -> void {}
+
+        auto admit(const K&, const K&) const -> bool {
+            return true;
+        }
+    };
+
+    /// TinyLFU admission policy. Access frequencies are estimated with a count-min sketch of saturating 8-bit
+    /// counters, halved periodically so that old popularity fades. A new key only replaces the eviction victim if it
+    /// has been seen more often recently, which keeps one-hit wonders from flushing the cache.
+    template <class K, class Hash = std::hash<K>>
+    class TinyLfu {
+    private:
+        static constexpr std::size_t depth = 4;
+
+        Vec<std::uint8_t> counters;
+        std::uint64_t mask;
+        std::size_t additions = 0;
+        std::size_t sample_size;
+        Hash hasher;
+
+        auto slot(std::uint64_t hash, std::size_t row) const -> std::size_t {
+            // Derive a hash per row by multiplying with distinct odd constants.
+            static constexpr std::uint64_t seeds[depth] = {
+                0x9E3779B97F4A7C15ull, 0xC2B2AE3D27D4EB4Full, 0x165667B19E3779F9ull, 0xD6E8FEB86659FD93ull
+            };
+            std::uint64_t mixed = (hash ^ (hash >> 32)) * seeds[row];
+            return row * (mask + 1) + ((mixed >> 29) & mask);
+        }
+
+        /// Halves every counter.
+        auto age() -> void {
+            std::uint8_t* data = counters.raw_ptr_begin();
+            for (std::size_t i = 0; i < counters.size(); i++) {
+                data[i] >>= 1;
+            }
+            additions /= 2;
+        }
+    public:
+        /// Constructs a sketch sized for a cache of `capacity` entries.
+        explicit TinyLfu(std::size_t capacity) : sample_size(std::max<std::size_t>(capacity, 1) * 10) {
+            std::size_t width = 16;
+            while (width < capacity) {
+                width <<= 1;
+            }
+            mask = width - 1;
+            counters = Vec<std::uint8_t>::of(width * depth);
+        }
+
+        /// Records an access to `key`.
+        auto record(const K& key) -> void {
+            std::uint64_t hash = hasher(key);
+            std::uint8_t* data = counters.raw_ptr_begin();
+            for (std::size_t row = 0; row < depth; row++) {
+                std::uint8_t& counter = data[slot(hash, row)];
+                counter += counter != std::numeric_limits<std::uint8_t>::max();
+            }
+            if (++additions >= sample_size) {
+                age();
+            }
+        }
+
+        /// Returns the estimated number of recent accesses to `key`.
+        auto frequency(const K& key) const -> std::uint8_t {
+            std::uint64_t hash = hasher(key);
+            std::uint8_t result = std::numeric_limits<std::uint8_t>::max();
+            for (std::size_t row = 0; row < depth; row++) {
+                result = std::min(result, counters.raw_ptr_begin()[slot(hash, row)]);
+            }
+            return result;
+        }
+
+        /// Returns if `candidate` should replace `victim` in the cache.
+        auto admit(const K& candidate, const K& victim) const -> bool {
+            return frequency(candidate) > frequency(victim);
+        }
+    };
+
+    /// Counters describing how a cache has been used.
+    struct Stats {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t evictions = 0;
+        std::uint64_t rejections = 0;
+
+        auto operator+=(const Stats& other) -> Stats& {
+            hits += other.hits;
+            misses += other.misses;
+            evictions += other.evictions;
+            rejections += other.rejections;
+            return *this;
+        }
+
+        /// Returns the fraction of lookups that were hits.
+        auto hit_rate() const -> double {
+            return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+        }
+    };
+}
+
+/// `LruCache` is a fixed-capacity key-value cache that evicts the least recently used entry. Entries live in
+/// parallel `Vec`s and are linked into the recency list by index rather than by pointer, so every operation is O(1)
+/// and no allocation happens once the cache is full. The `Admission` policy decides whether a new key may evict the
+/// least recently used one; `cache::TinyLfu` turns the cache into a TinyLFU cache.
+/// @note `K` and `V` must be default constructible.
+template <class K, class V, class Admission = cache::AdmitAll<K>, class Hash = std::hash<K>>
+class LruCache {
+public:
+    using Size = typename Vec<V>::Size;
+private:
+    using Link = std::uint32_t;
+
+    static constexpr Link no_link = std::numeric_limits<Link>::max();
+
+    Vec<K> keys;
+    Vec<V> values;
+    Vec<Link> prev;
+    Vec<Link> next;
+    std::unordered_map<K, Link, Hash> index;
+    /// The most recently used entry.
+    Link head = no_link;
+    /// The least recently used entry.
+    Link tail = no_link;
+    Size capacity;
+    Admission admission;
+    cache::Stats counters;
+
+    auto unlink(Link at) -> void {
+        Link* p = prev.raw_ptr_begin();
+        Link* n = next.raw_ptr_begin();
+        (p[at] == no_link ? head : n[p[at]]) = n[at];
+        (n[at] == no_link ? tail : p[n[at]]) = p[at];
+    }
+
+    auto push_front(Link at) -> void {
+        prev.raw_ptr_begin()[at] = no_link;
+        next.raw_ptr_begin()[at] = head;
+        (head == no_link ? tail : prev.raw_ptr_begin()[head]) = at;
+        head = at;
+    }
+
+    auto touch(Link at) -> void {
+        if (head != at) {
+            unlink(at);
+            push_front(at);
+        }
+    }
+public:
+    /// Constructs an empty cache holding at most `capacity` entries.
+    /// @throws InvalidArgument if `capacity` is zero or does not fit the index type.
+    explicit LruCache(Size capacity) : capacity(capacity), admission(capacity) {
+        if (capacity == 0 || capacity >= no_link) {
+            throw error::InvalidArgument("invalid cache capacity.");
+        }
+        keys.request_cap(capacity);
+        values.request_cap(capacity);
+        prev.request_cap(capacity);
+        next.request_cap(capacity);
+        index.reserve(capacity);
+    }
+
+    /// Returns a pointer to the value cached for `key` and marks it most recently used, or returns `nullptr` on a
+    /// miss. The pointer is invalidated by the next insertion or removal.
+    auto find(const K& key) -> V* {
+        admission.record(key);
+        auto found = index.find(key);
+        if (found == index.end()) {
+            counters.misses++;
+            return nullptr;
+        }
+        counters.hits++;
+        touch(found->second);
+        return values.raw_ptr_begin() + found->second;
+    }
+
+    /// Returns a copy of the value cached for `key` and marks it most recently used, or `std::nullopt` on a miss.
+    auto get(const K& key) -> std::optional<V> {
+        V* val = find(key);
+        return val ? std::optional<V>(*val) : std::nullopt;
+    }
+
+    /// Returns if `key` is cached, without affecting recency or statistics.
+    auto contains(const K& key) const -> bool {
+        return index.find(key) != index.end();
+    }
+
+    /// Caches `val` under `key` and marks it most recently used. When the cache is full, the least recently used
+    /// entry is evicted, unless the admission policy rejects `key`. Returns `true` if `key` is cached afterwards.
+    /// Like a lookup, every put counts as an access to `key` for the admission policy, so a key that is only ever
+    /// written can still earn its way in.
+    auto put(const K& key, const V& val) -> bool {
+        admission.record(key);
+        auto found = index.find(key);
+        if (found != index.end()) {
+            values.raw_ptr_begin()[found->second] = val;
+            touch(found->second);
+            return true;
+        }
+        Link at;
+        if (keys.size() < capacity) {
+            at = static_cast<Link>(keys.size());
+            keys.push_back(key);
+            values.push_back(val);
+            prev.push_back(no_link);
+            next.push_back(no_link);
+        } else {
+            at = tail;
+            K& victim = keys.raw_ptr_begin()[at];
+            if (!admission.admit(key, victim)) {
+                counters.rejections++;
+                return false;
+            }
+            counters.evictions++;
+            index.erase(victim);
+            unlink(at);
+            victim = key;
+            values.raw_ptr_begin()[at] = val;
+        }
+        index.emplace(key, at);
+        push_front(at);
+        return true;
+    }
+
+    /// Removes `key` and returns its value, or `std::nullopt` if it is not cached. The last entry of the storage is
+    /// moved into the vacated position so the storage stays dense.
+    auto remove(const K& key) -> std::optional<V> {
+        auto found = index.find(key);
+        if (found == index.end()) {
+            return std::nullopt;
+        }
+        Link at = found->second;
+        index.erase(found);
+        unlink(at);
+        std::optional<V> result(std::move(values.raw_ptr_begin()[at]));
+        auto last = static_cast<Link>(keys.size() - 1);
+        if (at != last) {
+            bool was_head = head == last;
+            bool was_tail = tail == last;
+            keys.raw_ptr_begin()[at] = std::move(keys.raw_ptr_begin()[last]);
+            values.raw_ptr_begin()[at] = std::move(values.raw_ptr_begin()[last]);
+            Link p = prev.raw_ptr_begin()[at] = prev.raw_ptr_begin()[last];
+            Link n = next.raw_ptr_begin()[at] = next.raw_ptr_begin()[last];
+            (was_head ? head : next.raw_ptr_begin()[p]) = at;
+            (was_tail ? tail : prev.raw_ptr_begin()[n]) = at;
+            index[keys.raw_ptr_begin()[at]] = at;
+        }
+        keys.remove(keys.end() - 1);
+        values.remove(values.end() - 1);
+        prev.remove(prev.end() - 1);
+        next.remove(next.end() - 1);
+        return result;
+    }
+
+    /// Removes every entry. Statistics and admission history are kept.
+    auto clear() -> void {
+        keys.clear();
+        values.clear();
+        prev.clear();
+        next.clear();
+        index.clear();
+        head = no_link;
+        tail = no_link;
+    }
+
+    /// Returns the usage statistics of the cache.
+    auto stats() const -> cache::Stats {
+        return counters;
+    }
+
+    /// Returns the maximum number of entries.
+    auto cap() const -> Size {
+        return capacity;
+    }
+
+    /// Returns if the cache is empty.
+    [[nodiscard]]
+    auto is_empty() const -> bool {
+        return keys.is_empty();
+    }
+
+    /// Returns the number of cached entries.
+    auto size() const -> Size {
+        return keys.size();
+    }
+
+    /// Calls `fn(key, value)` for every entry, from most to least recently used.
+    template <class Fn>
+    auto for_each(Fn fn) const -> void {
+        for (Link at = head; at != no_link; at = next.raw_ptr_begin()[at]) {
+            fn(keys.raw_ptr_begin()[at], values.raw_ptr_begin()[at]);
+        }
+    }
+};
+
+/// `ConcurrentLruCache` splits its capacity over independently locked `LruCache` shards, chosen by key hash, so
+/// that threads working on different keys rarely contend. Recency and admission are tracked per shard.
+template <class K, class V, class Admission = cache::AdmitAll<K>, class Hash = std::hash<K>>
+class ConcurrentLruCache {
+public:
+    using Size = typename LruCache<K, V, Admission, Hash>::Size;
+private:
+    struct Shard {
+        std::mutex lock;
+        LruCache<K, V, Admission, Hash> cache;
+
+        explicit Shard(Size capacity) : cache(capacity) {}
+    };
+
+    Vec<std::unique_ptr<Shard>> shards;
+    Hash hasher;
+
+    auto shard_for(const K& key) const -> Shard& {
+        // Use the high bits, since the shard caches' hash tables consume the low ones.
+        std::uint64_t hash = static_cast<std::uint64_t>(hasher(key)) * 0x9E3779B97F4A7C15ull;
+        return *shards.raw_ptr_begin()[(hash >> 32) % shards.size()];
+    }
+public:
+    /// Constructs an empty cache holding about `capacity` entries spread over `shard_count` shards.
+    /// @throws InvalidArgument if `shard_count` is zero or exceeds `capacity`.
+    ConcurrentLruCache(Size capacity, Size shard_count = 16) {
+        if (shard_count == 0 || shard_count > capacity) {
+            throw error::InvalidArgument("invalid cache shard count.");
+        }
+        shards.request_cap(shard_count);
+        for (Size i = 0; i < shard_count; i++) {
+            shards.emplace_back(new Shard(capacity / shard_count + (i < capacity % shard_count)));
+        }
+    }
+
+    /// Returns a copy of the value cached for `key`, or `std::nullopt` on a miss.
+    auto get(const K& key) -> std::optional<V> {
+        Shard& shard = shard_for(key);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        return shard.cache.get(key);
+    }
+
+    /// Caches `val` under `key`. Returns `true` if `key` is cached afterwards.
+    auto put(const K& key, const V& val) -> bool {
+        Shard& shard = shard_for(key);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        return shard.cache.put(key, val);
+    }
+
+    /// Removes `key` and returns its value, or `std::nullopt` if it is not cached.
+    auto remove(const K& key) -> std::optional<V> {
+        Shard& shard = shard_for(key);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        return shard.cache.remove(key);
+    }
+
+    /// Returns if `key` is cached.
+    auto contains(const K& key) const -> bool {
+        Shard& shard = shard_for(key);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        return shard.cache.contains(key);
+    }
+
+    /// Removes every entry from every shard.
+    auto clear() -> void {
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> guard(shard->lock);
+            shard->cache.clear();
+        }
+    }
+
+    /// Returns the usage statistics summed over all shards.
+    auto stats() const -> cache::Stats {
+        cache::Stats total;
+        for (const auto& shard : shards) {
+            std::lock_guard<std::mutex> guard(shard->lock);
+            total += shard->cache.stats();
+        }
+        return total;
+    }
+
+    /// Returns the number of cached entries summed over all shards.
+    auto size() const -> Size {
+        Size total = 0;
+        for (const auto& shard : shards) {
+            std::lock_guard<std::mutex> guard(shard->lock);
+            total += shard->cache.size();
+        }
+        return total;
+    }
+};
+
+#endif //TOOLS_LRU_CACHE_H
@@ -0,0 +1,68 @@
+#include <iostream>
+#include <string>
+
+#include "../lru_cache.h"
+
+auto test_lru() -> int {
+    auto cache = LruCache<int, std::string>(2);
+    cache.put(1, "one");
+    cache.put(2, "two");
+    cache.get(1);
+    cache.put(3, "three");
+    // 3: three, 1: one
+    cache.for_each([](int key, const std::string& val) { std::cout << key << ": " << val << '\n'; });
+    if (cache.contains(2) || cache.remove(1) != "one" || cache.size() != 1) {
+        return 1;
+    }
+    return cache.stats().hits == 1 ? 0 : 1;
+}
+
+auto test_tiny_lfu() -> int {
+    auto cache = LruCache<int, int, cache::TinyLfu<int>>(2);
+    for (int i = 0; i < 3; i++) {
+        cache.get(1);
+        cache.get(2);
+    }
+    cache.put(1, 1);
+    cache.put(2, 2);
+    // A key seen once may not evict a key seen three times.
+    if (cache.put(3, 3) || !cache.contains(1) || !cache.contains(2)) {
+        return 1;
+    }
+    // Puts count as accesses too, so a key that is only ever written is admitted once it is written often enough,
+    // in the sharded cache as well.
+    auto written = LruCache<int, int, cache::TinyLfu<int>>(1);
+    auto sharded = ConcurrentLruCache<int, int, cache::TinyLfu<int>>(1, 1);
+    written.put(1, 1);
+    sharded.put(1, 1);
+    if (written.put(2, 2) || sharded.put(2, 2)) {
+        return 1;
+    }
+    return written.put(2, 2) && written.contains(2) && sharded.put(2, 2) && sharded.contains(2) ? 0 : 1;
+}
+
+auto test_concurrent() -> int {
+    auto cache = ConcurrentLruCache<int, int>(64, 4);
+    for (int i = 0; i < 128; i++) {
+        cache.put(i, i * i);
+    }
+    bool hit = cache.get(127) == 127 * 127;
+    // hit rate: 1
+    std::cout << "hit rate: " << cache.stats().hit_rate() << '\n';
+    if (!hit || cache.size() > 64) {
+        return 1;
+    }
+    try {
+        ConcurrentLruCache<int, int>(4, 8);
+        return 1;
+    } catch (const error::InvalidArgument&) {}
+    try {
+        LruCache<int, int>(0);
+        return 1;
+    } catch (const error::InvalidArgument&) {}
+    return 0;
+}
+
+auto main() -> int {
+    return test_lru() + test_tiny_lfu() + test_concurrent();
+}
@@ -2,7 +2,9 @@
 #define TOOLS_CONCEPTS_H
 
 #include <concepts>
+#include <functional>
 #include <limits>
+#include <type_traits>
 
 #include <vector>
 
@@ -24,6 +26,17 @@ namespace vector {
     concept IsValidIterator = (
         IsForwardIterator<Iterator, T> || IsInputIterator<Iterator, T>
     );
+
+    /// Scalar types whose values are equal exactly when their bytes are: integers, enums and pointers, but not floating
+    /// point types, whose `0.0` and `-0.0` compare equal. Class types are excluded since their `==` may ignore members.
+    template <typename T>
+    concept IsBitwiseComparable = std::is_scalar_v<T> && std::has_unique_object_representations_v<T>;
+
+    /// Types that `std::hash` is specialized for.
+    template <typename T>
+    concept IsHashable = requires (const T& val) {
+        { std::hash<T>()(val) } -> std::convertible_to<std::size_t>;
+    };
 }
 
 #endif //TOOLS_CONCEPTS_H
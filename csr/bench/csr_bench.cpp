@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#include "../csr_matrix.h"
+#include "../graph.h"
+#include "../../bench/bench.h"
+#include "../../parallel/parallel.h"
+
+// Construction, BFS, SpMV and PageRank on synthetic power-law graphs, against BFS over the `Vec<Vec<int>>` adjacency
+// lists that CsrMatrix replaces.
+
+constexpr bench::Size edge_factor = 16;
+constexpr bench::Size sources = 4;
+
+/// Returns the edges of an undirected R-MAT graph (the generator used by Graph500) with 2^`scale` vertices and
+/// `edge_factor` edges per vertex, each stored in both directions. Vertex degrees follow a power law.
+auto rmat(unsigned scale, std::mt19937_64& rng) -> Vec<csr::Edge<float>> {
+    constexpr double a = 0.57;
+    constexpr double b = 0.19;
+    constexpr double c = 0.19;
+    bench::Size count = edge_factor << scale;
+    auto edges = Vec<csr::Edge<float>>();
+    edges.request_cap(2 * count);
+    auto coin = std::uniform_real_distribution<double>(0, 1);
+    for (bench::Size i = 0; i < count; i++) {
+        csr::Index from = 0;
+        csr::Index to = 0;
+        for (unsigned bit = 0; bit < scale; bit++) {
+            double p = coin(rng);
+            from |= static_cast<csr::Index>(p >= a + b) << bit;
+            to |= static_cast<csr::Index>((p >= a && p < a + b) || p >= a + b + c) << bit;
+        }
+        edges.push_back(csr::Edge<float> { from, to });
+        edges.push_back(csr::Edge<float> { to, from });
+    }
+    return edges;
+}
+
+/// Breadth-first search with a queue over per-vertex adjacency `Vec`s.
+auto nested_bfs(const Vec<Vec<int>>& adjacency, int source) -> Vec<int> {
+    auto distance = Vec<int>::of(adjacency.size(), -1);
+    auto queue = Vec<int> { source };
+    distance.raw_ptr_begin()[source] = 0;
+    for (bench::Size head = 0; head < queue.size(); head++) {
+        int v = queue.raw_ptr_begin()[head];
+        for (int w : adjacency.raw_ptr_begin()[v]) {
+            if (distance.raw_ptr_begin()[w] < 0) {
+                distance.raw_ptr_begin()[w] = distance.raw_ptr_begin()[v] + 1;
+                queue.push_back(w);
+            }
+        }
+    }
+    return distance;
+}
+
+auto main() -> int {
+    std::cout << std::fixed << std::setprecision(2);
+    bench::Size threads = parallel::hardware_threads();
+    for (unsigned scale : { 16, 18, 20 }) {
+        auto rng = std::mt19937_64(scale);
+        auto edges = rmat(scale, rng);
+        bench::Size n = bench::Size(1) << scale;
+        auto g = CsrMatrix<float>();
+        double build_one = bench::seconds([&] { g = CsrMatrix<float>::from_edges(n, n, edges, 1); }, 1);
+        double build_all = bench::seconds([&] { g = CsrMatrix<float>::from_edges(n, n, edges, threads); }, 1);
+        auto reverse = g.transposed(threads);
+        auto adjacency = Vec<Vec<int>>::of(n);
+        for (const csr::Edge<float>& e : edges) {
+            adjacency.raw_ptr_begin()[e.from].push_back(static_cast<int>(e.to));
+        }
+
+        // Searches start from the highest-degree vertices, which lie in the giant component.
+        auto roots = Vec<csr::Index>();
+        for (csr::Index v = 0; v < n; v++) {
+            roots.push_back(v);
+        }
+        std::partial_sort(roots.begin(), roots.begin() + sources, roots.end(),
+                          [&](csr::Index u, csr::Index v) { return g.degree(u) > g.degree(v); });
+        roots.resize(sources);
+        double top_down = 0;
+        double hybrid = 0;
+        double nested = 0;
+        double traversed = 0;
+        for (csr::Index root : roots) {
+            auto distance = Vec<csr::Index>();
+            top_down += bench::seconds([&] { distance = graph::bfs(g, root); });
+            hybrid += bench::seconds([&] { bench::keep(graph::bfs(g, reverse, root)); });
+            nested += bench::seconds([&] { bench::keep(nested_bfs(adjacency, static_cast<int>(root))); });
+            for (csr::Index v = 0; v < n; v++) {
+                if (distance.raw_ptr_begin()[v] != graph::unreachable) {
+                    traversed += static_cast<double>(g.degree(v));
+                }
+            }
+        }
+        auto teps = [&](double time) {
+            return traversed / time / 1e6;
+        };
+
+        auto x = Vec<float>::of(n, 1.0f);
+        auto y = Vec<float>::of(n);
+        double spmv = bench::seconds([&] { g.multiply(x, y, threads); }, 5);
+        double pagerank = bench::seconds([&] { bench::keep(graph::pagerank(g, 0.85, 10, 0.0, threads)); }, 1);
+
+        std::cout << "scale " << scale << " (" << n << " vertices, " << g.nnz() << " edges): build "
+                  << build_one * 1e3 << " ms on 1 thread, " << build_all * 1e3 << " ms on " << threads
+                  << " thread(s); BFS " << teps(top_down) << " MTEPS top-down, " << teps(hybrid)
+                  << " MTEPS direction-optimizing, " << teps(nested) << " MTEPS Vec<Vec<int>>; SpMV "
+                  << 2.0 * static_cast<double>(g.nnz()) / spmv / 1e9 << " GFLOP/s; 10 PageRank iterations "
+                  << pagerank * 1e3 << " ms\n";
+    }
+    return 0;
+}
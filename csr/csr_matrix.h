@@ -0,0 +1,212 @@
+#ifndef TOOLS_CSR_MATRIX_H
+#define TOOLS_CSR_MATRIX_H
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <utility>
+
+#include "../parallel/parallel.h"
+#include "../vec/vec.h"
+
+namespace csr {
+    using Index = std::uint32_t;
+    using Size = std::size_t;
+
+    /// An entry of a sparse matrix, or an edge `from -> to` of a graph.
+    template <class T>
+    struct Edge {
+        Index from;
+        Index to;
+        T weight = T(1);
+    };
+}
+
+/// `CsrMatrix` is a sparse matrix in compressed sparse row form: the column indices and values of row `r` are the
+/// entries [offsets[r], offsets[r + 1]) of the `indices` and `values` `Vec`s. Read as a graph, row `r` lists the
+/// out-edges of vertex `r`, all adjacent in memory.
+template <class T = float>
+class CsrMatrix {
+public:
+    using Index = csr::Index;
+    using Size = csr::Size;
+private:
+    Size row_count = 0;
+    Size col_count = 0;
+    Vec<Size> offsets;
+    Vec<Index> indices;
+    Vec<T> values;
+public:
+    /// Constructs an empty, 0 by 0 matrix.
+    CsrMatrix() : offsets(Vec<Size> { 0 }) {}
+
+    /// Constructs a `rows` by `cols` matrix from `edges` with a counting sort by row, using `threads` threads: each
+    /// thread counts the rows of its share of the edges, a prefix sum over the counts gives every thread its own
+    /// write positions, and each thread then scatters its edges without synchronization. Columns are sorted within
+    /// each row; duplicate entries are kept.
+    /// @throws IndexOutOfBounds if an edge lies outside the matrix.
+    static auto from_edges(Size rows, Size cols, const Vec<csr::Edge<T>>& edges, Size threads = 1) -> CsrMatrix<T> {
+        const csr::Edge<T>* data = edges.raw_ptr_begin();
+        for (Size e = 0; e < edges.size(); e++) {
+            if (data[e].from >= rows || data[e].to >= cols) {
+                throw error::IndexOutOfBounds("edge outside of matrix.");
+            }
+        }
+        auto result = CsrMatrix<T>();
+        result.row_count = rows;
+        result.col_count = cols;
+        result.offsets = Vec<Size>::of(rows + 1);
+        result.indices = Vec<Index>::of(edges.size());
+        result.values = Vec<T>::of(edges.size());
+        // A thread needs a full histogram of rows, so only spread large inputs over threads.
+        constexpr Size grain = 1 << 16;
+        threads = std::min(threads, std::max<Size>(1, edges.size() / std::max<Size>(rows, grain)));
+        auto counts = Vec<Size>::of(threads * rows);
+        Size* count = counts.raw_ptr_begin();
+        Size used = parallel::for_ranges(edges.size(), threads, grain, [=](Size t, Size first, Size last) {
+            for (Size e = first; e < last; e++) {
+                count[t * rows + data[e].from]++;
+            }
+        });
+        // Turn the per-thread counts into per-thread write positions, row by row.
+        Size* offset = result.offsets.raw_ptr_begin();
+        Size total = 0;
+        for (Size r = 0; r < rows; r++) {
+            offset[r] = total;
+            for (Size t = 0; t < used; t++) {
+                Size n = count[t * rows + r];
+                count[t * rows + r] = total;
+                total += n;
+            }
+        }
+        offset[rows] = total;
+        Index* index = result.indices.raw_ptr_begin();
+        T* value = result.values.raw_ptr_begin();
+        parallel::for_ranges(edges.size(), used, grain, [=](Size t, Size first, Size last) {
+            for (Size e = first; e < last; e++) {
+                Size at = count[t * rows + data[e].from]++;
+                index[at] = data[e].to;
+                value[at] = data[e].weight;
+            }
+        });
+        parallel::for_ranges(rows, threads, 1024, [=](Size, Size first, Size last) {
+            auto row = Vec<std::pair<Index, T>>();
+            for (Size r = first; r < last; r++) {
+                if (std::is_sorted(index + offset[r], index + offset[r + 1])) {
+                    continue;
+                }
+                row.clear();
+                for (Size k = offset[r]; k < offset[r + 1]; k++) {
+                    row.push_back({ index[k], value[k] });
+                }
+                std::stable_sort(row.begin(), row.end(), [](const auto& a, const auto& b) {
+                    return a.first < b.first;
+                });
+                for (Size k = offset[r]; k < offset[r + 1]; k++) {
+                    index[k] = row[k - offset[r]].first;
+                    value[k] = row[k - offset[r]].second;
+                }
+            }
+        });
+        return result;
+    }
+
+    /// Returns the transpose of the matrix (for a graph, the graph with every edge reversed).
+    auto transposed(Size threads = 1) const -> CsrMatrix<T> {
+        auto edges = Vec<csr::Edge<T>>();
+        edges.request_cap(nnz());
+        for (Size r = 0; r < row_count; r++) {
+            for (Size k = offsets.raw_ptr_begin()[r]; k < offsets.raw_ptr_begin()[r + 1]; k++) {
+                edges.push_back({ indices.raw_ptr_begin()[k], static_cast<Index>(r), values.raw_ptr_begin()[k] });
+            }
+        }
+        return from_edges(col_count, row_count, edges, threads);
+    }
+
+    /// Computes `y = a * x` (sparse matrix-vector product), splitting rows between `threads` threads. Each row's
+    /// entries are contiguous, and the loop over them gathers from `x`.
+    /// @throws IndexOutOfBounds if the dimensions do not agree.
+    auto multiply(const Vec<T>& x, Vec<T>& y, Size threads = 1) const -> void {
+        if (x.size() != col_count || y.size() != row_count) {
+            throw error::IndexOutOfBounds("dimension mismatch for sparse matrix-vector product.");
+        }
+        const Size* offset = offsets.raw_ptr_begin();
+        const Index* index = indices.raw_ptr_begin();
+        const T* value = values.raw_ptr_begin();
+        const T* in = x.raw_ptr_begin();
+        T* out = y.raw_ptr_begin();
+        parallel::for_ranges(row_count, threads, 1024, [=](Size, Size first, Size last) {
+            for (Size r = first; r < last; r++) {
+                T sum = T();
+                for (Size k = offset[r]; k < offset[r + 1]; k++) {
+                    sum += value[k] * in[index[k]];
+                }
+                out[r] = sum;
+            }
+        });
+    }
+
+    /// Returns `a * x`, splitting rows between `threads` threads.
+    /// @throws IndexOutOfBounds if the dimensions do not agree.
+    auto multiply(const Vec<T>& x, Size threads = 1) const -> Vec<T> {
+        auto result = Vec<T>::of(row_count);
+        multiply(x, result, threads);
+        return result;
+    }
+
+    /// Returns the number of stored entries in row `r` (the out-degree of vertex `r`).
+    auto degree(Index r) const -> Size {
+        return offsets.raw_ptr_begin()[r + 1] - offsets.raw_ptr_begin()[r];
+    }
+
+    /// Returns the column indices of row `r` (the out-neighbours of vertex `r`) as a pointer range.
+    auto neighbours(Index r) const -> std::pair<const Index*, const Index*> {
+        const Index* index = indices.raw_ptr_begin();
+        return { index + offsets.raw_ptr_begin()[r], index + offsets.raw_ptr_begin()[r + 1] };
+    }
+
+    /// Returns the number of rows.
+    auto rows() const -> Size {
+        return row_count;
+    }
+
+    /// Returns the number of columns.
+    auto cols() const -> Size {
+        return col_count;
+    }
+
+    /// Returns the number of stored entries.
+    auto nnz() const -> Size {
+        return indices.size();
+    }
+
+    /// Returns the row offsets: row `r` occupies [offsets[r], offsets[r + 1]).
+    auto row_offsets() const -> const Vec<Size>& {
+        return offsets;
+    }
+
+    /// Returns the column index of every stored entry.
+    auto col_indices() const -> const Vec<Index>& {
+        return indices;
+    }
+
+    /// Returns the value of every stored entry.
+    auto entries() const -> const Vec<T>& {
+        return values;
+    }
+
+    /// Send the stored entries as a string of `(row, col): value` triples to std::ostream.
+    friend auto operator<<(std::ostream& os, const CsrMatrix<T>& mat) -> std::ostream& {
+        os << "{";
+        for (Size r = 0; r < mat.row_count; r++) {
+            for (Size k = mat.offsets.raw_ptr_begin()[r]; k < mat.offsets.raw_ptr_begin()[r + 1]; k++) {
+                os << (k == 0 ? "" : ", ") << "(" << r << ", " << mat.indices.raw_ptr_begin()[k] << "): "
+                   << mat.values.raw_ptr_begin()[k];
+            }
+        }
+        os << "}";
+        return os;
+    }
+};
+
+#endif //TOOLS_CSR_MATRIX_H
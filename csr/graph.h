@@ -0,0 +1,223 @@
+#ifndef TOOLS_CSR_GRAPH_H
+#define TOOLS_CSR_GRAPH_H
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "../parallel/parallel.h"
+#include "../vec/vec.h"
+#include "csr_matrix.h"
+
+namespace graph {
+    using Index = csr::Index;
+    using Size = csr::Size;
+
+    /// The distance reported by `bfs` for vertices that cannot be reached.
+    inline constexpr Index unreachable = std::numeric_limits<Index>::max();
+
+    /// A fixed-size set of vertices, one bit each. Used as a BFS frontier, it is 32 times smaller than a `Vec<Index>`
+    /// of a dense frontier, and visits members in vertex order.
+    class Bitset {
+    private:
+        Vec<std::uint64_t> words;
+        Size bits;
+    public:
+        explicit Bitset(Size n = 0) : words(Vec<std::uint64_t>::of((n + 63) / 64)), bits(n) {}
+
+        auto set(Index i) -> void {
+            words.raw_ptr_begin()[i / 64] |= std::uint64_t(1) << (i % 64);
+        }
+
+        auto test(Index i) const -> bool {
+            return (words.raw_ptr_begin()[i / 64] >> (i % 64)) & 1;
+        }
+
+        /// Removes every member.
+        auto clear() -> void {
+            std::uint64_t* data = words.raw_ptr_begin();
+            for (Size w = 0; w < words.size(); w++) {
+                data[w] = 0;
+            }
+        }
+
+        /// Returns the number of members.
+        auto count() const -> Size {
+            Size total = 0;
+            const std::uint64_t* data = words.raw_ptr_begin();
+            for (Size w = 0; w < words.size(); w++) {
+                total += std::popcount(data[w]);
+            }
+            return total;
+        }
+
+        /// Calls `fn(i)` for every member `i`, in increasing order, skipping empty words 64 vertices at a time.
+        template <class Fn>
+        auto for_each(Fn fn) const -> void {
+            const std::uint64_t* data = words.raw_ptr_begin();
+            for (Size w = 0; w < words.size(); w++) {
+                for (std::uint64_t word = data[w]; word != 0; word &= word - 1) {
+                    fn(static_cast<Index>(w * 64 + std::countr_zero(word)));
+                }
+            }
+        }
+
+        /// Returns the number of vertices the set can hold.
+        auto size() const -> Size {
+            return bits;
+        }
+
+        auto swap(Bitset& other) -> void {
+            std::swap(words, other.words);
+            std::swap(bits, other.bits);
+        }
+    };
+
+    /// Returns the number of edges on a shortest path from `source` to every vertex, or `unreachable`. The frontier
+    /// is kept as a `Bitset` and expanded top-down (each frontier vertex visits its out-edges). While the frontier
+    /// is large, `reverse` (the transpose of `g`) is used to expand bottom-up instead: each unvisited vertex scans
+    /// its in-edges and stops at the first one from the frontier, which skips most edges on power-law graphs.
+    /// @throws IndexOutOfBounds if `source` is not a vertex, or if `reverse` does not match `g`.
+    template <class T>
+    auto bfs(const CsrMatrix<T>& g, const CsrMatrix<T>& reverse, Index source) -> Vec<Index> {
+        Size n = g.rows();
+        if (source >= n || g.cols() != n || reverse.rows() != n || reverse.nnz() != g.nnz()) {
+            throw error::IndexOutOfBounds("invalid source or graph for breadth-first search.");
+        }
+        auto distance = Vec<Index>::of(n, unreachable);
+        Index* dist = distance.raw_ptr_begin();
+        auto frontier = Bitset(n);
+        auto next = Bitset(n);
+        frontier.set(source);
+        dist[source] = 0;
+        Size frontier_size = 1;
+        Size frontier_edges = g.degree(source);
+        Size unexplored_edges = g.nnz();
+        for (Index level = 1; frontier_size > 0; level++) {
+            next.clear();
+            Size next_size = 0;
+            Size next_edges = 0;
+            // Heuristic from direction-optimizing BFS: go bottom-up once the frontier's edges outnumber a
+            // fraction of the edges still unexplored.
+            bool bottom_up = frontier_edges > unexplored_edges / 14;
+            if (bottom_up) {
+                for (Index v = 0; v < n; v++) {
+                    if (dist[v] != unreachable) {
+                        continue;
+                    }
+                    auto [first, last] = reverse.neighbours(v);
+                    for (const Index* u = first; u != last; u++) {
+                        if (frontier.test(*u)) {
+                            dist[v] = level;
+                            next.set(v);
+                            next_size++;
+                            next_edges += g.degree(v);
+                            break;
+                        }
+                    }
+                }
+            } else {
+                frontier.for_each([&](Index u) {
+                    auto [first, last] = g.neighbours(u);
+                    for (const Index* v = first; v != last; v++) {
+                        if (dist[*v] == unreachable) {
+                            dist[*v] = level;
+                            next.set(*v);
+                            next_size++;
+                            next_edges += g.degree(*v);
+                        }
+                    }
+                });
+            }
+            unexplored_edges -= std::min(unexplored_edges, frontier_edges);
+            frontier.swap(next);
+            frontier_size = next_size;
+            frontier_edges = next_edges;
+        }
+        return distance;
+    }
+
+    /// Returns the number of edges on a shortest path from `source` to every vertex, or `unreachable`, expanding
+    /// the frontier top-down only.
+    /// @throws IndexOutOfBounds if `source` is not a vertex.
+    template <class T>
+    auto bfs(const CsrMatrix<T>& g, Index source) -> Vec<Index> {
+        if (source >= g.rows() || g.cols() != g.rows()) {
+            throw error::IndexOutOfBounds("invalid source or graph for breadth-first search.");
+        }
+        auto distance = Vec<Index>::of(g.rows(), unreachable);
+        Index* dist = distance.raw_ptr_begin();
+        auto frontier = Bitset(g.rows());
+        auto next = Bitset(g.rows());
+        frontier.set(source);
+        dist[source] = 0;
+        for (Index level = 1; ; level++) {
+            next.clear();
+            bool grew = false;
+            frontier.for_each([&](Index u) {
+                auto [first, last] = g.neighbours(u);
+                for (const Index* v = first; v != last; v++) {
+                    if (dist[*v] == unreachable) {
+                        dist[*v] = level;
+                        next.set(*v);
+                        grew = true;
+                    }
+                }
+            });
+            if (!grew) {
+                break;
+            }
+            frontier.swap(next);
+        }
+        return distance;
+    }
+
+    /// Returns the PageRank of every vertex of `g`, iterating until the L1 change drops below `tolerance` or
+    /// `iterations` rounds have run. Ranks are pulled along in-edges (rows of the transpose), so each vertex's new
+    /// rank is written by exactly one thread; the rank held by vertices without out-edges is spread evenly.
+    template <class T>
+    auto pagerank(const CsrMatrix<T>& g, double damping = 0.85, Size iterations = 100, double tolerance = 1e-9,
+                  Size threads = 1) -> Vec<double> {
+        Size n = g.rows();
+        if (n == 0) {
+            return Vec<double>();
+        }
+        auto reverse = g.transposed(threads);
+        auto rank = Vec<double>::of(n, 1.0 / static_cast<double>(n));
+        auto next = Vec<double>::of(n);
+        auto share = Vec<double>::of(n);
+        for (Size round = 0; round < iterations; round++) {
+            double dangling = 0;
+            double* contribution = share.raw_ptr_begin();
+            for (Index v = 0; v < n; v++) {
+                Size degree = g.degree(v);
+                contribution[v] = degree ? rank.raw_ptr_begin()[v] / static_cast<double>(degree) : 0;
+                dangling += degree ? 0 : rank.raw_ptr_begin()[v];
+            }
+            double base = (1 - damping + damping * dangling) / static_cast<double>(n);
+            double* out = next.raw_ptr_begin();
+            parallel::for_ranges(n, threads, 1024, [&, base, out, contribution](Size, Size first, Size last) {
+                for (Size v = first; v < last; v++) {
+                    auto [begin, end] = reverse.neighbours(static_cast<Index>(v));
+                    double sum = 0;
+                    for (const Index* u = begin; u != end; u++) {
+                        sum += contribution[*u];
+                    }
+                    out[v] = base + damping * sum;
+                }
+            });
+            double change = 0;
+            for (Index v = 0; v < n; v++) {
+                change += std::abs(out[v] - rank.raw_ptr_begin()[v]);
+            }
+            std::swap(rank, next);
+            if (change < tolerance) {
+                break;
+            }
+        }
+        return rank;
+    }
+}
+
+#endif //TOOLS_CSR_GRAPH_H
@@ -0,0 +1,69 @@
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+#include "../csr_matrix.h"
+#include "../graph.h"
+
+auto test_csr() -> int {
+    auto edges = Vec<csr::Edge<float>> { { 1, 2, 3 }, { 0, 1, 1 }, { 1, 0, 2 }, { 2, 2, 4 } };
+    auto mat = CsrMatrix<float>::from_edges(3, 3, edges, 2);
+    // {(0, 1): 1, (1, 0): 2, (1, 2): 3, (2, 2): 4}
+    std::cout << mat << '\n';
+    auto y = mat.multiply(Vec<float> { 1, 1, 1 });
+    // [1, 5, 4]
+    std::cout << y << '\n';
+    return y[1] == 5 && mat.transposed().degree(2) == 2 ? 0 : 1;
+}
+
+auto test_graph() -> int {
+    // A ring of 1000 vertices with a chord from 0 to 500.
+    auto edges = Vec<csr::Edge<float>>();
+    for (csr::Index v = 0; v < 1000; v++) {
+        edges.push_back({ v, (v + 1) % 1000 });
+    }
+    edges.push_back({ 0, 500 });
+    auto g = CsrMatrix<float>::from_edges(1000, 1000, edges);
+    auto top_down = graph::bfs(g, 0);
+    auto hybrid = graph::bfs(g, g.transposed(), 0);
+    if (top_down[999] != 500 || top_down[500] != 1) {
+        return 1;
+    }
+    for (csr::Size v = 0; v < 1000; v++) {
+        if (top_down[v] != hybrid[v]) {
+            return 1;
+        }
+    }
+    auto rank = graph::pagerank(g);
+    double total = 0;
+    for (auto r : rank) {
+        total += r;
+    }
+    // Vertex 500 is reached by two edges, so it ranks above its predecessor.
+    return std::abs(total - 1) < 1e-6 && rank[500] > rank[499] ? 0 : 1;
+}
+
+auto test_parallel() -> int {
+    // A throwing range, on a worker or on the calling thread, reaches the caller once every range has finished.
+    for (parallel::Size failing : { 0, 2 }) {
+        auto finished = std::atomic<int>(0);
+        try {
+            parallel::for_ranges(4, 4, 1, [&](parallel::Size t, parallel::Size, parallel::Size) {
+                if (t == failing) {
+                    throw std::runtime_error("range failed");
+                }
+                finished++;
+            });
+            return 1;
+        } catch (const std::runtime_error&) {}
+        if (finished != 3) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+auto main() -> int {
+    return test_csr() + test_graph() + test_parallel();
+}
@@ -0,0 +1,78 @@
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#include "../matrix.h"
+#include "../../bench/bench.h"
+#include "../../parallel/parallel.h"
+
+// GFLOP/s of the blocked gemm and gemv kernels across sizes, on one thread and on every hardware thread, against a
+// naive triple loop; and the bandwidth of the tiled transpose.
+
+template <class T>
+auto random_matrix(bench::Size rows, bench::Size cols, std::mt19937_64& rng) -> Matrix<T> {
+    auto result = Matrix<T>::of(rows, cols);
+    auto dist = std::uniform_real_distribution<T>(-1, 1);
+    for (bench::Size r = 0; r < rows; r++) {
+        for (bench::Size c = 0; c < cols; c++) {
+            result(r, c) = dist(rng);
+        }
+    }
+    return result;
+}
+
+/// The textbook i-j-k product, walking `b` down its columns.
+template <class T>
+auto naive_product(const Matrix<T>& a, const Matrix<T>& b, Matrix<T>& c) -> void {
+    for (bench::Size i = 0; i < a.rows(); i++) {
+        for (bench::Size j = 0; j < b.cols(); j++) {
+            T sum = T();
+            for (bench::Size k = 0; k < a.cols(); k++) {
+                sum += a(i, k) * b(k, j);
+            }
+            c(i, j) = sum;
+        }
+    }
+}
+
+template <class T>
+auto run(const char* type) -> void {
+    auto rng = std::mt19937_64(1);
+    bench::Size threads = parallel::hardware_threads();
+    for (bench::Size n : { 64, 128, 256, 512, 1024, 2048 }) {
+        auto a = random_matrix<T>(n, n, rng);
+        auto b = random_matrix<T>(n, n, rng);
+        auto c = Matrix<T>::of(n, n);
+        double flops = 2.0 * static_cast<double>(n) * static_cast<double>(n) * static_cast<double>(n);
+        bench::Size repeats = n <= 256 ? 10 : 2;
+        double one = bench::seconds([&] { matrix::gemm(T(1), a.view(), b.view(), T(), c.view()); }, repeats);
+        double all = bench::seconds([&] {
+            matrix::gemm(T(1), a.view(), b.view(), T(), c.view(), threads);
+        }, repeats);
+        std::cout << type << " gemm " << n << ": " << flops / one / 1e9 << " GFLOP/s on 1 thread, "
+                  << flops / all / 1e9 << " GFLOP/s on " << threads << " thread(s)";
+        if (n <= 1024) {
+            double naive = bench::seconds([&] { naive_product(a, b, c); }, 1);
+            std::cout << ", naive " << flops / naive / 1e9 << " GFLOP/s";
+        }
+
+        auto x = Vec<T>::of(n, T(1));
+        auto y = Vec<T>::of(n);
+        double gemv = bench::seconds([&] { matrix::gemv(T(1), a.view(), x, T(), y); }, 10);
+        auto t = Matrix<T>::of(n, n);
+        double transpose = bench::seconds([&] { matrix::transpose(a.view(), t.view()); }, 10);
+        double bytes = 2.0 * static_cast<double>(n * n * sizeof(T));
+        std::cout << "; gemv " << 2.0 * static_cast<double>(n * n) / gemv / 1e9 << " GFLOP/s; transpose "
+                  << bytes / transpose / 1e9 << " GB/s\n";
+        bench::keep(c(0, 0));
+        bench::keep(y[0]);
+        bench::keep(t(0, 0));
+    }
+}
+
+auto main() -> int {
+    std::cout << std::fixed << std::setprecision(2);
+    run<float>("float");
+    run<double>("double");
+    return 0;
+}
@@ -0,0 +1,367 @@
+#ifndef TOOLS_MATRIX_H
+#define TOOLS_MATRIX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+#include "../memory/allocator.h"
+#include "../parallel/parallel.h"
+#include "../vec/vec.h"
+
+namespace matrix {
+    using Size = std::size_t;
+
+    /// Rows and columns processed per tile by the blocked kernels; a tile of doubles fits in L1 alongside its
+    /// neighbours.
+    inline constexpr Size block = 64;
+
+    /// A non-owning, row-major window over matrix elements: element (r, c) lives at `data[r * stride + c]`. Rows,
+    /// columns and blocks of a `Matrix` are all views over its storage, so taking one copies nothing. Use
+    /// `View<const T>` for read-only access.
+    template <class T>
+    class View {
+    private:
+        T* first;
+        Size row_count;
+        Size col_count;
+        Size row_stride;
+    public:
+        View(T* data, Size rows, Size cols, Size stride)
+            : first(data), row_count(rows), col_count(cols), row_stride(stride) {}
+
+        /// A mutable view converts to a read-only one.
+        operator View<const T>() const {
+            return View<const T>(first, row_count, col_count, row_stride);
+        }
+
+        /// Returns the element at row `r`, column `c`, without bounds checking.
+        auto operator()(Size r, Size c) const -> T& {
+            return first[r * row_stride + c];
+        }
+
+        /// Returns the element at row `r`, column `c`.
+        /// @throws IndexOutOfBounds if attempting to access an element at an invalid position.
+        auto at(Size r, Size c) const -> T& {
+            if (r >= row_count || c >= col_count) {
+                throw error::IndexOutOfBounds("invalid position for matrix view.");
+            }
+            return (*this)(r, c);
+        }
+
+        /// Returns a pointer to the first element of row `r`; the row's elements are contiguous.
+        auto row_ptr(Size r) const -> T* {
+            return first + r * row_stride;
+        }
+
+        /// Returns the `rows` by `cols` block whose top-left element is (`r`, `c`).
+        /// @throws IndexOutOfBounds if the block does not fit in the view.
+        auto block(Size r, Size c, Size rows, Size cols) const -> View<T> {
+            if (r + rows > row_count || c + cols > col_count) {
+                throw error::IndexOutOfBounds("block does not fit in matrix view.");
+            }
+            return View<T>(first + r * row_stride + c, rows, cols, row_stride);
+        }
+
+        /// Returns row `r` as a 1 by `cols` view.
+        auto row(Size r) const -> View<T> {
+            return block(r, 0, 1, col_count);
+        }
+
+        /// Returns column `c` as a `rows` by 1 view.
+        auto col(Size c) const -> View<T> {
+            return block(0, c, row_count, 1);
+        }
+
+        auto rows() const -> Size {
+            return row_count;
+        }
+
+        auto cols() const -> Size {
+            return col_count;
+        }
+
+        auto stride() const -> Size {
+            return row_stride;
+        }
+    };
+
+    /// Writes the transpose of `src` into `dst`, tile by tile so that both the reads and the writes stay within a
+    /// few cache lines.
+    /// @throws IndexOutOfBounds if `dst` is not `src.cols()` by `src.rows()`.
+    template <class T>
+    auto transpose(View<const std::type_identity_t<T>> src, View<T> dst) -> void {
+        if (dst.rows() != src.cols() || dst.cols() != src.rows()) {
+            throw error::IndexOutOfBounds("dimension mismatch for transpose.");
+        }
+        for (Size r0 = 0; r0 < src.rows(); r0 += block) {
+            Size r1 = std::min(r0 + block, src.rows());
+            for (Size c0 = 0; c0 < src.cols(); c0 += block) {
+                Size c1 = std::min(c0 + block, src.cols());
+                for (Size r = r0; r < r1; r++) {
+                    const T* from = src.row_ptr(r);
+                    for (Size c = c0; c < c1; c++) {
+                        dst(c, r) = from[c];
+                    }
+                }
+            }
+        }
+    }
+
+    /// Computes `c = alpha * a * b + beta * c`. The loops are tiled so that a block of `b` is reused from cache by
+    /// every row of `a`, and the innermost loop runs along contiguous rows of `b` and `c`, which the compiler
+    /// vectorizes. Row blocks of `c` are split across `threads` threads.
+    /// @throws IndexOutOfBounds if the dimensions do not agree.
+    template <class T>
+    auto gemm(T alpha, View<const std::type_identity_t<T>> a, View<const std::type_identity_t<T>> b,
+              T beta, View<T> c, Size threads = 1) -> void {
+        if (a.cols() != b.rows() || c.rows() != a.rows() || c.cols() != b.cols()) {
+            throw error::IndexOutOfBounds("dimension mismatch for matrix product.");
+        }
+        parallel::for_ranges(c.rows(), threads, block, [=](Size, Size first, Size last) {
+            for (Size i = first; i < last; i++) {
+                T* out = c.row_ptr(i);
+                for (Size j = 0; j < c.cols(); j++) {
+                    out[j] = beta == T() ? T() : beta * out[j];
+                }
+            }
+            for (Size i0 = first; i0 < last; i0 += block) {
+                Size i1 = std::min(i0 + block, last);
+                for (Size k0 = 0; k0 < a.cols(); k0 += block) {
+                    Size k1 = std::min(k0 + block, a.cols());
+                    for (Size j0 = 0; j0 < b.cols(); j0 += block) {
+                        Size j1 = std::min(j0 + block, b.cols());
+                        for (Size i = i0; i < i1; i++) {
+                            T* out = c.row_ptr(i);
+                            const T* lhs = a.row_ptr(i);
+                            for (Size k = k0; k < k1; k++) {
+                                T scale = alpha * lhs[k];
+                                const T* rhs = b.row_ptr(k);
+                                for (Size j = j0; j < j1; j++) {
+                                    out[j] += scale * rhs[j];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    /// Computes `y = alpha * a * x + beta * y`. Each output is a dot product over a contiguous row of `a`, accumulated
+    /// in several independent sums so the compiler can vectorize it.
+    /// @throws IndexOutOfBounds if the dimensions do not agree.
+    template <class T, class XAlloc, class YAlloc>
+    auto gemv(T alpha, View<const std::type_identity_t<T>> a, const Vec<T, XAlloc>& x, T beta, Vec<T, YAlloc>& y,
+              Size threads = 1) -> void {
+        if (x.size() != a.cols() || y.size() != a.rows()) {
+            throw error::IndexOutOfBounds("dimension mismatch for matrix-vector product.");
+        }
+        const T* in = x.raw_ptr_begin();
+        T* out = y.raw_ptr_begin();
+        parallel::for_ranges(a.rows(), threads, block, [=](Size, Size first, Size last) {
+            constexpr Size lanes = 8;
+            for (Size i = first; i < last; i++) {
+                const T* row = a.row_ptr(i);
+                T sums[lanes] = {};
+                Size k = 0;
+                for (; k + lanes <= a.cols(); k += lanes) {
+                    for (Size l = 0; l < lanes; l++) {
+                        sums[l] += row[k + l] * in[k + l];
+                    }
+                }
+                T sum = T();
+                for (; k < a.cols(); k++) {
+                    sum += row[k] * in[k];
+                }
+                for (Size l = 0; l < lanes; l++) {
+                    sum += sums[l];
+                }
+                out[i] = alpha * sum + (beta == T() ? T() : beta * out[i]);
+            }
+        });
+    }
+}
+
+/// `Matrix` is a dense, row-major matrix stored in a single `Vec` that draws from `Alloc`. The default allocator starts
+/// the storage on a 64-byte boundary, so the first row of every matrix begins on a cache line. Rows, columns and
+/// blocks are exposed as `matrix::View`s over the same storage, and products use the blocked kernels in the `matrix`
+/// namespace.
+template <class T, class Alloc = memory::AlignedAllocator<T>>
+class Matrix {
+public:
+    using Size = matrix::Size;
+private:
+    Size row_count = 0;
+    Size col_count = 0;
+    Vec<T, Alloc> elements;
+
+    Matrix(Size rows, Size cols, Vec<T, Alloc> elements)
+        : row_count(rows), col_count(cols), elements(std::move(elements)) {}
+public:
+    /// Constructs an empty, 0 by 0 matrix.
+    Matrix() = default;
+
+    /// Constructs a `rows` by `cols` matrix that allocates from `alloc`. Each element is a copy of `default_val` (if
+    /// provided).
+    static auto of(Size rows, Size cols, const T& default_val = T(), const Alloc& alloc = Alloc()) -> Matrix {
+        return Matrix(rows, cols, Vec<T, Alloc>::of(rows * cols, default_val, alloc));
+    }
+
+    /// Constructs a `rows` by `cols` matrix that allocates from `alloc`, from the row-major elements of `vec`.
+    /// @throws IndexOutOfBounds if `vec` does not have `rows * cols` elements.
+    template <class VecAlloc>
+    static auto from(Size rows, Size cols, const Vec<T, VecAlloc>& vec, const Alloc& alloc = Alloc()) -> Matrix {
+        if (vec.size() != rows * cols) {
+            throw error::IndexOutOfBounds("element count does not match matrix dimensions.");
+        }
+        return Matrix(rows, cols, Vec<T, Alloc>::from(vec.begin(), vec.end(), alloc));
+    }
+
+    /// Constructs an `n` by `n` identity matrix that allocates from `alloc`.
+    static auto identity(Size n, const Alloc& alloc = Alloc()) -> Matrix {
+        auto result = of(n, n, T(), alloc);
+        for (Size i = 0; i < n; i++) {
+            result(i, i) = T(1);
+        }
+        return result;
+    }
+
+    /// Returns the element at row `r`, column `c`, without bounds checking.
+    auto operator()(Size r, Size c) -> T& {
+        return elements.raw_ptr_begin()[r * col_count + c];
+    }
+
+    /// Returns the element at row `r`, column `c`, without bounds checking.
+    auto operator()(Size r, Size c) const -> const T& {
+        return elements.raw_ptr_begin()[r * col_count + c];
+    }
+
+    /// Returns the element at row `r`, column `c`.
+    /// @throws IndexOutOfBounds if attempting to access an element at an invalid position.
+    auto at(Size r, Size c) -> T& {
+        return view().at(r, c);
+    }
+
+    /// Returns the element at row `r`, column `c`.
+    /// @throws IndexOutOfBounds if attempting to access an element at an invalid position.
+    auto at(Size r, Size c) const -> const T& {
+        return view().at(r, c);
+    }
+
+    /// Returns a view of the whole matrix.
+    auto view() -> matrix::View<T> {
+        return matrix::View<T>(elements.raw_ptr_begin(), row_count, col_count, col_count);
+    }
+
+    /// Returns a view of the whole matrix.
+    auto view() const -> matrix::View<const T> {
+        return matrix::View<const T>(elements.raw_ptr_begin(), row_count, col_count, col_count);
+    }
+
+    /// Returns row `r` as a 1 by `cols` view.
+    /// @throws IndexOutOfBounds if `r` is not a valid row.
+    auto row(Size r) -> matrix::View<T> {
+        return view().row(r);
+    }
+
+    /// Returns row `r` as a 1 by `cols` view.
+    /// @throws IndexOutOfBounds if `r` is not a valid row.
+    auto row(Size r) const -> matrix::View<const T> {
+        return view().row(r);
+    }
+
+    /// Returns column `c` as a `rows` by 1 view.
+    /// @throws IndexOutOfBounds if `c` is not a valid column.
+    auto col(Size c) -> matrix::View<T> {
+        return view().col(c);
+    }
+
+    /// Returns column `c` as a `rows` by 1 view.
+    /// @throws IndexOutOfBounds if `c` is not a valid column.
+    auto col(Size c) const -> matrix::View<const T> {
+        return view().col(c);
+    }
+
+    /// Returns the `rows` by `cols` block whose top-left element is (`r`, `c`).
+    /// @throws IndexOutOfBounds if the block does not fit in the matrix.
+    auto block(Size r, Size c, Size rows, Size cols) -> matrix::View<T> {
+        return view().block(r, c, rows, cols);
+    }
+
+    /// Returns the `rows` by `cols` block whose top-left element is (`r`, `c`).
+    /// @throws IndexOutOfBounds if the block does not fit in the matrix.
+    auto block(Size r, Size c, Size rows, Size cols) const -> matrix::View<const T> {
+        return view().block(r, c, rows, cols);
+    }
+
+    /// Returns the transpose of the matrix, allocated like the matrix.
+    auto transposed() const -> Matrix {
+        auto result = of(col_count, row_count, T(), elements.get_allocator());
+        matrix::transpose(view(), result.view());
+        return result;
+    }
+
+    /// Returns the product of the matrix and `other`, using `threads` threads and allocated like the matrix.
+    /// @throws IndexOutOfBounds if the dimensions do not agree.
+    auto multiply(const Matrix& other, Size threads = 1) const -> Matrix {
+        auto result = of(row_count, other.col_count, T(), elements.get_allocator());
+        matrix::gemm(T(1), view(), other.view(), T(), result.view(), threads);
+        return result;
+    }
+
+    /// Returns the product of the matrix and the column vector `x`, using `threads` threads and allocated like `x`.
+    /// @throws IndexOutOfBounds if the dimensions do not agree.
+    template <class VecAlloc>
+    auto multiply(const Vec<T, VecAlloc>& x, Size threads = 1) const -> Vec<T, VecAlloc> {
+        auto result = Vec<T, VecAlloc>::of(row_count, T(), x.get_allocator());
+        matrix::gemv(T(1), view(), x, T(), result, threads);
+        return result;
+    }
+
+    /// Returns the number of rows.
+    auto rows() const -> Size {
+        return row_count;
+    }
+
+    /// Returns the number of columns.
+    auto cols() const -> Size {
+        return col_count;
+    }
+
+    /// Returns the row-major elements of the matrix.
+    auto data() const -> const Vec<T, Alloc>& {
+        return elements;
+    }
+
+    /// Returns the product of `a` and `b`.
+    /// @throws IndexOutOfBounds if the dimensions do not agree.
+    friend auto operator*(const Matrix& a, const Matrix& b) -> Matrix {
+        return a.multiply(b);
+    }
+
+    /// Returns the product of `a` and the column vector `x`.
+    /// @throws IndexOutOfBounds if the dimensions do not agree.
+    template <class VecAlloc>
+    friend auto operator*(const Matrix& a, const Vec<T, VecAlloc>& x) -> Vec<T, VecAlloc> {
+        return a.multiply(x);
+    }
+
+    /// Send the contents of the matrix as a string to std::ostream, one row per line.
+    friend auto operator<<(std::ostream& os, const Matrix& mat) -> std::ostream& {
+        os << "[";
+        for (Size r = 0; r < mat.row_count; r++) {
+            os << (r == 0 ? "[" : " [");
+            for (Size c = 0; c < mat.col_count; c++) {
+                os << mat(r, c) << (c + 1 != mat.col_count ? ", " : "");
+            }
+            os << (r + 1 != mat.row_count ? "]\n" : "]");
+        }
+        os << "]";
+        return os;
+    }
+};
+
+#endif //TOOLS_MATRIX_H
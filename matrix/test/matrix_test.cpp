@@ -0,0 +1,65 @@
+#include <cstdint>
+#include <iostream>
+
+#include "../matrix.h"
+#include "../../memory/arena.h"
+
+auto test() -> int {
+    auto a = Matrix<int>::from(2, 3, Vec<int> { 1, 2, 3, 4, 5, 6 });
+    auto b = a.transposed();
+    auto product = a * b;
+    // [[14, 32]
+    //  [32, 77]]
+    std::cout << product << '\n';
+    auto column = a.col(1);
+    if (column(1, 0) != 5 || a.block(1, 1, 1, 2)(0, 1) != 6) {
+        return 1;
+    }
+    auto x = a * Vec<int> { 1, 1, 1 };
+    if (x[0] != 6 || x[1] != 15) {
+        return 1;
+    }
+
+    // The blocked, threaded product agrees with the naive one across tile boundaries.
+    Matrix<double>::Size n = 150;
+    auto c = Matrix<double>::of(n, n + 7);
+    auto d = Matrix<double>::of(n + 7, n - 3);
+    for (Matrix<double>::Size i = 0; i < n; i++) {
+        for (Matrix<double>::Size j = 0; j < n + 7; j++) {
+            c(i, j) = static_cast<double>((i * 7 + j) % 11);
+        }
+    }
+    for (Matrix<double>::Size i = 0; i < n + 7; i++) {
+        for (Matrix<double>::Size j = 0; j < n - 3; j++) {
+            d(i, j) = static_cast<double>((i + j * 3) % 5);
+        }
+    }
+    auto e = c.multiply(d, 4);
+    for (Matrix<double>::Size i = 0; i < e.rows(); i++) {
+        for (Matrix<double>::Size j = 0; j < e.cols(); j++) {
+            double expected = 0;
+            for (Matrix<double>::Size k = 0; k < c.cols(); k++) {
+                expected += c(i, k) * d(k, j);
+            }
+            if (e(i, j) != expected) {
+                return 1;
+            }
+        }
+    }
+
+    // Storage starts on a cache line by default, and any other allocator is carried into products.
+    for (const auto* m : { &c, &d, &e }) {
+        if (reinterpret_cast<std::uintptr_t>(m->data().raw_ptr_begin()) % 64 != 0) {
+            return 1;
+        }
+    }
+    auto arena = MonotonicArena();
+    using ArenaAlloc = memory::Allocator<int, MonotonicArena>;
+    auto f = Matrix<int, ArenaAlloc>::from(2, 3, Vec<int> { 1, 2, 3, 4, 5, 6 }, ArenaAlloc(arena));
+    auto g = f * f.transposed();
+    return g(1, 0) == 32 && g.data().get_allocator() == ArenaAlloc(arena) ? 0 : 1;
+}
+
+auto main() -> int {
+    return test();
+}
@@ -0,0 +1,91 @@
+#ifndef TOOLS_ALLOCATOR_H
+#define TOOLS_ALLOCATOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace memory {
+    /// A standard allocator that draws from a memory resource such as `MonotonicArena` or `SizeClassPool`, so that
+    /// `Vec` and standard containers can use them. It only holds a pointer: the resource must outlive every container
+    /// using it. Containers carry their allocator along when moved, copied or swapped.
+    template <class T, class Resource>
+    class Allocator {
+    private:
+        template <class U, class R>
+        friend class Allocator;
+
+        Resource* resource;
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+        using is_always_equal = std::false_type;
+
+        template <class U>
+        struct rebind {
+            using other = Allocator<U, Resource>;
+        };
+
+        explicit Allocator(Resource& resource) : resource(&resource) {}
+
+        template <class U>
+        Allocator(const Allocator<U, Resource>& other) : resource(other.resource) {}
+
+        auto allocate(std::size_t n) -> T* {
+            return static_cast<T*>(resource->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        auto deallocate(T* ptr, std::size_t n) -> void {
+            resource->deallocate(ptr, n * sizeof(T), alignof(T));
+        }
+
+        /// Returns the resource this allocator draws from.
+        auto source() const -> Resource& {
+            return *resource;
+        }
+
+        template <class U>
+        auto operator==(const Allocator<U, Resource>& other) const -> bool {
+            return resource == other.resource;
+        }
+    };
+
+    /// A stateless standard allocator whose blocks start on an `Align`-byte boundary (a cache line by default), so that
+    /// SIMD loops over the first elements need no peeling and buffers never share a cache line with other data.
+    template <class T, std::size_t Align = 64>
+    class AlignedAllocator {
+    private:
+        static constexpr std::align_val_t alignment = std::align_val_t(std::max(Align, alignof(T)));
+    public:
+        using value_type = T;
+        using is_always_equal = std::true_type;
+
+        template <class U>
+        struct rebind {
+            using other = AlignedAllocator<U, Align>;
+        };
+
+        AlignedAllocator() = default;
+
+        template <class U>
+        AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+        auto allocate(std::size_t n) -> T* {
+            return static_cast<T*>(::operator new(n * sizeof(T), alignment));
+        }
+
+        auto deallocate(T* ptr, std::size_t n) -> void {
+            ::operator delete(ptr, n * sizeof(T), alignment);
+        }
+
+        template <class U>
+        auto operator==(const AlignedAllocator<U, Align>&) const -> bool {
+            return true;
+        }
+    };
+}
+
+#endif //TOOLS_ALLOCATOR_H
@@ -0,0 +1,168 @@
+#ifndef TOOLS_ARENA_H
+#define TOOLS_ARENA_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <unordered_map>
+
+#include "../vec/vec.h"
+
+namespace memory {
+    using Size = std::size_t;
+
+    /// Rounds `n` up to a multiple of `align`, which must be a power of two.
+    inline auto align_up(std::uintptr_t n, Size align) -> std::uintptr_t {
+        return (n + align - 1) & ~static_cast<std::uintptr_t>(align - 1);
+    }
+
+    /// A block of memory obtained from the global allocator and owned by an arena.
+    struct Chunk {
+        std::byte* data;
+        Size bytes;
+    };
+
+    inline auto allocate_chunk(Size bytes) -> Chunk {
+        return Chunk { static_cast<std::byte*>(::operator new(bytes)), bytes };
+    }
+
+    inline auto free_chunk(const Chunk& chunk) -> void {
+        ::operator delete(chunk.data, chunk.bytes);
+    }
+
+    namespace detail {
+        /// The chunk a thread is carving for one arena. The arena owns it, so its remainder survives any cache misses.
+        struct LocalChunk {
+            std::byte* cursor = nullptr;
+            std::byte* end = nullptr;
+        };
+
+        /// A thread's shortcut to its `LocalChunk` in the arena with id `owner`.
+        struct CachedChunk {
+            std::uint64_t owner = 0;
+            LocalChunk* chunk = nullptr;
+        };
+
+        /// Each thread caches the chunks of a few arenas at once, found by searching for the arena's id. A miss only
+        /// costs a locked lookup in the arena; slots are replaced in turn.
+        inline constexpr Size local_slots = 4;
+        inline thread_local CachedChunk local_chunks[local_slots];
+        inline thread_local Size next_replaced = 0;
+
+        /// Arena ids are never reused, so a stale cache entry can never match a live arena.
+        inline std::atomic<std::uint64_t> next_arena_id { 1 };
+    }
+}
+
+/// `MonotonicArena` hands out memory by bumping a pointer through large chunks, and frees it all at once on `reset` or
+/// destruction; `deallocate` does nothing. It is thread-safe: each thread carves its own chunk (found through a
+/// thread-local cache), so allocations only take the arena's lock when a thread needs a new chunk or has not used the
+/// arena recently. Memory allocated by
+/// one thread may be used and passed to `deallocate` by any other.
+class MonotonicArena {
+public:
+    using Size = memory::Size;
+private:
+    std::atomic<std::uint64_t> id;
+    std::mutex lock;
+    Vec<memory::Chunk> chunks;
+    std::unordered_map<std::thread::id, memory::detail::LocalChunk> locals;
+    Size next_chunk_bytes;
+    Size max_chunk_bytes;
+    std::atomic<Size> reserved { 0 };
+
+    /// Carves `bytes` from `local`, or returns null if they do not fit.
+    static auto carve(memory::detail::LocalChunk& local, Size bytes, Size align) -> void* {
+        if (local.cursor == nullptr) {
+            return nullptr;
+        }
+        auto start = memory::align_up(reinterpret_cast<std::uintptr_t>(local.cursor), align);
+        if (start + bytes > reinterpret_cast<std::uintptr_t>(local.end)) {
+            return nullptr;
+        }
+        local.cursor = reinterpret_cast<std::byte*>(start + bytes);
+        return reinterpret_cast<void*>(start);
+    }
+
+    /// Allocates under the lock. `local` is the calling thread's chunk, or null if its cache missed, in which case
+    /// the chunk is looked up and cached first.
+    auto refill(memory::detail::LocalChunk* local, Size bytes, Size align) -> void* {
+        auto guard = std::lock_guard(lock);
+        if (local == nullptr) {
+            local = &locals[std::this_thread::get_id()];
+            auto& slot = memory::detail::local_chunks[memory::detail::next_replaced++ % memory::detail::local_slots];
+            slot = memory::detail::CachedChunk { id.load(std::memory_order_relaxed), local };
+            if (void* ptr = carve(*local, bytes, align)) {
+                return ptr;
+            }
+        }
+        Size needed = bytes + align;
+        // Allocations too large to share a chunk get one of their own and leave the thread's chunk in place.
+        if (needed > max_chunk_bytes / 4) {
+            chunks.push_back(memory::allocate_chunk(needed));
+            reserved += needed;
+            auto start = reinterpret_cast<std::uintptr_t>(chunks.peek_back().data);
+            return reinterpret_cast<void*>(memory::align_up(start, align));
+        }
+        auto chunk = memory::allocate_chunk(std::max(next_chunk_bytes, needed));
+        chunks.push_back(chunk);
+        reserved += chunk.bytes;
+        next_chunk_bytes = std::min(next_chunk_bytes * 2, max_chunk_bytes);
+        *local = memory::detail::LocalChunk { chunk.data, chunk.data + chunk.bytes };
+        return carve(*local, bytes, align);
+    }
+public:
+    /// Constructs an empty arena. Chunks start at `initial_chunk_bytes` and double up to `max_chunk_bytes`.
+    explicit MonotonicArena(Size initial_chunk_bytes = 4096, Size max_chunk_bytes = 1 << 20)
+        : id(memory::detail::next_arena_id++),
+          next_chunk_bytes(std::max<Size>(initial_chunk_bytes, 64)),
+          max_chunk_bytes(std::max(max_chunk_bytes, std::max<Size>(initial_chunk_bytes, 64))) {}
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    auto operator=(const MonotonicArena&) -> MonotonicArena& = delete;
+
+    ~MonotonicArena() {
+        for (const memory::Chunk& chunk : chunks) {
+            memory::free_chunk(chunk);
+        }
+    }
+
+    /// Returns `bytes` bytes aligned to `align` (a power of two).
+    auto allocate(Size bytes, Size align = alignof(std::max_align_t)) -> void* {
+        std::uint64_t self = id.load(std::memory_order_relaxed);
+        for (memory::detail::CachedChunk& slot : memory::detail::local_chunks) {
+            if (slot.owner == self) {
+                void* ptr = carve(*slot.chunk, bytes, align);
+                return ptr != nullptr ? ptr : refill(slot.chunk, bytes, align);
+            }
+        }
+        return refill(nullptr, bytes, align);
+    }
+
+    /// Does nothing: memory is only released by `reset` or the destructor.
+    auto deallocate(void*, Size, Size = alignof(std::max_align_t)) -> void {}
+
+    /// Frees every chunk. No thread may use memory from the arena, or allocate from it concurrently, at this point.
+    auto reset() -> void {
+        auto guard = std::lock_guard(lock);
+        for (const memory::Chunk& chunk : chunks) {
+            memory::free_chunk(chunk);
+        }
+        chunks.clear();
+        locals.clear();
+        reserved = 0;
+        // A fresh id invalidates every thread's cached chunk.
+        id.store(memory::detail::next_arena_id++, std::memory_order_relaxed);
+    }
+
+    /// Returns the number of bytes obtained from the global allocator.
+    auto bytes_reserved() const -> Size {
+        return reserved.load(std::memory_order_relaxed);
+    }
+};
+
+#endif //TOOLS_ARENA_H
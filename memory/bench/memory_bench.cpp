@@ -0,0 +1,161 @@
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "../allocator.h"
+#include "../arena.h"
+#include "../buffer_pool.h"
+#include "../growable_arena.h"
+#include "../pool.h"
+#include "../../art/art_map.h"
+#include "../../bench/bench.h"
+#include "../../parallel/parallel.h"
+
+// Allocation-heavy workloads with each memory resource against the global heap: phases of short vectors on one and
+// several threads, ArtMap nodes, buffers built by repeated growth, and churn of temporary buffers.
+
+constexpr bench::Size phases = 20;
+constexpr bench::Size vectors_per_phase = 200'000;
+constexpr bench::Size art_keys = 1'000'000;
+constexpr bench::Size buffers = 2'000;
+constexpr bench::Size buffer_bytes = 256 * 1024;
+constexpr bench::Size temporaries = 200'000;
+
+/// Builds `vectors_per_phase` vectors of 1 to 16 ints in each phase, split over `threads` threads, and keeps them all
+/// until the phase ends. `make` returns an empty vector drawing from the resource under test, and `end_phase` is
+/// called once every vector of a phase is gone.
+template <class Make, class EndPhase>
+auto vector_phases(bench::Size threads, Make make, EndPhase end_phase) -> void {
+    for (bench::Size phase = 0; phase < phases; phase++) {
+        parallel::for_ranges(vectors_per_phase, threads, 1, [&](bench::Size, bench::Size first, bench::Size last) {
+            auto kept = Vec<decltype(make())>();
+            kept.request_cap(last - first);
+            for (bench::Size i = first; i < last; i++) {
+                kept.emplace_back(make());
+                for (int j = 0; j <= static_cast<int>(i % 16); j++) {
+                    kept.peek_back().push_back(j);
+                }
+            }
+            bench::keep(kept.size());
+        });
+        end_phase();
+    }
+}
+
+auto main() -> int {
+    std::cout << std::fixed << std::setprecision(2);
+    auto ms = [](double time) {
+        return time * 1e3;
+    };
+
+    for (bench::Size threads : { bench::Size(1), std::max<bench::Size>(4, parallel::hardware_threads()) }) {
+        double heap = bench::seconds([&] {
+            vector_phases(threads, [] { return Vec<int>(); }, [] {});
+        });
+        auto arena = MonotonicArena();
+        using Alloc = memory::Allocator<int, MonotonicArena>;
+        double bump = bench::seconds([&] {
+            vector_phases(threads, [&] { return Vec<int, Alloc>(Alloc(arena)); }, [&] { arena.reset(); });
+        });
+        std::cout << phases << " phases of " << vectors_per_phase << " short Vec<int>s on " << threads
+                  << " thread(s): " << ms(heap) << " ms global heap, " << ms(bump) << " ms MonotonicArena\n";
+    }
+
+    auto rng = std::mt19937_64(11);
+    auto keys = Vec<std::string>();
+    for (bench::Size i = 0; i < art_keys; i++) {
+        keys.push_back(art::encode(static_cast<std::uint64_t>(rng())));
+    }
+    // Each run builds the map and then destroys it, so both allocation and freeing of the nodes are timed.
+    double art_heap = bench::seconds([&] {
+        auto map = ArtMap<std::uint64_t>();
+        for (bench::Size i = 0; i < keys.size(); i++) {
+            map.insert(keys.raw_ptr_begin()[i], i);
+        }
+    });
+    auto pool = SizeClassPool();
+    double art_pool = bench::seconds([&] {
+        auto map = ArtMap<std::uint64_t>(pool);
+        for (bench::Size i = 0; i < keys.size(); i++) {
+            map.insert(keys.raw_ptr_begin()[i], i);
+        }
+    });
+    std::cout << "ArtMap build and destroy with " << art_keys << " keys: " << ms(art_heap) << " ms global heap, "
+              << ms(art_pool) << " ms SizeClassPool\n";
+
+    // Each buffer grows one 64-byte record at a time to `buffer_bytes` and is then freed. The raw arena buffer doubles
+    // its capacity when full, in place while its chunk has room; a `Vec` on the arena copies like any other.
+    constexpr bench::Size record = 64;
+    auto payload = Vec<std::byte>::of(record, std::byte(1));
+    double vec_growth = bench::seconds([&] {
+        for (bench::Size b = 0; b < buffers; b++) {
+            auto buffer = Vec<std::byte>();
+            for (bench::Size size = 0; size < buffer_bytes; size += record) {
+                buffer.insert_range(buffer.end(), payload.begin(), payload.end());
+            }
+            bench::keep(buffer.size());
+        }
+    });
+    auto growable = GrowableArena();
+    using Bytes = memory::Allocator<std::byte, GrowableArena>;
+    double vec_arena_growth = bench::seconds([&] {
+        for (bench::Size b = 0; b < buffers; b++) {
+            {
+                auto buffer = Vec<std::byte, Bytes>(Bytes(growable));
+                for (bench::Size size = 0; size < buffer_bytes; size += record) {
+                    buffer.insert_range(buffer.end(), payload.begin(), payload.end());
+                }
+                bench::keep(buffer.size());
+            }
+            // Every buffer the vector grew through stays in the arena until `reset`.
+            growable.reset();
+        }
+    });
+    double arena_growth = bench::seconds([&] {
+        for (bench::Size b = 0; b < buffers; b++) {
+            bench::Size cap = record;
+            auto* buffer = static_cast<std::byte*>(growable.allocate(cap));
+            for (bench::Size size = 0; size < buffer_bytes; size += record) {
+                if (size == cap) {
+                    buffer = static_cast<std::byte*>(growable.reallocate(buffer, cap, 2 * cap));
+                    cap *= 2;
+                }
+                std::memcpy(buffer + size, payload.raw_ptr_begin(), record);
+            }
+            bench::keep(buffer[0]);
+            growable.deallocate(buffer, cap);
+        }
+    });
+    std::cout << buffers << " buffers grown to " << buffer_bytes / 1024 << " KiB: " << ms(vec_growth)
+              << " ms Vec, " << ms(vec_arena_growth) << " ms Vec on GrowableArena, " << ms(arena_growth)
+              << " ms GrowableArena::reallocate\n";
+
+    // Temporaries of 1 KiB to 64 KiB that are sized, touched and dropped, as a request handler would.
+    auto sizes = Vec<bench::Size>();
+    for (bench::Size i = 0; i < temporaries; i++) {
+        sizes.push_back(1024 + rng() % (63 * 1024));
+    }
+    double plain = bench::seconds([&] {
+        for (bench::Size size : sizes) {
+            auto body = Vec<std::uint8_t>();
+            body.request_cap(size);
+            body.push_back(1);
+            bench::keep(body.size());
+        }
+    });
+    double recycled = bench::seconds([&] {
+        for (bench::Size size : sizes) {
+            auto body = RecycledVec<std::uint8_t>();
+            body.request_cap(size);
+            body.push_back(1);
+            bench::keep(body.size());
+        }
+    });
+    auto stats = BufferPool::global().stats();
+    std::cout << temporaries << " temporary buffers: " << ms(plain) << " ms Vec, " << ms(recycled)
+              << " ms RecycledVec (" << stats.hits << " pool hits, " << stats.misses << " misses)\n";
+    return 0;
+}
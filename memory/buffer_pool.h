@@ -0,0 +1,226 @@
+#ifndef TOOLS_BUFFER_POOL_H
+#define TOOLS_BUFFER_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+#include "../vec/vec.h"
+
+namespace memory {
+    using Size = std::size_t;
+
+    /// Counters describing a `BufferPool` since it was created.
+    struct BufferStats {
+        /// Requests served from a thread's cache or the shared depot.
+        Size hits = 0;
+        /// Requests that allocated fresh memory (including requests too large to pool).
+        Size misses = 0;
+        /// Buffers freed to the global allocator because the pool was full.
+        Size dropped = 0;
+        /// Bytes currently held in the shared depot, ready for reuse.
+        Size depot_bytes = 0;
+    };
+}
+
+/// `BufferPool` recycles the storage of short-lived buffers. Requests are rounded up to a power of two between
+/// `min_buffer_bytes` and `max_buffer_bytes`; larger requests bypass the pool. Each thread keeps a small cache of free
+/// buffers per size class and only touches the shared, locked depot when its cache runs empty or full. The depot
+/// holds at most `limit` bytes, beyond which returned buffers are freed, so the pool's footprint stays bounded.
+/// There is one pool per process, reached through `global`; `memory::Recycling` is the allocator that draws from it.
+class BufferPool {
+public:
+    using Size = memory::Size;
+
+    static constexpr Size min_buffer_bytes = 64;
+    static constexpr Size max_buffer_bytes = Size(1) << 20;
+private:
+    static constexpr Size class_count = std::countr_zero(max_buffer_bytes) - std::countr_zero(min_buffer_bytes) + 1;
+    /// The bytes a thread may cache per size class (at least one buffer).
+    static constexpr Size local_bytes = 256 * 1024;
+
+    struct Depot {
+        std::mutex lock;
+        Vec<void*> buffers;
+    };
+
+    struct ThreadCache {
+        Vec<void*> buffers[class_count];
+
+        ~ThreadCache() {
+            for (Size c = 0; c < class_count; c++) {
+                global().give_back(c, buffers[c], buffers[c].size());
+            }
+        }
+    };
+
+    Depot depots[class_count];
+    std::atomic<Size> limit { Size(64) << 20 };
+    std::atomic<Size> depot_bytes { 0 };
+    std::atomic<Size> hits { 0 };
+    std::atomic<Size> misses { 0 };
+    std::atomic<Size> dropped { 0 };
+
+    BufferPool() = default;
+
+    static auto class_of(Size bytes) -> Size {
+        Size rounded = std::bit_ceil(std::max(bytes, min_buffer_bytes));
+        return static_cast<Size>(std::countr_zero(rounded) - std::countr_zero(min_buffer_bytes));
+    }
+
+    static auto class_bytes(Size size_class) -> Size {
+        return min_buffer_bytes << size_class;
+    }
+
+    static auto local_cap(Size size_class) -> Size {
+        return std::max<Size>(1, local_bytes / class_bytes(size_class));
+    }
+
+    static auto cache() -> ThreadCache& {
+        static thread_local ThreadCache local;
+        return local;
+    }
+
+    /// Moves the last `n` buffers of `from` to the depot, freeing those that would exceed the limit.
+    auto give_back(Size size_class, Vec<void*>& from, Size n) -> void {
+        Size bytes = class_bytes(size_class);
+        Depot& depot = depots[size_class];
+        auto guard = std::lock_guard(depot.lock);
+        for (Size i = 0; i < n; i++) {
+            void* buffer = *from.pop_back();
+            if (depot_bytes.load(std::memory_order_relaxed) + bytes <= limit.load(std::memory_order_relaxed)) {
+                depot.buffers.push_back(buffer);
+                depot_bytes += bytes;
+            } else {
+                ::operator delete(buffer, bytes);
+                dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Moves up to `n` buffers from the depot to `to`.
+    auto take(Size size_class, Vec<void*>& to, Size n) -> void {
+        Depot& depot = depots[size_class];
+        auto guard = std::lock_guard(depot.lock);
+        n = std::min(n, depot.buffers.size());
+        for (Size i = 0; i < n; i++) {
+            to.push_back(*depot.buffers.pop_back());
+        }
+        depot_bytes -= n * class_bytes(size_class);
+    }
+public:
+    BufferPool(const BufferPool&) = delete;
+    auto operator=(const BufferPool&) -> BufferPool& = delete;
+
+    ~BufferPool() {
+        trim();
+    }
+
+    /// Returns the process-wide pool.
+    static auto global() -> BufferPool& {
+        static BufferPool pool;
+        return pool;
+    }
+
+    /// Returns a buffer of at least `bytes` bytes, aligned for any fundamental type.
+    auto allocate(Size bytes) -> void* {
+        if (bytes > max_buffer_bytes) {
+            misses.fetch_add(1, std::memory_order_relaxed);
+            return ::operator new(bytes);
+        }
+        Size size_class = class_of(bytes);
+        Vec<void*>& local = cache().buffers[size_class];
+        if (local.is_empty()) {
+            // Refill half the cache at once so the depot's lock is taken once per several allocations.
+            take(size_class, local, (local_cap(size_class) + 1) / 2);
+        }
+        if (local.is_empty()) {
+            misses.fetch_add(1, std::memory_order_relaxed);
+            return ::operator new(class_bytes(size_class));
+        }
+        hits.fetch_add(1, std::memory_order_relaxed);
+        return *local.pop_back();
+    }
+
+    /// Returns a buffer obtained from `allocate(bytes)` to the pool.
+    auto deallocate(void* ptr, Size bytes) -> void {
+        if (bytes > max_buffer_bytes) {
+            ::operator delete(ptr, bytes);
+            return;
+        }
+        Size size_class = class_of(bytes);
+        Vec<void*>& local = cache().buffers[size_class];
+        local.push_back(ptr);
+        if (local.size() > local_cap(size_class)) {
+            give_back(size_class, local, local.size() / 2);
+        }
+    }
+
+    /// Sets the most bytes the shared depot may hold. Buffers already held are not freed until `trim`.
+    auto set_limit(Size bytes) -> void {
+        limit.store(bytes, std::memory_order_relaxed);
+    }
+
+    /// Frees every buffer held in the shared depot. Buffers cached by threads are kept.
+    auto trim() -> void {
+        for (Size c = 0; c < class_count; c++) {
+            auto guard = std::lock_guard(depots[c].lock);
+            for (void* buffer : depots[c].buffers) {
+                ::operator delete(buffer, class_bytes(c));
+            }
+            depot_bytes -= depots[c].buffers.size() * class_bytes(c);
+            depots[c].buffers.clear();
+        }
+    }
+
+    /// Returns the pool's counters.
+    auto stats() const -> memory::BufferStats {
+        return memory::BufferStats {
+            hits.load(std::memory_order_relaxed),
+            misses.load(std::memory_order_relaxed),
+            dropped.load(std::memory_order_relaxed),
+            depot_bytes.load(std::memory_order_relaxed),
+        };
+    }
+};
+
+namespace memory {
+    /// A stateless standard allocator drawing from `BufferPool::global()`. Buffers freed by one thread are reused by
+    /// any other.
+    template <class T>
+    class Recycling {
+    public:
+        using value_type = T;
+        using is_always_equal = std::true_type;
+
+        Recycling() = default;
+
+        template <class U>
+        Recycling(const Recycling<U>&) {}
+
+        auto allocate(std::size_t n) -> T* {
+            static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types cannot be recycled.");
+            return static_cast<T*>(BufferPool::global().allocate(n * sizeof(T)));
+        }
+
+        auto deallocate(T* ptr, std::size_t n) -> void {
+            BufferPool::global().deallocate(ptr, n * sizeof(T));
+        }
+
+        template <class U>
+        auto operator==(const Recycling<U>&) const -> bool {
+            return true;
+        }
+    };
+}
+
+/// A `Vec` whose storage is recycled through `BufferPool::global()`: `of`, `request_cap` and growth draw buffers from
+/// the pool, and destruction returns them.
+template <class T>
+using RecycledVec = Vec<T, memory::Recycling<T>>;
+
+#endif //TOOLS_BUFFER_POOL_H
@@ -0,0 +1,118 @@
+#ifndef TOOLS_GROWABLE_ARENA_H
+#define TOOLS_GROWABLE_ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "../vec/vec.h"
+#include "arena.h"
+
+/// `GrowableArena` is a single-threaded bump allocator that remembers its most recent allocation. That allocation can
+/// be grown in place while the chunk has room (`try_grow`), and freeing it gives its memory back, so a buffer that is
+/// built by repeated growth at the top of the arena never copies. Everything else is freed at once by `reset` or the
+/// destructor. Growth in place is only reached through `try_grow` and `reallocate`: a `Vec` on this arena grows like
+/// `std::vector`, copying into a new block and freeing a block that is no longer the last, which does nothing.
+class GrowableArena {
+public:
+    using Size = memory::Size;
+private:
+    Vec<memory::Chunk> chunks;
+    std::byte* cursor = nullptr;
+    std::byte* end = nullptr;
+    /// The start of the most recent allocation, or `nullptr` once it is freed.
+    std::byte* last = nullptr;
+    Size next_chunk_bytes;
+
+    auto is_last(void* ptr, Size bytes) const -> bool {
+        return ptr == last && last + bytes == cursor;
+    }
+public:
+    /// Constructs an empty arena whose chunks start at `initial_chunk_bytes` and double in size.
+    explicit GrowableArena(Size initial_chunk_bytes = 4096)
+        : next_chunk_bytes(std::max<Size>(initial_chunk_bytes, 64)) {}
+
+    GrowableArena(const GrowableArena&) = delete;
+    auto operator=(const GrowableArena&) -> GrowableArena& = delete;
+
+    ~GrowableArena() {
+        for (const memory::Chunk& chunk : chunks) {
+            memory::free_chunk(chunk);
+        }
+    }
+
+    /// Returns `bytes` bytes aligned to `align` (a power of two).
+    auto allocate(Size bytes, Size align = alignof(std::max_align_t)) -> void* {
+        auto start = memory::align_up(reinterpret_cast<std::uintptr_t>(cursor), align);
+        if (cursor == nullptr || start + bytes > reinterpret_cast<std::uintptr_t>(end)) {
+            auto chunk = memory::allocate_chunk(std::max(next_chunk_bytes, bytes + align));
+            chunks.push_back(chunk);
+            next_chunk_bytes *= 2;
+            end = chunk.data + chunk.bytes;
+            start = memory::align_up(reinterpret_cast<std::uintptr_t>(chunk.data), align);
+        }
+        last = reinterpret_cast<std::byte*>(start);
+        cursor = last + bytes;
+        return last;
+    }
+
+    /// Grows the allocation at `ptr` from `old_bytes` to `new_bytes` without moving it. Succeeds only for the most
+    /// recent allocation, and only while its chunk has room; returns if it succeeded.
+    auto try_grow(void* ptr, Size old_bytes, Size new_bytes) -> bool {
+        if (!is_last(ptr, old_bytes) || new_bytes > static_cast<Size>(end - last)) {
+            return false;
+        }
+        cursor = last + new_bytes;
+        return true;
+    }
+
+    /// Resizes the allocation at `ptr` to `new_bytes`, in place if possible and otherwise by copying its first
+    /// `old_bytes` bytes to a new allocation. The contents must be trivially copyable.
+    auto reallocate(void* ptr, Size old_bytes, Size new_bytes, Size align = alignof(std::max_align_t)) -> void* {
+        if (ptr != nullptr && try_grow(ptr, old_bytes, new_bytes)) {
+            return ptr;
+        }
+        void* moved = allocate(new_bytes, align);
+        if (ptr != nullptr) {
+            std::memcpy(moved, ptr, std::min(old_bytes, new_bytes));
+        }
+        return moved;
+    }
+
+    /// Gives the memory back if `ptr` is the most recent allocation; otherwise does nothing.
+    auto deallocate(void* ptr, Size bytes, Size = alignof(std::max_align_t)) -> void {
+        if (is_last(ptr, bytes)) {
+            cursor = last;
+            last = nullptr;
+        }
+    }
+
+    /// Frees every allocation, keeping the newest chunk for reuse.
+    auto reset() -> void {
+        if (chunks.is_empty()) {
+            return;
+        }
+        memory::Chunk keep = chunks.peek_back();
+        chunks.resize(chunks.size() - 1);
+        for (const memory::Chunk& chunk : chunks) {
+            memory::free_chunk(chunk);
+        }
+        chunks.clear();
+        chunks.push_back(keep);
+        cursor = keep.data;
+        end = keep.data + keep.bytes;
+        last = nullptr;
+    }
+
+    /// Returns the number of bytes obtained from the global allocator.
+    auto bytes_reserved() const -> Size {
+        Size total = 0;
+        for (const memory::Chunk& chunk : chunks) {
+            total += chunk.bytes;
+        }
+        return total;
+    }
+};
+
+#endif //TOOLS_GROWABLE_ARENA_H
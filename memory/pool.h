@@ -0,0 +1,112 @@
+#ifndef TOOLS_POOL_H
+#define TOOLS_POOL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+
+#include "../vec/vec.h"
+#include "arena.h"
+
+/// `SizeClassPool` recycles fixed-size blocks, such as the nodes of a tree. Requests are rounded up to a multiple of
+/// 16 bytes, and each such size class keeps a free list threaded through its free blocks. An empty free list is
+/// refilled by carving a new slab. Blocks return to their free list on `deallocate` and are only released to the
+/// global allocator when the pool is destroyed. Requests above `max_block_bytes` bypass the pool.
+/// The pool is not thread-safe; give each thread (or each container) its own.
+class SizeClassPool {
+public:
+    using Size = memory::Size;
+
+    static constexpr Size granularity = 16;
+    static constexpr Size max_block_bytes = 4096;
+private:
+    static constexpr Size class_count = max_block_bytes / granularity;
+    static constexpr Size slab_bytes = 64 * 1024;
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    FreeBlock* free_lists[class_count] = {};
+    Vec<memory::Chunk> slabs;
+    Size in_use = 0;
+
+    static auto class_of(Size bytes) -> Size {
+        return (std::max<Size>(bytes, 1) + granularity - 1) / granularity - 1;
+    }
+
+    auto refill(Size size_class) -> void {
+        Size block = (size_class + 1) * granularity;
+        auto slab = memory::allocate_chunk(std::max(slab_bytes, 8 * block));
+        slabs.push_back(slab);
+        Size blocks = slab.bytes / block;
+        for (Size i = blocks; i-- > 0;) {
+            auto* free = reinterpret_cast<FreeBlock*>(slab.data + i * block);
+            free->next = free_lists[size_class];
+            free_lists[size_class] = free;
+        }
+    }
+public:
+    SizeClassPool() = default;
+
+    SizeClassPool(const SizeClassPool&) = delete;
+    auto operator=(const SizeClassPool&) -> SizeClassPool& = delete;
+
+    ~SizeClassPool() {
+        for (const memory::Chunk& slab : slabs) {
+            memory::free_chunk(slab);
+        }
+    }
+
+    /// Returns a block of at least `bytes` bytes aligned to `align`. Pooled blocks are 16-byte aligned, so larger
+    /// alignments bypass the pool.
+    auto allocate(Size bytes, Size align = alignof(std::max_align_t)) -> void* {
+        if (align > granularity) {
+            return ::operator new(bytes, std::align_val_t(align));
+        }
+        if (bytes > max_block_bytes) {
+            return ::operator new(bytes);
+        }
+        Size size_class = class_of(bytes);
+        if (free_lists[size_class] == nullptr) {
+            refill(size_class);
+        }
+        FreeBlock* block = free_lists[size_class];
+        free_lists[size_class] = block->next;
+        in_use += (size_class + 1) * granularity;
+        return block;
+    }
+
+    /// Returns a block obtained from `allocate` with the same `bytes` and `align` to its free list.
+    auto deallocate(void* ptr, Size bytes, Size align = alignof(std::max_align_t)) -> void {
+        if (align > granularity) {
+            ::operator delete(ptr, bytes, std::align_val_t(align));
+            return;
+        }
+        if (bytes > max_block_bytes) {
+            ::operator delete(ptr, bytes);
+            return;
+        }
+        Size size_class = class_of(bytes);
+        auto* block = static_cast<FreeBlock*>(ptr);
+        block->next = free_lists[size_class];
+        free_lists[size_class] = block;
+        in_use -= (size_class + 1) * granularity;
+    }
+
+    /// Returns the number of bytes in pooled blocks currently handed out.
+    auto bytes_in_use() const -> Size {
+        return in_use;
+    }
+
+    /// Returns the number of bytes held in slabs.
+    auto bytes_reserved() const -> Size {
+        Size total = 0;
+        for (const memory::Chunk& slab : slabs) {
+            total += slab.bytes;
+        }
+        return total;
+    }
+};
+
+#endif //TOOLS_POOL_H
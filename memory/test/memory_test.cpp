@@ -0,0 +1,116 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "../allocator.h"
+#include "../arena.h"
+#include "../buffer_pool.h"
+#include "../growable_arena.h"
+#include "../pool.h"
+#include "../../art/art_map.h"
+#include "../../parallel/parallel.h"
+
+auto test() -> int {
+    // Four threads fill vectors from one arena; each thread carves its own chunk.
+    auto arena = MonotonicArena();
+    using ArenaVec = Vec<int, memory::Allocator<int, MonotonicArena>>;
+    auto sums = Vec<long>::of(4);
+    parallel::for_ranges(4, 4, 1, [&](std::size_t t, std::size_t, std::size_t) {
+        auto values = ArenaVec(memory::Allocator<int, MonotonicArena>(arena));
+        for (int i = 0; i < 1000; i++) {
+            values.push_back(i);
+        }
+        long sum = 0;
+        for (int val : values) {
+            sum += val;
+        }
+        sums[t] = sum;
+    });
+    // sums 499500 499500 499500 499500
+    std::cout << "sums " << sums << '\n';
+    for (long sum : sums) {
+        if (sum != 499500) {
+            return 1;
+        }
+    }
+
+    // Concatenating arena vectors needs no default-constructed allocator; the result draws from the same arena.
+    auto head = ArenaVec(memory::Allocator<int, MonotonicArena>(arena));
+    head.push_back(1);
+    auto tail = head;
+    tail.push_back(2);
+    auto parts = Vec<ArenaVec>();
+    parts.push_back(head);
+    parts.push_back(tail);
+    auto joined = ArenaVec::concat(head, tail);
+    auto flattened = ArenaVec::concat(parts);
+    if (joined.size() != 3 || joined.get_allocator() != head.get_allocator() || flattened.size() != 3
+        || flattened.at(2) != 2 || flattened.get_allocator() != head.get_allocator()) {
+        return 1;
+    }
+
+    // Arenas used in turn keep their chunks, however many share a thread.
+    auto first = MonotonicArena();
+    auto others = Vec<MonotonicArena*>();
+    for (int i = 0; i < 7; i++) {
+        others.push_back(new MonotonicArena());
+    }
+    for (int i = 0; i < 1000; i++) {
+        first.allocate(16);
+        others.at(static_cast<std::size_t>(i % 7))->allocate(16);
+    }
+    // reserved by alternating arena: 28672
+    std::cout << "reserved by alternating arena: " << first.bytes_reserved() << '\n';
+    bool compact = first.bytes_reserved() <= 32768;
+    for (MonotonicArena* other : others) {
+        compact = compact && other->bytes_reserved() <= 32768;
+        delete other;
+    }
+    if (!compact) {
+        return 1;
+    }
+
+    // The most recent allocation grows in place.
+    auto growable = GrowableArena();
+    void* buffer = growable.allocate(64);
+    if (!growable.try_grow(buffer, 64, 1024) || growable.reallocate(buffer, 1024, 2048) != buffer) {
+        return 1;
+    }
+
+    // Once a buffer of each size has been freed, temporary buffers are recycled instead of allocated.
+    {
+        auto warm_up = RecycledVec<float>::of(1000, 0.5f);
+    }
+    auto before = BufferPool::global().stats();
+    for (int round = 0; round < 100; round++) {
+        auto samples = RecycledVec<float>::of(1000, 0.5f);
+    }
+    auto after = BufferPool::global().stats();
+    // misses in steady state: 0
+    std::cout << "misses in steady state: " << after.misses - before.misses << '\n';
+    if (after.misses != before.misses || after.hits != before.hits + 100) {
+        return 1;
+    }
+
+    // Removed nodes return to the pool and are reused by later inserts.
+    auto pool = SizeClassPool();
+    auto map = ArtMap<int>(pool);
+    for (std::uint64_t i = 0; i < 1000; i++) {
+        map.insert(art::encode(i), static_cast<int>(i));
+    }
+    std::size_t used = pool.bytes_in_use();
+    for (std::uint64_t i = 0; i < 1000; i++) {
+        map.remove(art::encode(i));
+    }
+    std::size_t reserved = pool.bytes_reserved();
+    for (std::uint64_t i = 0; i < 1000; i++) {
+        map.insert(art::encode(i), static_cast<int>(i));
+    }
+    // pool reused: yes
+    std::cout << "pool reused: " << (pool.bytes_reserved() == reserved ? "yes" : "no") << '\n';
+    return used > 0 && pool.bytes_reserved() == reserved && map.at(art::encode(std::uint64_t(999))) == 999 ? 0 : 1;
+}
+
+auto main() -> int {
+    return test();
+}
@@ -0,0 +1,74 @@
+#ifndef TOOLS_PARALLEL_H
+#define TOOLS_PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+    using Size = std::size_t;
+
+    /// Returns the number of hardware threads, or 1 if it cannot be determined.
+    inline auto hardware_threads() -> Size {
+        return std::max<Size>(1, std::thread::hardware_concurrency());
+    }
+
+    namespace detail {
+        /// Joins every joinable thread of `workers` when destroyed, so that no exit path leaves one running.
+        struct JoinAll {
+            std::vector<std::thread>& workers;
+
+            ~JoinAll() {
+                for (auto& worker : workers) {
+                    if (worker.joinable()) {
+                        worker.join();
+                    }
+                }
+            }
+        };
+    }
+
+    /// Splits [0, `n`) into at most `threads` contiguous ranges whose boundaries are multiples of `grain`, and calls
+    /// `fn(t, first, last)` for the `t`th range on its own thread. The calling thread runs the first range itself, so
+    /// a single range never starts a thread. Returns the number of ranges used.
+    ///
+    /// Every range runs to completion even if another throws. Once all threads have finished, an exception from the
+    /// calling thread's range is rethrown, or else the exception of the lowest-numbered range that threw.
+    template <class Fn>
+    auto for_ranges(Size n, Size threads, Size grain, Fn fn) -> Size {
+        grain = std::max<Size>(grain, 1);
+        Size grains = (n + grain - 1) / grain;
+        threads = std::clamp<Size>(threads, 1, std::max<Size>(grains, 1));
+        auto bound = [=](Size t) {
+            return std::min(n, grains * t / threads * grain);
+        };
+        // Plain std::vectors, since Vec itself runs its bulk operations through this header.
+        auto failures = std::vector<std::exception_ptr>(threads);
+        auto workers = std::vector<std::thread>();
+        auto join = detail::JoinAll { workers };
+        workers.reserve(threads - 1);
+        for (Size t = 1; t < threads; t++) {
+            workers.emplace_back([fn, t, first = bound(t), last = bound(t + 1), &failures] {
+                try {
+                    fn(t, first, last);
+                } catch (...) {
+                    failures[t] = std::current_exception();
+                }
+            });
+        }
+        fn(Size(0), Size(0), bound(1));
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (const std::exception_ptr& failure : failures) {
+            if (failure != nullptr) {
+                std::rethrow_exception(failure);
+            }
+        }
+        return threads;
+    }
+}
+
+#endif //TOOLS_PARALLEL_H
@@ -0,0 +1,700 @@
+#ifndef TOOLS_ROARING_BITMAP_H
+#define TOOLS_ROARING_BITMAP_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+#include "../vec/vec.h"
+
+namespace roaring {
+    using Size = std::size_t;
+
+    enum class Kind : std::uint8_t { array, bitmap, run };
+
+    /// The values [`start`, `start + length`]. The runs of a container are sorted and do not overlap.
+    struct Run {
+        std::uint16_t start;
+        std::uint16_t length;
+    };
+
+    /// Array containers hold at most this many values; larger sets use a bitmap.
+    constexpr Size array_limit = 4096;
+    constexpr Size bitmap_words = 1024;
+
+    /// The low 16 bits of the values sharing one high 16-bit key. Exactly one of `values` (sorted), `words` or `runs`
+    /// is in use, according to `kind`.
+    struct Container {
+        Kind kind = Kind::array;
+        std::uint32_t cardinality = 0;
+        Vec<std::uint16_t> values;
+        Vec<std::uint64_t> words;
+        Vec<Run> runs;
+    };
+
+    inline auto make_container(Kind kind, std::uint32_t cardinality) -> Container {
+        auto c = Container();
+        c.kind = kind;
+        c.cardinality = cardinality;
+        return c;
+    }
+
+    template <class Fn>
+    auto for_each(const Container& c, Fn fn) -> void {
+        switch (c.kind) {
+            case Kind::array:
+                for (std::uint16_t val : c.values) {
+                    fn(val);
+                }
+                break;
+            case Kind::bitmap: {
+                const std::uint64_t* words = c.words.raw_ptr_begin();
+                for (Size i = 0; i < bitmap_words; i++) {
+                    for (std::uint64_t w = words[i]; w != 0; w &= w - 1) {
+                        fn(static_cast<std::uint16_t>(i * 64 + std::countr_zero(w)));
+                    }
+                }
+                break;
+            }
+            case Kind::run:
+                for (const Run& run : c.runs) {
+                    for (std::uint32_t v = run.start; v <= std::uint32_t(run.start) + run.length; v++) {
+                        fn(static_cast<std::uint16_t>(v));
+                    }
+                }
+                break;
+        }
+    }
+
+    inline auto to_bitmap(const Container& c) -> Container {
+        auto result = make_container(Kind::bitmap, c.cardinality);
+        result.words = Vec<std::uint64_t>::of(bitmap_words);
+        std::uint64_t* words = result.words.raw_ptr_begin();
+        if (c.kind == Kind::run) {
+            for (const Run& run : c.runs) {
+                std::uint32_t first = run.start;
+                std::uint32_t last = first + run.length;
+                for (std::uint32_t w = first / 64; w <= last / 64; w++) {
+                    std::uint32_t lo = std::max(first, w * 64) - w * 64;
+                    std::uint32_t hi = std::min(last, w * 64 + 63) - w * 64;
+                    words[w] |= (~std::uint64_t(0) >> (63 - (hi - lo))) << lo;
+                }
+            }
+        } else {
+            for_each(c, [words](std::uint16_t v) { words[v / 64] |= std::uint64_t(1) << (v % 64); });
+        }
+        return result;
+    }
+
+    inline auto to_array(const Container& c) -> Container {
+        auto result = make_container(Kind::array, c.cardinality);
+        result.values.request_cap(c.cardinality);
+        for_each(c, [&result](std::uint16_t v) { result.values.push_back(v); });
+        return result;
+    }
+
+    /// Returns `c` as an array or bitmap container, whichever suits its cardinality.
+    inline auto natural(const Container& c) -> Container {
+        if (c.kind != Kind::run) {
+            return c;
+        }
+        return c.cardinality <= array_limit ? to_array(c) : to_bitmap(c);
+    }
+
+    /// Returns `c` if it is an array or bitmap container; a run container is expanded into `storage`, which is
+    /// returned instead. Unlike `natural`, this never copies a container that is already in its natural kind.
+    inline auto natural_view(const Container& c, Container& storage) -> const Container& {
+        if (c.kind != Kind::run) {
+            return c;
+        }
+        storage = natural(c);
+        return storage;
+    }
+
+    /// Converts an array that outgrew its limit to a bitmap, or a bitmap that shrank below it to an array.
+    inline auto normalize(Container& c) -> void {
+        if (c.kind == Kind::array && c.cardinality > array_limit) {
+            c = to_bitmap(c);
+        } else if (c.kind == Kind::bitmap && c.cardinality <= array_limit) {
+            c = to_array(c);
+        }
+    }
+
+    inline auto contains(const Container& c, std::uint16_t v) -> bool {
+        switch (c.kind) {
+            case Kind::array:
+                return std::binary_search(c.values.begin(), c.values.end(), v);
+            case Kind::bitmap:
+                return (c.words.raw_ptr_begin()[v / 64] >> (v % 64)) & 1;
+            case Kind::run: {
+                auto it = std::upper_bound(c.runs.begin(), c.runs.end(), v,
+                                           [](std::uint16_t x, const Run& run) { return x < run.start; });
+                return it != c.runs.begin() && v <= std::uint32_t((it - 1)->start) + (it - 1)->length;
+            }
+        }
+        return false;
+    }
+
+    /// Adds `v`; returns if it was absent.
+    inline auto add(Container& c, std::uint16_t v) -> bool {
+        if (contains(c, v)) {
+            return false;
+        }
+        if (c.kind == Kind::run) {
+            c = natural(c);
+        }
+        if (c.kind == Kind::array) {
+            c.values.insert(std::lower_bound(c.values.begin(), c.values.end(), v), v);
+        } else {
+            c.words.raw_ptr_begin()[v / 64] |= std::uint64_t(1) << (v % 64);
+        }
+        c.cardinality++;
+        normalize(c);
+        return true;
+    }
+
+    /// Removes `v`; returns if it was present.
+    inline auto remove(Container& c, std::uint16_t v) -> bool {
+        if (!contains(c, v)) {
+            return false;
+        }
+        if (c.kind == Kind::run) {
+            c = natural(c);
+        }
+        if (c.kind == Kind::array) {
+            c.values.remove(std::lower_bound(c.values.begin(), c.values.end(), v));
+        } else {
+            c.words.raw_ptr_begin()[v / 64] &= ~(std::uint64_t(1) << (v % 64));
+        }
+        c.cardinality--;
+        normalize(c);
+        return true;
+    }
+
+    enum class Op { intersect, unite, subtract };
+
+    /// Combines two bitmaps word by word. The loop has no branches, so the compiler vectorizes it.
+    inline auto combine_bitmaps(const Container& a, const Container& b, Op op) -> Container {
+        auto result = make_container(Kind::bitmap, 0);
+        result.words = Vec<std::uint64_t>::of(bitmap_words);
+        const std::uint64_t* x = a.words.raw_ptr_begin();
+        const std::uint64_t* y = b.words.raw_ptr_begin();
+        std::uint64_t* out = result.words.raw_ptr_begin();
+        switch (op) {
+            case Op::intersect:
+                for (Size i = 0; i < bitmap_words; i++) {
+                    out[i] = x[i] & y[i];
+                }
+                break;
+            case Op::unite:
+                for (Size i = 0; i < bitmap_words; i++) {
+                    out[i] = x[i] | y[i];
+                }
+                break;
+            case Op::subtract:
+                for (Size i = 0; i < bitmap_words; i++) {
+                    out[i] = x[i] & ~y[i];
+                }
+                break;
+        }
+        std::uint32_t count = 0;
+        for (Size i = 0; i < bitmap_words; i++) {
+            count += static_cast<std::uint32_t>(std::popcount(out[i]));
+        }
+        result.cardinality = count;
+        normalize(result);
+        return result;
+    }
+
+    /// Intersects two sorted arrays. When one is much smaller, each of its values is found by galloping through the
+    /// other; otherwise the two are merged.
+    inline auto intersect_arrays(const Container& a, const Container& b) -> Container {
+        const Container& small = a.cardinality <= b.cardinality ? a : b;
+        const Container& large = a.cardinality <= b.cardinality ? b : a;
+        auto result = make_container(Kind::array, 0);
+        result.values.request_cap(small.cardinality);
+        const std::uint16_t* s = small.values.raw_ptr_begin();
+        const std::uint16_t* l = large.values.raw_ptr_begin();
+        const std::uint16_t* l_end = l + large.cardinality;
+        if (std::size_t(small.cardinality) * 32 < large.cardinality) {
+            for (Size i = 0; i < small.cardinality && l != l_end; i++) {
+                Size step = 1;
+                while (l + step < l_end && l[step] < s[i]) {
+                    step *= 2;
+                }
+                l = std::lower_bound(l + step / 2, std::min(l + step + 1, l_end), s[i]);
+                if (l != l_end && *l == s[i]) {
+                    result.values.push_back(s[i]);
+                }
+            }
+        } else {
+            const std::uint16_t* s_end = s + small.cardinality;
+            while (s != s_end && l != l_end) {
+                if (*s == *l) {
+                    result.values.push_back(*s);
+                }
+                std::uint16_t lv = *l;
+                l += lv <= *s;
+                s += *s <= lv;
+            }
+        }
+        result.cardinality = static_cast<std::uint32_t>(result.values.size());
+        return result;
+    }
+
+    /// Returns the combination of two containers. Run containers are expanded to their natural kind first; the result
+    /// is an array or bitmap container.
+    inline auto combine(const Container& lhs, const Container& rhs, Op op) -> Container {
+        Container expanded_lhs;
+        Container expanded_rhs;
+        const Container& a = natural_view(lhs, expanded_lhs);
+        const Container& b = natural_view(rhs, expanded_rhs);
+        if (a.kind == Kind::bitmap && b.kind == Kind::bitmap) {
+            return combine_bitmaps(a, b, op);
+        }
+        if (op == Op::intersect) {
+            if (a.kind == Kind::array && b.kind == Kind::array) {
+                return intersect_arrays(a, b);
+            }
+            const Container& array = a.kind == Kind::array ? a : b;
+            const Container& bitmap = a.kind == Kind::array ? b : a;
+            auto result = make_container(Kind::array, 0);
+            for (std::uint16_t v : array.values) {
+                if (contains(bitmap, v)) {
+                    result.values.push_back(v);
+                }
+            }
+            result.cardinality = static_cast<std::uint32_t>(result.values.size());
+            return result;
+        }
+        if (op == Op::unite) {
+            if (a.kind == Kind::array && b.kind == Kind::array) {
+                auto result = make_container(Kind::array, 0);
+                result.values.resize(a.values.size() + b.values.size());
+                auto end = std::set_union(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                                          result.values.begin());
+                result.values.resize(static_cast<Size>(end - result.values.begin()));
+                result.cardinality = static_cast<std::uint32_t>(result.values.size());
+                normalize(result);
+                return result;
+            }
+            Container result = a.kind == Kind::bitmap ? a : b;
+            const Container& array = a.kind == Kind::bitmap ? b : a;
+            std::uint64_t* words = result.words.raw_ptr_begin();
+            for (std::uint16_t v : array.values) {
+                std::uint64_t bit = std::uint64_t(1) << (v % 64);
+                result.cardinality += (words[v / 64] & bit) == 0;
+                words[v / 64] |= bit;
+            }
+            return result;
+        }
+        if (a.kind == Kind::array) {
+            auto result = make_container(Kind::array, 0);
+            for (std::uint16_t v : a.values) {
+                if (!contains(b, v)) {
+                    result.values.push_back(v);
+                }
+            }
+            result.cardinality = static_cast<std::uint32_t>(result.values.size());
+            return result;
+        }
+        Container result = a;
+        std::uint64_t* words = result.words.raw_ptr_begin();
+        for (std::uint16_t v : b.values) {
+            std::uint64_t bit = std::uint64_t(1) << (v % 64);
+            result.cardinality -= (words[v / 64] & bit) != 0;
+            words[v / 64] &= ~bit;
+        }
+        normalize(result);
+        return result;
+    }
+
+    /// Returns the runs of `c`.
+    inline auto runs_of(const Container& c) -> Vec<Run> {
+        if (c.kind == Kind::run) {
+            return c.runs;
+        }
+        auto runs = Vec<Run>();
+        std::int32_t start = -1;
+        std::int32_t prev = -2;
+        for_each(c, [&](std::uint16_t v) {
+            if (v != prev + 1) {
+                if (start >= 0) {
+                    runs.push_back(Run { static_cast<std::uint16_t>(start), static_cast<std::uint16_t>(prev - start) });
+                }
+                start = v;
+            }
+            prev = v;
+        });
+        if (start >= 0) {
+            runs.push_back(Run { static_cast<std::uint16_t>(start), static_cast<std::uint16_t>(prev - start) });
+        }
+        return runs;
+    }
+
+    /// Returns the serialized size of `c` in bytes.
+    inline auto serialized_bytes(const Container& c) -> Size {
+        switch (c.kind) {
+            case Kind::array: return 2 * Size(c.cardinality);
+            case Kind::bitmap: return 8 * bitmap_words;
+            case Kind::run: return 2 + 4 * c.runs.size();
+        }
+        return 0;
+    }
+
+    /// Appends `val` to `out` in little-endian byte order.
+    template <class T>
+    auto put_le(Vec<std::uint8_t>& out, T val) -> void {
+        for (Size i = 0; i < sizeof(T); i++) {
+            out.push_back(static_cast<std::uint8_t>(static_cast<std::uint64_t>(val) >> (8 * i)));
+        }
+    }
+
+    /// Reads a little-endian value from `in` at `at` and advances `at`.
+    /// @throws InvalidArgument if `in` is too short.
+    template <class T>
+    auto get_le(const Vec<std::uint8_t>& in, Size& at) -> T {
+        if (at > in.size() || in.size() - at < sizeof(T)) {
+            throw error::InvalidArgument("truncated roaring bitmap data.");
+        }
+        std::uint64_t val = 0;
+        for (Size i = 0; i < sizeof(T); i++) {
+            val |= std::uint64_t(in.raw_ptr_begin()[at + i]) << (8 * i);
+        }
+        at += sizeof(T);
+        return static_cast<T>(val);
+    }
+}
+
+/// `RoaringBitmap` is a compressed set of 32-bit integers. Values are grouped by their high 16 bits, and the low bits
+/// of each group are kept in whichever container is smallest: a sorted array (up to 4096 values), a 65536-bit bitmap,
+/// or, after `run_optimize`, a list of runs. Set operations combine matching containers pairwise, so they cost time
+/// in proportion to the compressed size rather than the range of values.
+class RoaringBitmap {
+public:
+    using Size = roaring::Size;
+private:
+    static constexpr std::uint32_t cookie_no_runs = 12346;
+    static constexpr std::uint32_t cookie_runs = 12347;
+
+    /// The high 16 bits of each container's values, in ascending order.
+    Vec<std::uint16_t> keys;
+    Vec<roaring::Container> containers;
+    Size count = 0;
+
+    auto position(std::uint16_t key) const -> Size {
+        return static_cast<Size>(std::lower_bound(keys.begin(), keys.end(), key) - keys.begin());
+    }
+
+    auto append(std::uint16_t key, roaring::Container container) -> void {
+        if (container.cardinality == 0) {
+            return;
+        }
+        count += container.cardinality;
+        keys.push_back(key);
+        containers.push_back(std::move(container));
+    }
+
+    static auto combine(const RoaringBitmap& a, const RoaringBitmap& b, roaring::Op op) -> RoaringBitmap {
+        auto result = RoaringBitmap();
+        Size i = 0;
+        Size j = 0;
+        const std::uint16_t* ak = a.keys.raw_ptr_begin();
+        const std::uint16_t* bk = b.keys.raw_ptr_begin();
+        while (i < a.keys.size() || j < b.keys.size()) {
+            if (j == b.keys.size() || (i < a.keys.size() && ak[i] < bk[j])) {
+                if (op != roaring::Op::intersect) {
+                    result.append(ak[i], a.containers.raw_ptr_begin()[i]);
+                }
+                i++;
+            } else if (i == a.keys.size() || bk[j] < ak[i]) {
+                if (op == roaring::Op::unite) {
+                    result.append(bk[j], b.containers.raw_ptr_begin()[j]);
+                }
+                j++;
+            } else {
+                result.append(ak[i], roaring::combine(a.containers.raw_ptr_begin()[i], b.containers.raw_ptr_begin()[j], op));
+                i++;
+                j++;
+            }
+        }
+        return result;
+    }
+public:
+    /// Constructs an empty set.
+    RoaringBitmap() = default;
+
+    /// Constructs a set of the values in `values`, which may be unsorted and repeat.
+    static auto from(const Vec<std::uint32_t>& values) -> RoaringBitmap {
+        auto sorted = Vec<std::uint32_t>::from(values);
+        std::sort(sorted.begin(), sorted.end());
+        const std::uint32_t* data = sorted.raw_ptr_begin();
+        Size n = static_cast<Size>(std::unique(sorted.begin(), sorted.end()) - sorted.begin());
+        auto result = RoaringBitmap();
+        for (Size first = 0; first < n;) {
+            auto key = static_cast<std::uint16_t>(data[first] >> 16);
+            Size last = first;
+            while (last < n && data[last] >> 16 == key) {
+                last++;
+            }
+            auto container = roaring::make_container(roaring::Kind::array, static_cast<std::uint32_t>(last - first));
+            container.values.request_cap(last - first);
+            for (Size i = first; i < last; i++) {
+                container.values.push_back(static_cast<std::uint16_t>(data[i]));
+            }
+            roaring::normalize(container);
+            result.append(key, std::move(container));
+            first = last;
+        }
+        return result;
+    }
+
+    /// Adds `val`; returns if it was absent.
+    auto add(std::uint32_t val) -> bool {
+        auto key = static_cast<std::uint16_t>(val >> 16);
+        Size at = position(key);
+        if (at == keys.size() || keys.raw_ptr_begin()[at] != key) {
+            keys.insert(keys.begin() + static_cast<std::ptrdiff_t>(at), key);
+            containers.insert(containers.begin() + static_cast<std::ptrdiff_t>(at), roaring::Container());
+        }
+        bool added = roaring::add(containers.raw_ptr_begin()[at], static_cast<std::uint16_t>(val));
+        count += added;
+        return added;
+    }
+
+    /// Removes `val`; returns if it was present.
+    auto remove(std::uint32_t val) -> bool {
+        auto key = static_cast<std::uint16_t>(val >> 16);
+        Size at = position(key);
+        if (at == keys.size() || keys.raw_ptr_begin()[at] != key) {
+            return false;
+        }
+        roaring::Container& container = containers.raw_ptr_begin()[at];
+        bool removed = roaring::remove(container, static_cast<std::uint16_t>(val));
+        count -= removed;
+        if (container.cardinality == 0) {
+            keys.remove(keys.begin() + static_cast<std::ptrdiff_t>(at));
+            containers.remove(containers.begin() + static_cast<std::ptrdiff_t>(at));
+        }
+        return removed;
+    }
+
+    /// Returns if `val` is in the set.
+    auto contains(std::uint32_t val) const -> bool {
+        auto key = static_cast<std::uint16_t>(val >> 16);
+        Size at = position(key);
+        return at != keys.size() && keys.raw_ptr_begin()[at] == key
+            && roaring::contains(containers.raw_ptr_begin()[at], static_cast<std::uint16_t>(val));
+    }
+
+    /// Returns the number of values in the set, in constant time.
+    auto cardinality() const -> Size {
+        return count;
+    }
+
+    /// Returns if the set is empty.
+    [[nodiscard]]
+    auto is_empty() const -> bool {
+        return count == 0;
+    }
+
+    /// Calls `fn(val)` for every value in ascending order.
+    template <class Fn>
+    auto for_each(Fn fn) const -> void {
+        for (Size i = 0; i < keys.size(); i++) {
+            std::uint32_t high = std::uint32_t(keys.raw_ptr_begin()[i]) << 16;
+            roaring::for_each(containers.raw_ptr_begin()[i], [&](std::uint16_t low) { fn(high | low); });
+        }
+    }
+
+    /// Returns the values in ascending order.
+    auto to_vec() const -> Vec<std::uint32_t> {
+        auto result = Vec<std::uint32_t>();
+        result.request_cap(count);
+        for_each([&result](std::uint32_t val) { result.push_back(val); });
+        return result;
+    }
+
+    /// Converts each container to a run container where that is smaller. Later insertions and removals convert
+    /// affected containers back.
+    auto run_optimize() -> void {
+        for (roaring::Container& c : containers) {
+            roaring::Container expanded;
+            const roaring::Container& plain = roaring::natural_view(c, expanded);
+            if (c.kind == roaring::Kind::run) {
+                if (roaring::serialized_bytes(c) >= roaring::serialized_bytes(plain)) {
+                    c = std::move(expanded);
+                }
+                continue;
+            }
+            auto runs = roaring::runs_of(c);
+            if (2 + 4 * runs.size() < roaring::serialized_bytes(plain)) {
+                c = roaring::make_container(roaring::Kind::run, c.cardinality);
+                c.runs = std::move(runs);
+            }
+        }
+    }
+
+    /// Returns the union of `a` and `b`.
+    friend auto operator|(const RoaringBitmap& a, const RoaringBitmap& b) -> RoaringBitmap {
+        return combine(a, b, roaring::Op::unite);
+    }
+
+    /// Returns the intersection of `a` and `b`.
+    friend auto operator&(const RoaringBitmap& a, const RoaringBitmap& b) -> RoaringBitmap {
+        return combine(a, b, roaring::Op::intersect);
+    }
+
+    /// Returns the values of `a` that are not in `b`.
+    friend auto operator-(const RoaringBitmap& a, const RoaringBitmap& b) -> RoaringBitmap {
+        return combine(a, b, roaring::Op::subtract);
+    }
+
+    /// Returns if `a` and `b` hold the same values.
+    friend auto operator==(const RoaringBitmap& a, const RoaringBitmap& b) -> bool {
+        return a.count == b.count && (a - b).is_empty();
+    }
+
+    /// Returns the set in the portable Roaring format shared by the reference implementations (little-endian; see
+    /// RoaringFormatSpec), so it can be read by other Roaring libraries.
+    auto serialize() const -> Vec<std::uint8_t> {
+        auto out = Vec<std::uint8_t>();
+        Size n = keys.size();
+        bool has_runs = std::any_of(containers.begin(), containers.end(),
+                                    [](const roaring::Container& c) { return c.kind == roaring::Kind::run; });
+        bool has_offsets = !has_runs || n >= 4;
+        Size header = has_runs ? 4 + (n + 7) / 8 : 8;
+        header += 4 * n + (has_offsets ? 4 * n : 0);
+        if (has_runs) {
+            roaring::put_le(out, static_cast<std::uint32_t>(cookie_runs | ((n - 1) << 16)));
+            auto flags = Vec<std::uint8_t>::of((n + 7) / 8);
+            for (Size i = 0; i < n; i++) {
+                if (containers.raw_ptr_begin()[i].kind == roaring::Kind::run) {
+                    flags.raw_ptr_begin()[i / 8] |= static_cast<std::uint8_t>(1 << (i % 8));
+                }
+            }
+            out.insert_range(out.end(), flags.begin(), flags.end());
+        } else {
+            roaring::put_le(out, cookie_no_runs);
+            roaring::put_le(out, static_cast<std::uint32_t>(n));
+        }
+        for (Size i = 0; i < n; i++) {
+            roaring::put_le(out, keys.raw_ptr_begin()[i]);
+            roaring::put_le(out, static_cast<std::uint16_t>(containers.raw_ptr_begin()[i].cardinality - 1));
+        }
+        if (has_offsets) {
+            Size offset = header;
+            for (const roaring::Container& c : containers) {
+                roaring::put_le(out, static_cast<std::uint32_t>(offset));
+                offset += roaring::serialized_bytes(c);
+            }
+        }
+        for (const roaring::Container& c : containers) {
+            switch (c.kind) {
+                case roaring::Kind::array:
+                    for (std::uint16_t v : c.values) {
+                        roaring::put_le(out, v);
+                    }
+                    break;
+                case roaring::Kind::bitmap:
+                    for (std::uint64_t w : c.words) {
+                        roaring::put_le(out, w);
+                    }
+                    break;
+                case roaring::Kind::run:
+                    roaring::put_le(out, static_cast<std::uint16_t>(c.runs.size()));
+                    for (const roaring::Run& run : c.runs) {
+                        roaring::put_le(out, run.start);
+                        roaring::put_le(out, run.length);
+                    }
+                    break;
+            }
+        }
+        return out;
+    }
+
+    /// Reads back a set in the portable Roaring format.
+    /// @throws InvalidArgument if `bytes` is not a valid serialized set.
+    static auto deserialize(const Vec<std::uint8_t>& bytes) -> RoaringBitmap {
+        Size at = 0;
+        auto cookie = roaring::get_le<std::uint32_t>(bytes, at);
+        bool has_runs = (cookie & 0xFFFF) == cookie_runs;
+        Size n;
+        auto flags = Vec<std::uint8_t>();
+        if (has_runs) {
+            n = (cookie >> 16) + 1;
+            for (Size i = 0; i < (n + 7) / 8; i++) {
+                flags.push_back(roaring::get_le<std::uint8_t>(bytes, at));
+            }
+        } else if (cookie == cookie_no_runs) {
+            n = roaring::get_le<std::uint32_t>(bytes, at);
+            if (n > 65536) {
+                throw error::InvalidArgument("too many containers in roaring bitmap data.");
+            }
+        } else {
+            throw error::InvalidArgument("not a serialized roaring bitmap.");
+        }
+        auto headers = Vec<std::uint32_t>();
+        auto result = RoaringBitmap();
+        for (Size i = 0; i < n; i++) {
+            auto key = roaring::get_le<std::uint16_t>(bytes, at);
+            if (i > 0 && key <= result.keys.raw_ptr_begin()[i - 1]) {
+                throw error::InvalidArgument("roaring bitmap keys are not increasing.");
+            }
+            result.keys.push_back(key);
+            headers.push_back(std::uint32_t(roaring::get_le<std::uint16_t>(bytes, at)) + 1);
+        }
+        if (!has_runs || n >= 4) {
+            at += 4 * n;
+        }
+        for (Size i = 0; i < n; i++) {
+            auto c = roaring::Container();
+            std::uint32_t cardinality = headers.raw_ptr_begin()[i];
+            bool is_run = has_runs && (flags.raw_ptr_begin()[i / 8] >> (i % 8)) & 1;
+            if (is_run) {
+                c.kind = roaring::Kind::run;
+                auto runs = roaring::get_le<std::uint16_t>(bytes, at);
+                std::int64_t next = 0;
+                for (Size r = 0; r < runs; r++) {
+                    auto start = roaring::get_le<std::uint16_t>(bytes, at);
+                    auto length = roaring::get_le<std::uint16_t>(bytes, at);
+                    if (start < next || std::uint32_t(start) + length > 0xFFFF) {
+                        throw error::InvalidArgument("malformed roaring run container.");
+                    }
+                    c.runs.push_back(roaring::Run { start, length });
+                    c.cardinality += std::uint32_t(length) + 1;
+                    next = std::int64_t(start) + length + 1;
+                }
+            } else if (cardinality <= roaring::array_limit) {
+                c.kind = roaring::Kind::array;
+                for (Size k = 0; k < cardinality; k++) {
+                    auto v = roaring::get_le<std::uint16_t>(bytes, at);
+                    if (k > 0 && v <= c.values.raw_ptr_begin()[k - 1]) {
+                        throw error::InvalidArgument("malformed roaring array container.");
+                    }
+                    c.values.push_back(v);
+                }
+                c.cardinality = cardinality;
+            } else {
+                c.kind = roaring::Kind::bitmap;
+                c.words.request_cap(roaring::bitmap_words);
+                for (Size k = 0; k < roaring::bitmap_words; k++) {
+                    auto w = roaring::get_le<std::uint64_t>(bytes, at);
+                    c.words.push_back(w);
+                    c.cardinality += static_cast<std::uint32_t>(std::popcount(w));
+                }
+            }
+            if (c.cardinality != cardinality) {
+                throw error::InvalidArgument("roaring container cardinality does not match its header.");
+            }
+            result.count += c.cardinality;
+            result.containers.push_back(std::move(c));
+        }
+        if (at != bytes.size()) {
+            throw error::InvalidArgument("trailing bytes after roaring bitmap.");
+        }
+        return result;
+    }
+};
+
+#endif //TOOLS_ROARING_BITMAP_H
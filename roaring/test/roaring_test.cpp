@@ -0,0 +1,40 @@
+#include <cstdint>
+#include <iostream>
+
+#include "../roaring_bitmap.h"
+
+auto test() -> int {
+    // Evens below 20000 (bitmap containers) and a dense block of 100000 values (runs after optimizing).
+    auto evens = Vec<std::uint32_t>();
+    for (std::uint32_t i = 0; i < 20'000; i += 2) {
+        evens.push_back(i);
+    }
+    auto a = RoaringBitmap::from(evens);
+    auto b = RoaringBitmap();
+    for (std::uint32_t i = 10'000; i < 110'000; i++) {
+        b.add(i);
+    }
+    b.add(4'000'000'000u);
+    b.run_optimize();
+
+    auto both = a & b;
+    auto either = a | b;
+    auto only_a = a - b;
+    // |a & b| = 5000, |a | b| = 105001, |a - b| = 5000
+    std::cout << "|a & b| = " << both.cardinality() << ", |a | b| = " << either.cardinality() << ", |a - b| = "
+              << only_a.cardinality() << '\n';
+    if (both.cardinality() != 5'000 || either.cardinality() != 105'001 || only_a.cardinality() != 5'000) {
+        return 1;
+    }
+    if (!either.contains(4'000'000'000u) || either.contains(1) || only_a.to_vec().at(4'999) != 9'998) {
+        return 1;
+    }
+    auto restored = RoaringBitmap::deserialize(b.serialize());
+    // serialized b: 31 bytes
+    std::cout << "serialized b: " << b.serialize().size() << " bytes\n";
+    return restored == b && restored.cardinality() == 100'001 ? 0 : 1;
+}
+
+auto main() -> int {
+    return test();
+}
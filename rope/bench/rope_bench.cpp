@@ -0,0 +1,78 @@
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#include "../rope.h"
+#include "../../bench/bench.h"
+
+// Random edits on documents of 1 to 64 MiB: a Rope against a Vec, which moves the tail of the buffer on every edit.
+
+constexpr bench::Size edits = 2'000;
+constexpr bench::Size edit_length = 16;
+
+auto main() -> int {
+    std::cout << std::fixed << std::setprecision(3);
+    auto text = Vec<char>();
+    for (bench::Size i = 0; i < edit_length; i++) {
+        text.push_back(static_cast<char>('a' + i));
+    }
+    for (bench::Size mib : { 1, 4, 16, 64 }) {
+        bench::Size length = mib << 20;
+        auto document = Vec<char>::of(length, 'x');
+        auto positions = Vec<bench::Size>();
+        auto rng = std::mt19937_64(mib);
+        for (bench::Size i = 0; i < edits; i++) {
+            positions.push_back(rng() % (length - edit_length));
+        }
+
+        // Each edit inserts a short run of text and removes one of the same length elsewhere.
+        double vec_time = bench::seconds([&] {
+            auto vec = Vec<char>::from(document);
+            for (bench::Size i = 0; i < edits; i++) {
+                bench::Size at = positions.raw_ptr_begin()[i];
+                vec.insert_range(vec.begin() + static_cast<std::ptrdiff_t>(at), text.begin(), text.end());
+                auto from = vec.begin() + static_cast<std::ptrdiff_t>(positions.raw_ptr_begin()[edits - 1 - i]);
+                vec.remove_range(from, from + edit_length);
+            }
+            bench::keep(vec.size());
+        }, 1);
+        auto initial = Rope<char>::from(document);
+        double rope_time = bench::seconds([&] {
+            auto rope = initial;
+            for (bench::Size i = 0; i < edits; i++) {
+                bench::Size at = positions.raw_ptr_begin()[i];
+                rope.insert_range(at, text.raw_ptr_begin(), text.raw_ptr_begin() + edit_length);
+                bench::Size from = positions.raw_ptr_begin()[edits - 1 - i];
+                rope.remove_range(from, from + edit_length);
+            }
+            bench::keep(rope.size());
+        });
+
+        // Reading: random access and a full scan, where the Vec's single buffer has the advantage.
+        std::uint64_t sum = 0;
+        double at_time = bench::seconds([&] {
+            for (bench::Size i = 0; i < edits; i++) {
+                sum += static_cast<std::uint64_t>(initial.at(positions.raw_ptr_begin()[i]));
+            }
+        });
+        double scan_time = bench::seconds([&] {
+            initial.for_each_chunk([&](const char* chunk, bench::Size n) {
+                for (bench::Size i = 0; i < n; i++) {
+                    sum += static_cast<std::uint64_t>(chunk[i]);
+                }
+            });
+        });
+        double vec_scan_time = bench::seconds([&] {
+            for (char c : document) {
+                sum += static_cast<std::uint64_t>(c);
+            }
+        });
+        bench::keep(sum);
+        std::cout << mib << " MiB: " << edits << " edits in " << vec_time * 1e3 << " ms with Vec, "
+                  << rope_time * 1e3 << " ms with Rope (" << vec_time / rope_time << "x); Rope::at "
+                  << at_time / static_cast<double>(edits) * 1e9 << " ns; scan " << scan_time * 1e3
+                  << " ms with Rope, " << vec_scan_time * 1e3 << " ms with Vec\n";
+    }
+    return 0;
+}
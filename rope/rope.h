@@ -0,0 +1,325 @@
+#ifndef TOOLS_ROPE_H
+#define TOOLS_ROPE_H
+
+#include <algorithm>
+#include <memory>
+#include <ostream>
+#include <utility>
+
+#include "../vec/vec.h"
+
+/// `Rope` is a sequence stored as a balanced tree of `Vec` chunks. Inserting, removing, splitting and concatenating
+/// cost O(log n) plus the size of one chunk, instead of moving every element after the edit. Nodes are immutable and
+/// shared between ropes, so copying a rope is O(1) and an edit only copies the path to the changed chunk.
+template <class T>
+class Rope {
+public:
+    using Size = typename Vec<T>::Size;
+private:
+    /// The largest number of elements stored in one chunk.
+    static constexpr Size max_chunk = std::max<Size>(16, 4096 / sizeof(T));
+
+    struct Node;
+    using Link = std::shared_ptr<const Node>;
+
+    /// A leaf holds a chunk of elements; an inner node holds two non-null children and no elements.
+    struct Node {
+        Link left;
+        Link right;
+        Vec<T> chunk;
+        Size length;
+        int height;
+
+        auto is_leaf() const -> bool {
+            return left == nullptr;
+        }
+    };
+
+    Link root;
+
+    static auto length_of(const Link& node) -> Size {
+        return node ? node->length : 0;
+    }
+
+    static auto height_of(const Link& node) -> int {
+        return node ? node->height : 0;
+    }
+
+    static auto leaf(Vec<T> chunk) -> Link {
+        if (chunk.is_empty()) {
+            return nullptr;
+        }
+        Size length = chunk.size();
+        return std::make_shared<const Node>(Node { nullptr, nullptr, std::move(chunk), length, 1 });
+    }
+
+    static auto leaf(const T* first, const T* last) -> Link {
+        return leaf(Vec<T>::from(first, last));
+    }
+
+    static auto node(Link left, Link right) -> Link {
+        Size length = left->length + right->length;
+        int height = std::max(left->height, right->height) + 1;
+        return std::make_shared<const Node>(Node { std::move(left), std::move(right), Vec<T>(), length, height });
+    }
+
+    /// Builds the node joining `left` and `right`, whose heights differ by at most two, rotating to restore
+    /// balance.
+    static auto balance(const Link& left, const Link& right) -> Link {
+        if (left->height > right->height + 1) {
+            if (height_of(left->left) >= height_of(left->right)) {
+                return node(left->left, node(left->right, right));
+            }
+            const Link& mid = left->right;
+            return node(node(left->left, mid->left), node(mid->right, right));
+        }
+        if (right->height > left->height + 1) {
+            if (height_of(right->right) >= height_of(right->left)) {
+                return node(node(left, right->left), right->right);
+            }
+            const Link& mid = right->left;
+            return node(node(left, mid->left), node(mid->right, right->right));
+        }
+        return node(left, right);
+    }
+
+    /// Concatenates two trees, descending the taller one so that the result stays balanced. Adjacent leaves that
+    /// fit in one chunk are merged.
+    static auto join(const Link& left, const Link& right) -> Link {
+        if (!left) {
+            return right;
+        }
+        if (!right) {
+            return left;
+        }
+        if (left->is_leaf() && right->is_leaf() && left->length + right->length <= max_chunk) {
+            auto chunk = Vec<T>::from(left->chunk);
+            chunk.insert_range(chunk.end(), right->chunk.begin(), right->chunk.end());
+            return leaf(std::move(chunk));
+        }
+        if (left->height > right->height + 1) {
+            return balance(left->left, join(left->right, right));
+        }
+        if (right->height > left->height + 1) {
+            return balance(join(left, right->left), right->right);
+        }
+        return node(left, right);
+    }
+
+    /// Splits a tree into its first `at` elements and the rest.
+    static auto split(const Link& tree, Size at) -> std::pair<Link, Link> {
+        if (!tree) {
+            return { nullptr, nullptr };
+        }
+        if (at == 0) {
+            return { nullptr, tree };
+        }
+        if (at >= tree->length) {
+            return { tree, nullptr };
+        }
+        if (tree->is_leaf()) {
+            const T* data = tree->chunk.raw_ptr_begin();
+            return { leaf(data, data + at), leaf(data + at, data + tree->length) };
+        }
+        if (at <= tree->left->length) {
+            auto [first, rest] = split(tree->left, at);
+            return { first, join(rest, tree->right) };
+        }
+        auto [first, rest] = split(tree->right, at - tree->left->length);
+        return { join(tree->left, first), rest };
+    }
+
+    /// Inserts `count` elements starting at `values` into position `at` of a non-empty tree, copying only the path
+    /// to the affected leaf. `count` must not exceed `max_chunk`.
+    static auto insert_into(const Link& tree, Size at, const T* values, Size count) -> Link {
+        if (tree->is_leaf()) {
+            auto chunk = Vec<T>();
+            chunk.request_cap(tree->length + count);
+            const T* data = tree->chunk.raw_ptr_begin();
+            chunk.insert_range(chunk.end(), data, data + at);
+            chunk.insert_range(chunk.end(), values, values + count);
+            chunk.insert_range(chunk.end(), data + at, data + tree->length);
+            if (chunk.size() <= max_chunk) {
+                return leaf(std::move(chunk));
+            }
+            const T* merged = chunk.raw_ptr_begin();
+            Size half = chunk.size() / 2;
+            return node(leaf(merged, merged + half), leaf(merged + half, merged + chunk.size()));
+        }
+        if (at <= tree->left->length) {
+            return balance(insert_into(tree->left, at, values, count), tree->right);
+        }
+        return balance(tree->left, insert_into(tree->right, at - tree->left->length, values, count));
+    }
+
+    /// Builds a balanced tree over the chunks [first, last).
+    static auto build(const Vec<Link>& chunks, Size first, Size last) -> Link {
+        if (last - first == 1) {
+            return chunks.raw_ptr_begin()[first];
+        }
+        Size mid = first + (last - first) / 2;
+        return node(build(chunks, first, mid), build(chunks, mid, last));
+    }
+
+    explicit Rope(Link tree) : root(std::move(tree)) {}
+public:
+    /// Constructs an empty rope.
+    Rope() = default;
+
+    /// Constructs a rope holding a copy of each of the elements in `vec`, in the same order.
+    static auto from(const Vec<T>& vec) -> Rope<T> {
+        if (vec.is_empty()) {
+            return Rope<T>();
+        }
+        const T* data = vec.raw_ptr_begin();
+        Size chunk_count = (vec.size() + max_chunk - 1) / max_chunk;
+        auto chunks = Vec<Link>();
+        chunks.request_cap(chunk_count);
+        for (Size i = 0; i < chunk_count; i++) {
+            Size first = vec.size() * i / chunk_count;
+            Size last = vec.size() * (i + 1) / chunk_count;
+            chunks.push_back(leaf(data + first, data + last));
+        }
+        return Rope<T>(build(chunks, 0, chunk_count));
+    }
+
+    /// Returns the element at position `i`.
+    /// @throws IndexOutOfBounds if attempting to access an element at an invalid index.
+    auto at(Size i) const -> const T& {
+        if (i >= size()) {
+            throw error::IndexOutOfBounds("index too large for rope.");
+        }
+        const Node* node = root.get();
+        while (!node->is_leaf()) {
+            if (i < node->left->length) {
+                node = node->left.get();
+            } else {
+                i -= node->left->length;
+                node = node->right.get();
+            }
+        }
+        return node->chunk.raw_ptr_begin()[i];
+    }
+
+    /// Inserts a copy of `val` into position `at`.
+    /// @throws IndexOutOfBounds if `at` is past the end of the rope.
+    auto insert(Size at, const T& val) -> void {
+        insert_range(at, &val, &val + 1);
+    }
+
+    /// Inserts a copy of the elements in [`first`, `last`) into position `at`.
+    /// @throws IndexOutOfBounds if `at` is past the end of the rope.
+    auto insert_range(Size at, const T* first, const T* last) -> void {
+        if (at > size()) {
+            throw error::IndexOutOfBounds("insertion position past the end of rope.");
+        }
+        Size count = static_cast<Size>(last - first);
+        if (count == 0) {
+            return;
+        }
+        if (!root) {
+            root = from(Vec<T>::from(first, last)).root;
+        } else if (count <= max_chunk) {
+            root = insert_into(root, at, first, count);
+        } else {
+            auto [head, tail] = split(root, at);
+            root = join(join(head, from(Vec<T>::from(first, last)).root), tail);
+        }
+    }
+
+    /// Inserts the elements of `other` into position `at`, sharing its chunks.
+    /// @throws IndexOutOfBounds if `at` is past the end of the rope.
+    auto insert_rope(Size at, const Rope<T>& other) -> void {
+        if (at > size()) {
+            throw error::IndexOutOfBounds("insertion position past the end of rope.");
+        }
+        auto [head, tail] = split(root, at);
+        root = join(join(head, other.root), tail);
+    }
+
+    /// Removes the elements in positions [`first`, `last`).
+    /// @throws IndexOutOfBounds if the range is not within the rope.
+    auto remove_range(Size first, Size last) -> void {
+        if (first > last || last > size()) {
+            throw error::IndexOutOfBounds("invalid range for rope.");
+        }
+        auto [head, rest] = split(root, first);
+        root = join(head, split(rest, last - first).second);
+    }
+
+    /// Appends the elements of `other`, sharing its chunks.
+    auto concat(const Rope<T>& other) -> void {
+        root = join(root, other.root);
+    }
+
+    /// Splits the rope at position `at`, keeping the first `at` elements and returning the rest.
+    /// @throws IndexOutOfBounds if `at` is past the end of the rope.
+    auto split_off(Size at) -> Rope<T> {
+        if (at > size()) {
+            throw error::IndexOutOfBounds("split position past the end of rope.");
+        }
+        auto [head, tail] = split(root, at);
+        root = std::move(head);
+        return Rope<T>(std::move(tail));
+    }
+
+    /// Returns a rope holding the elements in positions [`first`, `last`), sharing chunks with this rope.
+    /// @throws IndexOutOfBounds if the range is not within the rope.
+    auto slice(Size first, Size last) const -> Rope<T> {
+        if (first > last || last > size()) {
+            throw error::IndexOutOfBounds("invalid range for rope.");
+        }
+        return Rope<T>(split(split(root, last).first, first).second);
+    }
+
+    /// Calls `fn(data, count)` for each chunk of contiguous elements, in order.
+    template <class Fn>
+    auto for_each_chunk(Fn fn) const -> void {
+        if (!root) {
+            return;
+        }
+        auto stack = Vec<const Node*> { root.get() };
+        while (!stack.is_empty()) {
+            const Node* node = *stack.pop_back();
+            if (node->is_leaf()) {
+                fn(node->chunk.raw_ptr_begin(), node->length);
+            } else {
+                stack.push_back(node->right.get());
+                stack.push_back(node->left.get());
+            }
+        }
+    }
+
+    /// Returns the elements of the rope as a contiguous `Vec`.
+    auto to_vec() const -> Vec<T> {
+        auto result = Vec<T>();
+        result.request_cap(size());
+        for_each_chunk([&result](const T* data, Size count) {
+            result.insert_range(result.end(), data, data + count);
+        });
+        return result;
+    }
+
+    /// Removes all elements.
+    auto clear() -> void {
+        root = nullptr;
+    }
+
+    /// Returns if the rope is empty.
+    [[nodiscard]]
+    auto is_empty() const -> bool {
+        return root == nullptr;
+    }
+
+    /// Returns the number of elements.
+    auto size() const -> Size {
+        return length_of(root);
+    }
+
+    /// Send the contents of the rope as a string to std::ostream.
+    friend auto operator<<(std::ostream& os, const Rope<T>& rope) -> std::ostream& {
+        return os << rope.to_vec();
+    }
+};
+
+#endif //TOOLS_ROPE_H
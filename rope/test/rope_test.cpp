@@ -0,0 +1,27 @@
+#include <iostream>
+
+#include "../rope.h"
+
+auto test() -> int {
+    auto rope = Rope<char>::from(Vec<char> { 'h', 'e', 'l', 'o' });
+    rope.insert(2, 'l');
+    auto copy = rope;
+    auto tail = Rope<char>::from(Vec<char> { '!', '!' });
+    rope.concat(tail);
+    rope.remove_range(0, 1);
+    // [e, l, l, o, !, !]
+    std::cout << rope << '\n';
+    // [h, e, l, l, o]
+    std::cout << copy << '\n';
+    auto rest = rope.split_off(4);
+    if (rope.size() != 4 || rest.size() != 2 || rope.at(3) != 'o' || copy.at(0) != 'h') {
+        return 1;
+    }
+    auto big = Rope<int>::from(Vec<int>::of(100000, 7));
+    big.insert(50000, 1);
+    return big.at(50000) == 1 && big.slice(49999, 50002).to_vec().size() == 3 ? 0 : 1;
+}
+
+auto main() -> int {
+    return test();
+}
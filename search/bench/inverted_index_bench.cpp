@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../inverted_index.h"
+#include "../../bench/bench.h"
+#include "../../parallel/parallel.h"
+
+// Build throughput and AND/OR query latency of InvertedIndex on a synthetic corpus with Zipfian word frequencies,
+// against the `std::map<std::string, std::vector<int>>` index it replaces.
+
+constexpr bench::Size document_count = 200'000;
+constexpr bench::Size vocabulary = 100'000;
+constexpr bench::Size queries = 2'000;
+
+using MapIndex = std::map<std::string, std::vector<int>>;
+
+/// Builds the baseline index: one growing vector per term, skipping repeats of a term within a document.
+auto build_map(const Vec<std::string>& documents) -> MapIndex {
+    auto index = MapIndex();
+    for (bench::Size d = 0; d < documents.size(); d++) {
+        search::for_each_term(documents.raw_ptr_begin()[d], [&](std::string_view term) {
+            auto& list = index[std::string(term)];
+            if (list.empty() || list.back() != static_cast<int>(d)) {
+                list.push_back(static_cast<int>(d));
+            }
+        });
+    }
+    return index;
+}
+
+/// Returns the posting list of `term`, or an empty list if it never occurs.
+auto map_postings(const MapIndex& index, const std::string& term) -> const std::vector<int>& {
+    static const auto none = std::vector<int>();
+    auto it = index.find(term);
+    return it != index.end() ? it->second : none;
+}
+
+auto map_all_of(const MapIndex& index, const Vec<std::string>& query) -> std::vector<int> {
+    auto result = map_postings(index, query.raw_ptr_begin()[0]);
+    for (bench::Size i = 1; i < query.size(); i++) {
+        const auto& list = map_postings(index, query.raw_ptr_begin()[i]);
+        auto next = std::vector<int>();
+        std::set_intersection(result.begin(), result.end(), list.begin(), list.end(), std::back_inserter(next));
+        result = std::move(next);
+    }
+    return result;
+}
+
+auto map_any_of(const MapIndex& index, const Vec<std::string>& query) -> std::vector<int> {
+    auto result = std::vector<int>();
+    for (const std::string& term : query) {
+        const auto& list = map_postings(index, term);
+        auto next = std::vector<int>();
+        std::set_union(result.begin(), result.end(), list.begin(), list.end(), std::back_inserter(next));
+        result = std::move(next);
+    }
+    return result;
+}
+
+auto main() -> int {
+    std::cout << std::fixed << std::setprecision(2);
+    auto rng = std::mt19937_64(17);
+    auto words = Vec<std::string>();
+    for (bench::Size i = 0; i < vocabulary; i++) {
+        auto word = std::string();
+        for (bench::Size length = 3 + rng() % 8; word.size() < length;) {
+            word.push_back(static_cast<char>('a' + rng() % 26));
+        }
+        words.push_back(word + std::to_string(i));
+    }
+    auto zipf = bench::Zipf(vocabulary, 1.0);
+    auto documents = Vec<std::string>();
+    bench::Size tokens = 0;
+    for (bench::Size d = 0; d < document_count; d++) {
+        auto text = std::string();
+        bench::Size length = 50 + rng() % 200;
+        for (bench::Size i = 0; i < length; i++) {
+            text += words.raw_ptr_begin()[zipf(rng)];
+            text += i % 12 == 11 ? ". " : " ";
+        }
+        tokens += length;
+        documents.push_back(std::move(text));
+    }
+
+    bench::Size threads = parallel::hardware_threads();
+    auto index = InvertedIndex();
+    double build_one = bench::seconds([&] { index = InvertedIndex::build(documents, 1); }, 1);
+    double build_all = bench::seconds([&] { index = InvertedIndex::build(documents, threads); }, 1);
+    auto map = MapIndex();
+    double build_map_time = bench::seconds([&] { map = build_map(documents); }, 1);
+    bench::Size map_bytes = 0;
+    for (const auto& [term, list] : map) {
+        map_bytes += list.size() * sizeof(int);
+    }
+    auto mtokens = [&](double time) {
+        return static_cast<double>(tokens) / time / 1e6;
+    };
+    std::cout << document_count << " documents, " << tokens << " terms, " << index.term_count()
+              << " distinct: build " << mtokens(build_one) << " M terms/s on 1 thread, " << mtokens(build_all)
+              << " M terms/s on " << threads << " thread(s), " << mtokens(build_map_time)
+              << " M terms/s std::map; postings " << static_cast<double>(index.postings_bytes()) / (1 << 20)
+              << " MiB against " << static_cast<double>(map_bytes) / (1 << 20) << " MiB of std::vector<int>\n";
+
+    // Query terms come from three frequency bands: common (ranks up to 100), medium (up to 10,000) and rare.
+    auto band = [&](bench::Size first, bench::Size last) {
+        return words.raw_ptr_begin()[first + rng() % (last - first)];
+    };
+    auto make_queries = [&](auto pick) {
+        auto result = Vec<Vec<std::string>>();
+        for (bench::Size i = 0; i < queries; i++) {
+            result.push_back(pick());
+        }
+        return result;
+    };
+    auto common_pairs = make_queries([&] { return Vec<std::string> { band(0, 100), band(0, 100) }; });
+    auto common_rare = make_queries([&] { return Vec<std::string> { band(0, 100), band(10'000, vocabulary) }; });
+    auto triples = make_queries([&] {
+        return Vec<std::string> { band(0, 100), band(100, 10'000), band(100, 10'000) };
+    });
+    auto us = [](double time) {
+        return time / static_cast<double>(queries) * 1e6;
+    };
+    auto report = [&](const char* name, const Vec<Vec<std::string>>& set) {
+        bench::Size matches = 0;
+        bool agree = true;
+        for (const auto& query : set) {
+            auto found = index.all_of(query);
+            auto expected = map_all_of(map, query);
+            matches += found.size();
+            agree &= std::equal(found.begin(), found.end(), expected.begin(), expected.end(),
+                                [](search::DocId a, int b) { return a == static_cast<search::DocId>(b); });
+            agree &= index.any_of(query).size() == map_any_of(map, query).size();
+        }
+        double all = bench::seconds([&] {
+            for (const auto& query : set) {
+                bench::keep(index.all_of(query));
+            }
+        });
+        double map_all = bench::seconds([&] {
+            for (const auto& query : set) {
+                bench::keep(map_all_of(map, query));
+            }
+        });
+        double any = bench::seconds([&] {
+            for (const auto& query : set) {
+                bench::keep(index.any_of(query));
+            }
+        });
+        double map_any = bench::seconds([&] {
+            for (const auto& query : set) {
+                bench::keep(map_any_of(map, query));
+            }
+        });
+        std::cout << name << " (" << matches / queries << " AND matches on average): AND " << us(all)
+                  << " us InvertedIndex, " << us(map_all) << " us std::map; OR " << us(any) << " us InvertedIndex, "
+                  << us(map_any) << " us std::map" << (agree ? "" : "; RESULTS DIFFER") << '\n';
+    };
+    report("common + common", common_pairs);
+    report("common + rare", common_rare);
+    report("common + medium + medium", triples);
+    return 0;
+}
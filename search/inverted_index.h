@@ -0,0 +1,437 @@
+#ifndef TOOLS_INVERTED_INDEX_H
+#define TOOLS_INVERTED_INDEX_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "../parallel/parallel.h"
+#include "../vec/vec.h"
+
+namespace search {
+    using Size = std::size_t;
+    using DocId = std::uint32_t;
+
+    /// Postings are packed in blocks of this many document ids.
+    constexpr Size block_size = 128;
+
+    /// Calls `fn(term)` for every term of `text`: each maximal run of ASCII letters and digits, lower-cased. `term`
+    /// refers to a buffer that is reused between calls.
+    template <class Fn>
+    auto for_each_term(std::string_view text, Fn fn) -> void {
+        std::string term;
+        for (Size i = 0; i <= text.size(); i++) {
+            auto c = i < text.size() ? static_cast<unsigned char>(text[i]) : ' ';
+            bool word = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+            if (word) {
+                term.push_back(static_cast<char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c));
+            } else if (!term.empty()) {
+                fn(std::string_view(term));
+                term.clear();
+            }
+        }
+    }
+
+    /// Returns the terms of `text` (see `for_each_term`).
+    inline auto tokenize(std::string_view text) -> Vec<std::string> {
+        auto terms = Vec<std::string>();
+        for_each_term(text, [&terms](std::string_view term) { terms.push_back(std::string(term)); });
+        return terms;
+    }
+
+    /// A block of up to `block_size` postings: the gaps between consecutive ids, less one, packed at `bits` bits each
+    /// from word `offset`. `last` is the block's largest id and serves as its skip pointer.
+    struct Block {
+        DocId last;
+        std::uint32_t offset;
+        std::uint8_t bits;
+        std::uint8_t count;
+    };
+
+    /// Packs `n` values of `bits` bits each into `out`, which must be zeroed and hold `(n * bits + 31) / 32` words.
+    inline auto pack(const std::uint32_t* values, Size n, unsigned bits, std::uint32_t* out) -> void {
+        if (bits == 0) {
+            return;
+        }
+        for (Size i = 0; i < n; i++) {
+            Size bit = i * bits;
+            out[bit / 32] |= values[i] << (bit % 32);
+            if (bit % 32 + bits > 32) {
+                out[bit / 32 + 1] |= values[i] >> (32 - bit % 32);
+            }
+        }
+    }
+
+    /// Unpacks `n` values of `bits` bits each from `in`, which may be read one word past the packed values.
+    inline auto unpack(const std::uint32_t* in, Size n, unsigned bits, std::uint32_t* values) -> void {
+        // A block of zero-width gaps packs no words, so its offset may be the end of the packed values.
+        if (bits == 0) {
+            std::fill(values, values + n, 0);
+            return;
+        }
+        std::uint64_t mask = (std::uint64_t(1) << bits) - 1;
+        for (Size i = 0; i < n; i++) {
+            Size bit = i * bits;
+            std::uint64_t pair = in[bit / 32] | (std::uint64_t(in[bit / 32 + 1]) << 32);
+            values[i] = static_cast<std::uint32_t>((pair >> (bit % 32)) & mask);
+        }
+    }
+}
+
+/// `InvertedIndex` maps each term of a document collection to the ascending ids of the documents containing it.
+/// Posting lists are delta-encoded and bit-packed in blocks of 128 ids, with each block's last id kept aside as a skip
+/// pointer, so intersections decode only the blocks that may contain a match. The index is immutable once built.
+class InvertedIndex {
+public:
+    using Size = search::Size;
+    using DocId = search::DocId;
+private:
+    struct Term {
+        Size first_block;
+        Size block_count;
+        Size doc_count;
+    };
+
+    /// Term names in ascending order; a term's id is its position.
+    Vec<std::string> names;
+    Vec<Term> terms;
+    Vec<search::Block> blocks;
+    /// Every block's packed gaps, plus one trailing word so that unpacking may read past the last block.
+    Vec<std::uint32_t> packed;
+    Size documents = 0;
+
+    auto find_term(std::string_view term) const -> const Term* {
+        auto it = std::lower_bound(names.begin(), names.end(), term,
+                                   [](const std::string& name, std::string_view key) { return name < key; });
+        return it == names.end() || *it != term ? nullptr : &terms.raw_ptr_begin()[it - names.begin()];
+    }
+
+    /// Walks one posting list in ascending order, decoding a block at a time.
+    class Cursor {
+    private:
+        const InvertedIndex* index;
+        Size first_block;
+        Size block;
+        Size end_block;
+        DocId ids[search::block_size];
+        Size pos = 0;
+        Size len = 0;
+
+        auto load(Size b) -> void {
+            const search::Block& info = index->blocks.raw_ptr_begin()[b];
+            block = b;
+            pos = 0;
+            len = info.count == 0 ? search::block_size : info.count;
+            search::unpack(index->packed.raw_ptr_begin() + info.offset, len, info.bits, ids);
+            std::int64_t prev = b == first_block ? -1 : index->blocks.raw_ptr_begin()[b - 1].last;
+            for (Size i = 0; i < len; i++) {
+                prev += std::int64_t(ids[i]) + 1;
+                ids[i] = static_cast<DocId>(prev);
+            }
+        }
+    public:
+        Cursor(const InvertedIndex& index, const Term& term)
+            : index(&index), first_block(term.first_block), block(term.first_block),
+              end_block(term.first_block + term.block_count) {
+            if (block < end_block) {
+                load(block);
+            }
+        }
+
+        auto done() const -> bool {
+            return block >= end_block;
+        }
+
+        auto doc() const -> DocId {
+            return ids[pos];
+        }
+
+        auto next() -> void {
+            if (++pos == len && ++block < end_block) {
+                load(block);
+            }
+        }
+
+        /// Moves to the first id at least `target`. Blocks whose last id is below `target` are skipped undecoded.
+        auto advance_to(DocId target) -> void {
+            if (done() || doc() >= target) {
+                return;
+            }
+            const search::Block* all = index->blocks.raw_ptr_begin();
+            if (all[block].last < target) {
+                const search::Block* found = std::partition_point(all + block + 1, all + end_block,
+                                                                  [target](const search::Block& b) { return b.last < target; });
+                block = static_cast<Size>(found - all);
+                if (block == end_block) {
+                    return;
+                }
+                load(block);
+            }
+            pos = static_cast<Size>(std::lower_bound(ids + pos, ids + len, target) - ids);
+        }
+    };
+
+    /// Builds the blocks of every term from the flat, per-term sorted `postings`, in parallel over terms.
+    auto compress(const Vec<DocId>& postings, const Vec<Size>& term_start, Size threads) -> void {
+        Size term_count = names.size();
+        terms = Vec<Term>::of(term_count, Term { 0, 0, 0 });
+        Size block_total = 0;
+        for (Size t = 0; t < term_count; t++) {
+            Size docs = term_start.raw_ptr_begin()[t + 1] - term_start.raw_ptr_begin()[t];
+            Size count = (docs + search::block_size - 1) / search::block_size;
+            terms.raw_ptr_begin()[t] = Term { block_total, count, docs };
+            block_total += count;
+        }
+        blocks = Vec<search::Block>::of(block_total, search::Block { 0, 0, 0, 0 });
+        // First pass: the bit width and size of every block; second pass: pack them at their final offsets.
+        auto words = Vec<std::uint32_t>::of(block_total + 1);
+        parallel::for_ranges(term_count, threads, 256, [&](Size, Size first, Size last) {
+            for (Size t = first; t < last; t++) {
+                const Term& term = terms.raw_ptr_begin()[t];
+                const DocId* ids = postings.raw_ptr_begin() + term_start.raw_ptr_begin()[t];
+                std::int64_t prev = -1;
+                for (Size b = 0; b < term.block_count; b++) {
+                    Size n = std::min(search::block_size, term.doc_count - b * search::block_size);
+                    std::uint32_t widest = 0;
+                    for (Size i = 0; i < n; i++) {
+                        widest |= static_cast<std::uint32_t>(ids[b * search::block_size + i] - prev - 1);
+                        prev = ids[b * search::block_size + i];
+                    }
+                    auto bits = static_cast<unsigned>(std::bit_width(widest));
+                    blocks.raw_ptr_begin()[term.first_block + b] = search::Block {
+                        static_cast<DocId>(prev), 0, static_cast<std::uint8_t>(bits),
+                        static_cast<std::uint8_t>(n % search::block_size)
+                    };
+                    words.raw_ptr_begin()[term.first_block + b] = static_cast<std::uint32_t>((n * bits + 31) / 32);
+                }
+            }
+        });
+        std::uint32_t offset = 0;
+        for (Size b = 0; b < block_total; b++) {
+            blocks.raw_ptr_begin()[b].offset = offset;
+            offset += words.raw_ptr_begin()[b];
+        }
+        packed = Vec<std::uint32_t>::of(Size(offset) + 1);
+        parallel::for_ranges(term_count, threads, 256, [&](Size, Size first, Size last) {
+            std::uint32_t gaps[search::block_size];
+            for (Size t = first; t < last; t++) {
+                const Term& term = terms.raw_ptr_begin()[t];
+                const DocId* ids = postings.raw_ptr_begin() + term_start.raw_ptr_begin()[t];
+                std::int64_t prev = -1;
+                for (Size b = 0; b < term.block_count; b++) {
+                    Size n = std::min(search::block_size, term.doc_count - b * search::block_size);
+                    for (Size i = 0; i < n; i++) {
+                        gaps[i] = static_cast<std::uint32_t>(ids[b * search::block_size + i] - prev - 1);
+                        prev = ids[b * search::block_size + i];
+                    }
+                    const search::Block& info = blocks.raw_ptr_begin()[term.first_block + b];
+                    search::pack(gaps, n, info.bits, packed.raw_ptr_begin() + info.offset);
+                }
+            }
+        });
+    }
+public:
+    /// Constructs an empty index.
+    InvertedIndex() = default;
+
+    /// Builds an index of `documents`; document `i` gets id `i`. Inversion is sort-based and runs on `threads`
+    /// threads: each thread tokenizes a range of documents into (term, document) pairs against its own dictionary,
+    /// the dictionaries are merged into sorted term ids, and each thread then sorts its pairs and scatters them into
+    /// the posting lists. Since the ranges are in document order, every posting list comes out sorted.
+    static auto build(const Vec<std::string>& documents, Size threads = parallel::hardware_threads())
+        -> InvertedIndex {
+        struct Local {
+            std::unordered_map<std::string, std::uint32_t> dictionary;
+            Vec<std::string> names;
+            /// (local term id << 32 | document), later (global term id << 32 | document).
+            Vec<std::uint64_t> pairs;
+            Vec<std::uint32_t> counts;
+        };
+        auto index = InvertedIndex();
+        index.documents = documents.size();
+        auto locals = Vec<Local>::of(std::max<Size>(threads, 1));
+        Size used = parallel::for_ranges(documents.size(), threads, 64, [&](Size t, Size first, Size last) {
+            Local& local = locals[t];
+            for (Size d = first; d < last; d++) {
+                search::for_each_term(documents.raw_ptr_begin()[d], [&](std::string_view term) {
+                    auto [it, added] = local.dictionary.try_emplace(std::string(term),
+                                                                    static_cast<std::uint32_t>(local.names.size()));
+                    if (added) {
+                        local.names.push_back(it->first);
+                    }
+                    local.pairs.push_back(std::uint64_t(it->second) << 32 | d);
+                });
+            }
+        });
+        locals.resize(used);
+
+        for (const Local& local : locals) {
+            index.names.insert_range(index.names.end(), local.names.begin(), local.names.end());
+        }
+        std::sort(index.names.begin(), index.names.end());
+        index.names.resize(static_cast<Size>(std::unique(index.names.begin(), index.names.end()) - index.names.begin()));
+        Size term_count = index.names.size();
+
+        parallel::for_ranges(used, used, 1, [&](Size, Size first, Size last) {
+            for (Size t = first; t < last; t++) {
+                Local& local = locals[t];
+                auto remap = Vec<std::uint64_t>();
+                remap.request_cap(local.names.size());
+                for (const std::string& name : local.names) {
+                    remap.push_back(static_cast<std::uint64_t>(
+                        std::lower_bound(index.names.begin(), index.names.end(), name) - index.names.begin()));
+                }
+                for (std::uint64_t& pair : local.pairs) {
+                    pair = remap.raw_ptr_begin()[pair >> 32] << 32 | (pair & 0xFFFFFFFFu);
+                }
+                std::sort(local.pairs.begin(), local.pairs.end());
+                local.pairs.resize(static_cast<Size>(std::unique(local.pairs.begin(), local.pairs.end())
+                                                     - local.pairs.begin()));
+                local.counts = Vec<std::uint32_t>::of(term_count);
+                for (std::uint64_t pair : local.pairs) {
+                    local.counts.raw_ptr_begin()[pair >> 32]++;
+                }
+                local.dictionary.clear();
+            }
+        });
+
+        // term_start[t] is where term t's postings begin; each local then writes from its own offset within them.
+        auto term_start = Vec<Size>::of(term_count + 1);
+        for (Size t = 0; t < term_count; t++) {
+            Size total = 0;
+            for (Local& local : locals) {
+                std::uint32_t count = local.counts.raw_ptr_begin()[t];
+                local.counts.raw_ptr_begin()[t] = static_cast<std::uint32_t>(total);
+                total += count;
+            }
+            term_start.raw_ptr_begin()[t + 1] = term_start.raw_ptr_begin()[t] + total;
+        }
+        auto postings = Vec<DocId>::of(term_start.raw_ptr_begin()[term_count]);
+        parallel::for_ranges(used, used, 1, [&](Size, Size first, Size last) {
+            for (Size t = first; t < last; t++) {
+                Local& local = locals[t];
+                for (std::uint64_t pair : local.pairs) {
+                    Size term = pair >> 32;
+                    Size at = term_start.raw_ptr_begin()[term] + local.counts.raw_ptr_begin()[term]++;
+                    postings.raw_ptr_begin()[at] = static_cast<DocId>(pair);
+                }
+            }
+        });
+        index.compress(postings, term_start, threads);
+        return index;
+    }
+
+    /// Returns the number of documents indexed.
+    auto document_count() const -> Size {
+        return documents;
+    }
+
+    /// Returns the number of distinct terms.
+    auto term_count() const -> Size {
+        return names.size();
+    }
+
+    /// Returns the number of documents containing `term` (lower-cased, as produced by `search::tokenize`).
+    auto document_frequency(std::string_view term) const -> Size {
+        const Term* found = find_term(term);
+        return found ? found->doc_count : 0;
+    }
+
+    /// Returns the ids of the documents containing `term`, in ascending order.
+    auto postings(std::string_view term) const -> Vec<DocId> {
+        auto result = Vec<DocId>();
+        if (const Term* found = find_term(term)) {
+            result.request_cap(found->doc_count);
+            for (auto cursor = Cursor(*this, *found); !cursor.done(); cursor.next()) {
+                result.push_back(cursor.doc());
+            }
+        }
+        return result;
+    }
+
+    /// Returns the ids of the documents containing every term of `query`, in ascending order. The rarest term leads;
+    /// the others skip ahead to each of its candidates.
+    auto all_of(const Vec<std::string>& query) const -> Vec<DocId> {
+        auto result = Vec<DocId>();
+        auto found = Vec<const Term*>();
+        for (const std::string& term : query) {
+            const Term* t = find_term(term);
+            if (t == nullptr) {
+                return result;
+            }
+            found.push_back(t);
+        }
+        if (found.is_empty()) {
+            return result;
+        }
+        std::sort(found.begin(), found.end(), [](const Term* a, const Term* b) { return a->doc_count < b->doc_count; });
+        auto cursors = Vec<Cursor>();
+        for (const Term* t : found) {
+            cursors.push_back(Cursor(*this, *t));
+        }
+        Cursor* lead = cursors.raw_ptr_begin();
+        while (!lead->done()) {
+            DocId candidate = lead->doc();
+            bool matched = true;
+            for (Size i = 1; i < cursors.size(); i++) {
+                Cursor& other = cursors.raw_ptr_begin()[i];
+                other.advance_to(candidate);
+                if (other.done()) {
+                    return result;
+                }
+                if (other.doc() != candidate) {
+                    lead->advance_to(other.doc());
+                    matched = false;
+                    break;
+                }
+            }
+            if (matched) {
+                result.push_back(candidate);
+                lead->next();
+            }
+        }
+        return result;
+    }
+
+    /// Returns the ids of the documents containing any term of `query`, in ascending order.
+    auto any_of(const Vec<std::string>& query) const -> Vec<DocId> {
+        auto cursors = Vec<Cursor>();
+        for (const std::string& term : query) {
+            if (const Term* t = find_term(term)) {
+                cursors.push_back(Cursor(*this, *t));
+            }
+        }
+        using Entry = std::pair<DocId, Size>;
+        auto heap = std::priority_queue<Entry, std::vector<Entry>, std::greater<>>();
+        for (Size i = 0; i < cursors.size(); i++) {
+            heap.push({ cursors.raw_ptr_begin()[i].doc(), i });
+        }
+        auto result = Vec<DocId>();
+        while (!heap.empty()) {
+            auto [doc, i] = heap.top();
+            heap.pop();
+            if (result.is_empty() || result.peek_back() != doc) {
+                result.push_back(doc);
+            }
+            Cursor& cursor = cursors.raw_ptr_begin()[i];
+            cursor.next();
+            if (!cursor.done()) {
+                heap.push({ cursor.doc(), i });
+            }
+        }
+        return result;
+    }
+
+    /// Returns the number of bytes used by the posting lists (blocks and packed gaps).
+    auto postings_bytes() const -> Size {
+        return blocks.size() * sizeof(search::Block) + packed.size() * sizeof(std::uint32_t);
+    }
+};
+
+#endif //TOOLS_INVERTED_INDEX_H
@@ -0,0 +1,42 @@
+#include <iostream>
+#include <string>
+
+#include "../inverted_index.h"
+
+auto test() -> int {
+    auto documents = Vec<std::string> {
+        "The quick brown fox",
+        "A lazy dog sleeps",
+        "The quick dog jumps over the lazy fox",
+        "Brown bread, brown sugar",
+    };
+    // Many documents mention "filler", so its posting list spans several blocks.
+    for (int i = 0; i < 1000; i++) {
+        documents.push_back(i % 250 == 0 ? "filler quick" : "filler text " + std::to_string(i));
+    }
+    auto index = InvertedIndex::build(documents, 3);
+    auto quick_fox = index.all_of(search::tokenize("quick FOX"));
+    // quick fox: [0, 2]
+    std::cout << "quick fox: " << quick_fox << '\n';
+    if (quick_fox.size() != 2 || quick_fox.at(0) != 0 || quick_fox.at(1) != 2) {
+        return 1;
+    }
+    auto lazy_or_brown = index.any_of(Vec<std::string> { "lazy", "brown" });
+    if (lazy_or_brown.size() != 4 || index.document_frequency("brown") != 2) {
+        return 1;
+    }
+    auto filler_quick = index.all_of(Vec<std::string> { "filler", "quick" });
+    // filler quick: [4, 254, 504, 754]
+    std::cout << "filler quick: " << filler_quick << '\n';
+    if (filler_quick.size() != 4 || filler_quick.at(3) != 754 || index.postings("filler").size() != 1000) {
+        return 1;
+    }
+    // A term in every document has only zero gaps, which pack into no words at the end of the postings.
+    auto every = InvertedIndex::build(Vec<std::string> { "a b", "a" }, 1);
+    auto a = every.postings("a");
+    return a.size() == 2 && a.at(1) == 1 && every.all_of(Vec<std::string> { "b", "a" }).size() == 1 ? 0 : 1;
+}
+
+auto main() -> int {
+    return test();
+}
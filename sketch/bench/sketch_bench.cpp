@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../count_min.h"
+#include "../hyper_log_log.h"
+#include "../space_saving.h"
+#include "../../bench/bench.h"
+
+// Accuracy and throughput of the sketches on a Zipfian stream, against exact counting with std::unordered_map.
+
+constexpr bench::Size stream_length = 20'000'000;
+constexpr bench::Size key_space = 5'000'000;
+constexpr bench::Size top_k = 100;
+
+auto main() -> int {
+    std::cout << std::fixed << std::setprecision(3);
+    auto zipf = bench::Zipf(key_space, 1.1);
+    auto rng = std::mt19937_64(3);
+    auto stream = Vec<std::uint64_t>();
+    stream.request_cap(stream_length);
+    for (bench::Size i = 0; i < stream_length; i++) {
+        stream.push_back(zipf(rng) * 0x9E3779B97F4A7C15ull);
+    }
+    auto mitems = [](double time) {
+        return static_cast<double>(stream_length) / time / 1e6;
+    };
+
+    auto exact = std::unordered_map<std::uint64_t, std::uint64_t>();
+    double exact_time = bench::seconds([&] {
+        exact.clear();
+        for (std::uint64_t val : stream) {
+            exact[val]++;
+        }
+    }, 1);
+    auto ranked = Vec<std::pair<std::uint64_t, std::uint64_t>>();
+    for (const auto& [key, count] : exact) {
+        ranked.push_back({ count, key });
+    }
+    std::sort(ranked.begin(), ranked.end(), std::greater<>());
+    std::cout << stream_length << " values, " << exact.size() << " distinct; exact counting "
+              << mitems(exact_time) << " M values/s\n";
+
+    for (unsigned precision : { 10, 14, 18 }) {
+        auto hll = HyperLogLog(precision);
+        double time = bench::seconds([&] {
+            hll.clear();
+            hll.add_all(stream);
+        });
+        auto other = HyperLogLog(precision);
+        double merge = bench::seconds([&] { other.merge(hll); }, 10);
+        double error = hll.estimate() / static_cast<double>(exact.size()) - 1;
+        std::cout << "HyperLogLog precision " << precision << ": error " << error * 100 << "% (standard error "
+                  << 104 / std::sqrt(static_cast<double>(1 << precision)) << "%), " << mitems(time)
+                  << " M values/s, merge " << merge * 1e6 << " us\n";
+    }
+
+    // Errors are measured on the heaviest keys and on keys drawn uniformly from those that occurred.
+    auto probes = Vec<std::uint64_t>();
+    for (bench::Size i = 0; i < 10'000; i++) {
+        probes.push_back(ranked.raw_ptr_begin()[i < top_k ? i : rng() % ranked.size()].second);
+    }
+    for (bench::Size width : { 1 << 10, 1 << 14, 1 << 18 }) {
+        auto cm = CountMin(width, 4);
+        double time = bench::seconds([&] {
+            cm.clear();
+            cm.add_all(stream);
+        });
+        double total_error = 0;
+        bench::Size within = 0;
+        double bound = std::exp(1.0) / static_cast<double>(width) * static_cast<double>(stream_length);
+        for (std::uint64_t key : probes) {
+            double over = static_cast<double>(cm.estimate(key) - exact[key]);
+            total_error += over;
+            within += over <= bound;
+        }
+        std::cout << "CountMin width " << width << ", depth 4: mean overcount "
+                  << total_error / static_cast<double>(probes.size()) << ", " << within * 100 / probes.size()
+                  << "% within e/width * n = " << bound << ", " << mitems(time) << " M values/s\n";
+    }
+
+    auto truth = std::unordered_set<std::uint64_t>();
+    for (bench::Size i = 0; i < top_k; i++) {
+        truth.insert(ranked.raw_ptr_begin()[i].second);
+    }
+    for (bench::Size capacity : { top_k, 10 * top_k, 100 * top_k }) {
+        auto ss = SpaceSaving<std::uint64_t>(capacity);
+        double time = bench::seconds([&] {
+            ss.clear();
+            ss.add_all(stream);
+        });
+        bench::Size found = 0;
+        for (const auto& entry : ss.top(top_k)) {
+            found += truth.contains(entry.key);
+        }
+        std::cout << "SpaceSaving capacity " << capacity << ": top-" << top_k << " recall "
+                  << static_cast<double>(found) / top_k << ", " << mitems(time) << " M values/s\n";
+    }
+    return 0;
+}
@@ -0,0 +1,138 @@
+#ifndef TOOLS_COUNT_MIN_H
+#define TOOLS_COUNT_MIN_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#include "../vec/vec.h"
+#include "sketch.h"
+
+/// `CountMin` estimates how often each value occurs in a stream with `depth` rows of `width` counters. Estimates
+/// never undercount; with `width = e / epsilon` and `depth = ln(1 / delta)`, they overcount by more than
+/// `epsilon * total` with probability at most `delta`. Sketches of the same dimensions merge by adding counters.
+class CountMin {
+public:
+    using Size = sketch::Size;
+private:
+    static constexpr std::uint8_t format = 2;
+
+    Size width;
+    Size depth;
+    Vec<std::uint64_t> counters;
+    std::uint64_t total = 0;
+
+    /// Returns the counter of `row` for `hash`. Row hashes are derived from two halves of one hash (Kirsch and
+    /// Mitzenmacher), which is as good as independent hashes for this purpose.
+    auto slot(std::uint64_t hash, Size row) const -> Size {
+        std::uint64_t h = (hash & 0xFFFFFFFFull) + row * (hash >> 32 | 1);
+        return row * width + h % width;
+    }
+public:
+    /// Constructs an empty sketch with `depth` rows of `width` counters.
+    /// @throws InvalidArgument if a dimension is zero.
+    CountMin(Size width = 2048, Size depth = 4) : width(width), depth(depth) {
+        if (width == 0 || depth == 0) {
+            throw error::InvalidArgument("CountMin dimensions must be positive.");
+        }
+        counters = Vec<std::uint64_t>::of(width * depth);
+    }
+
+    /// Adds `count` occurrences of a value given by its 64-bit hash (see `sketch::hash`).
+    auto add_hash(std::uint64_t hash, std::uint64_t count = 1) -> void {
+        std::uint64_t* data = counters.raw_ptr_begin();
+        for (Size row = 0; row < depth; row++) {
+            data[slot(hash, row)] += count;
+        }
+        total += count;
+    }
+
+    /// Adds `count` occurrences of `val`.
+    template <class T>
+    auto add(const T& val, std::uint64_t count = 1) -> void {
+        add_hash(sketch::hash(val), count);
+    }
+
+    /// Adds one occurrence of every element of `values`.
+    template <class T>
+    auto add_all(const Vec<T>& values) -> void {
+        for (const T& val : values) {
+            add_hash(sketch::hash(val));
+        }
+    }
+
+    /// Returns the estimated number of occurrences of a value given by its hash.
+    auto estimate_hash(std::uint64_t hash) const -> std::uint64_t {
+        std::uint64_t result = std::numeric_limits<std::uint64_t>::max();
+        for (Size row = 0; row < depth; row++) {
+            result = std::min(result, counters.raw_ptr_begin()[slot(hash, row)]);
+        }
+        return result;
+    }
+
+    /// Returns the estimated number of occurrences of `val`.
+    template <class T>
+    auto estimate(const T& val) const -> std::uint64_t {
+        return estimate_hash(sketch::hash(val));
+    }
+
+    /// Returns the number of occurrences added.
+    auto count() const -> std::uint64_t {
+        return total;
+    }
+
+    /// Folds `other` into this sketch, which then describes both streams.
+    /// @throws InvalidArgument if the dimensions differ.
+    auto merge(const CountMin& other) -> void {
+        if (other.width != width || other.depth != depth) {
+            throw error::InvalidArgument("cannot merge CountMin sketches of different dimensions.");
+        }
+        std::uint64_t* data = counters.raw_ptr_begin();
+        const std::uint64_t* in = other.counters.raw_ptr_begin();
+        for (Size i = 0; i < counters.size(); i++) {
+            data[i] += in[i];
+        }
+        total += other.total;
+    }
+
+    /// Resets the sketch to empty.
+    auto clear() -> void {
+        std::fill(counters.begin(), counters.end(), 0);
+        total = 0;
+    }
+
+    /// Returns the sketch as bytes: a format tag, the dimensions, the total and the counters.
+    auto serialize() const -> Vec<std::uint8_t> {
+        auto bytes = Vec<std::uint8_t>();
+        auto writer = sketch::Writer(bytes);
+        writer.put(format);
+        writer.put(static_cast<std::uint64_t>(width));
+        writer.put(static_cast<std::uint64_t>(depth));
+        writer.put(total);
+        writer.put_array(counters.raw_ptr_begin(), counters.size());
+        return bytes;
+    }
+
+    /// Reads back a sketch written by `serialize`.
+    /// @throws InvalidArgument if `bytes` is not a serialized `CountMin`.
+    static auto deserialize(const Vec<std::uint8_t>& bytes) -> CountMin {
+        auto reader = sketch::Reader(bytes);
+        if (reader.get<std::uint8_t>() != format) {
+            throw error::InvalidArgument("not a serialized CountMin.");
+        }
+        auto width = static_cast<Size>(reader.get<std::uint64_t>());
+        auto depth = static_cast<Size>(reader.get<std::uint64_t>());
+        if (width != 0 && depth > (bytes.size() / sizeof(std::uint64_t)) / width) {
+            throw error::InvalidArgument("truncated sketch data.");
+        }
+        auto result = CountMin(width, depth);
+        result.total = reader.get<std::uint64_t>();
+        reader.get_array(result.counters.raw_ptr_begin(), result.counters.size());
+        if (!reader.done()) {
+            throw error::InvalidArgument("trailing bytes after CountMin.");
+        }
+        return result;
+    }
+};
+
+#endif //TOOLS_COUNT_MIN_H
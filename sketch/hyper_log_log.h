@@ -0,0 +1,121 @@
+#ifndef TOOLS_HYPER_LOG_LOG_H
+#define TOOLS_HYPER_LOG_LOG_H
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+#include "../vec/vec.h"
+#include "sketch.h"
+
+/// `HyperLogLog` estimates the number of distinct values in a stream using `2^precision` one-byte registers, with a
+/// relative standard error of about `1.04 / sqrt(2^precision)` (0.8% at the default precision of 14, in 16 KiB).
+/// Sketches of disjoint parts of a stream (e.g. one per thread) merge into the sketch of the whole stream.
+class HyperLogLog {
+public:
+    using Size = sketch::Size;
+private:
+    static constexpr std::uint8_t format = 1;
+
+    unsigned precision;
+    Vec<std::uint8_t> registers;
+public:
+    /// Constructs an empty sketch with `2^precision` registers.
+    /// @throws InvalidArgument if `precision` is not within [4, 18].
+    explicit HyperLogLog(unsigned precision = 14) : precision(precision) {
+        if (precision < 4 || precision > 18) {
+            throw error::InvalidArgument("HyperLogLog precision must be within [4, 18].");
+        }
+        registers = Vec<std::uint8_t>::of(Size(1) << precision);
+    }
+
+    /// Adds a value given by its 64-bit hash, whose bits must look random (see `sketch::hash`).
+    auto add_hash(std::uint64_t hash) -> void {
+        Size index = hash >> (64 - precision);
+        // The marker bit bounds the rank when the remaining bits are all zero.
+        std::uint64_t rest = (hash << precision) | (std::uint64_t(1) << (precision - 1));
+        auto rank = static_cast<std::uint8_t>(std::countl_zero(rest) + 1);
+        std::uint8_t& reg = registers.raw_ptr_begin()[index];
+        reg = std::max(reg, rank);
+    }
+
+    /// Adds `val`.
+    template <class T>
+    auto add(const T& val) -> void {
+        add_hash(sketch::hash(val));
+    }
+
+    /// Adds every element of `values`.
+    template <class T>
+    auto add_all(const Vec<T>& values) -> void {
+        for (const T& val : values) {
+            add_hash(sketch::hash(val));
+        }
+    }
+
+    /// Returns the estimated number of distinct values added.
+    auto estimate() const -> double {
+        const std::uint8_t* data = registers.raw_ptr_begin();
+        auto m = static_cast<double>(registers.size());
+        double sum = 0;
+        Size zeros = 0;
+        for (Size i = 0; i < registers.size(); i++) {
+            sum += std::ldexp(1.0, -data[i]);
+            zeros += data[i] == 0;
+        }
+        double alpha = 0.7213 / (1 + 1.079 / m);
+        double raw = alpha * m * m / sum;
+        // Linear counting is more accurate while many registers are still empty.
+        if (raw <= 2.5 * m && zeros != 0) {
+            return m * std::log(m / static_cast<double>(zeros));
+        }
+        return raw;
+    }
+
+    /// Folds `other` into this sketch, which then describes the union of both streams. The loop takes the maximum of
+    /// corresponding one-byte registers, which the compiler vectorizes.
+    /// @throws InvalidArgument if the precisions differ.
+    auto merge(const HyperLogLog& other) -> void {
+        if (other.precision != precision) {
+            throw error::InvalidArgument("cannot merge HyperLogLog sketches of different precision.");
+        }
+        std::uint8_t* data = registers.raw_ptr_begin();
+        const std::uint8_t* in = other.registers.raw_ptr_begin();
+        for (Size i = 0; i < registers.size(); i++) {
+            data[i] = std::max(data[i], in[i]);
+        }
+    }
+
+    /// Resets the sketch to empty.
+    auto clear() -> void {
+        std::fill(registers.begin(), registers.end(), 0);
+    }
+
+    /// Returns the sketch as bytes: a format tag, the precision and the registers.
+    auto serialize() const -> Vec<std::uint8_t> {
+        auto bytes = Vec<std::uint8_t>();
+        auto writer = sketch::Writer(bytes);
+        writer.put(format);
+        writer.put(static_cast<std::uint8_t>(precision));
+        writer.put_array(registers.raw_ptr_begin(), registers.size());
+        return bytes;
+    }
+
+    /// Reads back a sketch written by `serialize`.
+    /// @throws InvalidArgument if `bytes` is not a serialized `HyperLogLog`.
+    static auto deserialize(const Vec<std::uint8_t>& bytes) -> HyperLogLog {
+        auto reader = sketch::Reader(bytes);
+        if (reader.get<std::uint8_t>() != format) {
+            throw error::InvalidArgument("not a serialized HyperLogLog.");
+        }
+        auto result = HyperLogLog(reader.get<std::uint8_t>());
+        reader.get_array(result.registers.raw_ptr_begin(), result.registers.size());
+        if (!reader.done()) {
+            throw error::InvalidArgument("trailing bytes after HyperLogLog.");
+        }
+        return result;
+    }
+};
+
+#endif //TOOLS_HYPER_LOG_LOG_H
@@ -0,0 +1,88 @@
+#ifndef TOOLS_SKETCH_H
+#define TOOLS_SKETCH_H
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+#include "../vec/vec.h"
+
+namespace sketch {
+    using Size = std::size_t;
+
+    /// Scrambles a 64-bit value (the splitmix64 finalizer). `std::hash` is the identity for integers, so its output
+    /// is mixed before its bits are used as if random.
+    inline auto mix(std::uint64_t x) -> std::uint64_t {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ull;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBull;
+        x ^= x >> 31;
+        return x;
+    }
+
+    /// Returns the mixed `std::hash` of `val`.
+    template <class T>
+    auto hash(const T& val) -> std::uint64_t {
+        return mix(static_cast<std::uint64_t>(std::hash<T>()(val)));
+    }
+
+    /// Appends the bytes of trivially copyable values to a `Vec<std::uint8_t>`, for serialization.
+    class Writer {
+    private:
+        Vec<std::uint8_t>& out;
+    public:
+        explicit Writer(Vec<std::uint8_t>& bytes) : out(bytes) {}
+
+        template <class T>
+        requires (std::is_trivially_copyable_v<T>)
+        auto put(const T& val) -> void {
+            put_array(&val, 1);
+        }
+
+        template <class T>
+        requires (std::is_trivially_copyable_v<T>)
+        auto put_array(const T* vals, Size n) -> void {
+            Size at = out.size();
+            out.resize(at + n * sizeof(T));
+            std::memcpy(out.raw_ptr_begin() + at, vals, n * sizeof(T));
+        }
+    };
+
+    /// Reads back the values written by a `Writer`.
+    class Reader {
+    private:
+        const Vec<std::uint8_t>& in;
+        Size at = 0;
+    public:
+        explicit Reader(const Vec<std::uint8_t>& bytes) : in(bytes) {}
+
+        /// @throws InvalidArgument if the input is too short.
+        template <class T>
+        requires (std::is_trivially_copyable_v<T>)
+        auto get() -> T {
+            T val;
+            get_array(&val, 1);
+            return val;
+        }
+
+        /// @throws InvalidArgument if the input is too short.
+        template <class T>
+        requires (std::is_trivially_copyable_v<T>)
+        auto get_array(T* vals, Size n) -> void {
+            if (n > (in.size() - at) / sizeof(T)) {
+                throw error::InvalidArgument("truncated sketch data.");
+            }
+            std::memcpy(vals, in.raw_ptr_begin() + at, n * sizeof(T));
+            at += n * sizeof(T);
+        }
+
+        /// Returns if every byte was read.
+        auto done() const -> bool {
+            return at == in.size();
+        }
+    };
+}
+
+#endif //TOOLS_SKETCH_H
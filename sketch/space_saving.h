@@ -0,0 +1,274 @@
+#ifndef TOOLS_SPACE_SAVING_H
+#define TOOLS_SPACE_SAVING_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include "../vec/vec.h"
+#include "sketch.h"
+
+namespace sketch {
+    /// A value tracked by `SpaceSaving`. Its true number of occurrences is within [`count - error`, `count`].
+    template <class K>
+    struct Counted {
+        K key;
+        std::uint64_t count;
+        std::uint64_t error;
+    };
+}
+
+/// `SpaceSaving` tracks the most frequent values of a stream (top-k, heavy hitters) with `capacity` counters. Every
+/// value occurring more than `total / capacity` times is tracked. When a new value arrives and every counter is taken,
+/// it replaces the value with the least count and inherits that count as its error. Counters are kept in an indexed
+/// min-heap so that replacements cost `O(log capacity)`.
+template <class K, class Hash = std::hash<K>>
+class SpaceSaving {
+public:
+    using Size = sketch::Size;
+    using Entry = sketch::Counted<K>;
+
+    /// The most counters a summary may have: 2^24, which already takes upwards of half a GiB.
+    static constexpr Size max_capacity = Size(1) << 24;
+private:
+    static constexpr std::uint8_t format = 3;
+
+    Size capacity;
+    std::uint64_t total = 0;
+    Vec<Entry> entries;
+    /// Entry indices in min-heap order of count.
+    Vec<Size> heap;
+    /// The heap position of each entry.
+    Vec<Size> position;
+    std::unordered_map<K, Size, Hash> index;
+
+    auto count_at(Size pos) const -> std::uint64_t {
+        return entries.raw_ptr_begin()[heap.raw_ptr_begin()[pos]].count;
+    }
+
+    auto swap_at(Size a, Size b) -> void {
+        Size* h = heap.raw_ptr_begin();
+        std::swap(h[a], h[b]);
+        position.raw_ptr_begin()[h[a]] = a;
+        position.raw_ptr_begin()[h[b]] = b;
+    }
+
+    auto sift_up(Size pos) -> void {
+        while (pos > 0 && count_at((pos - 1) / 2) > count_at(pos)) {
+            swap_at(pos, (pos - 1) / 2);
+            pos = (pos - 1) / 2;
+        }
+    }
+
+    auto sift_down(Size pos) -> void {
+        Size n = heap.size();
+        while (true) {
+            Size least = pos;
+            Size left = 2 * pos + 1;
+            if (left < n && count_at(left) < count_at(least)) {
+                least = left;
+            }
+            if (left + 1 < n && count_at(left + 1) < count_at(least)) {
+                least = left + 1;
+            }
+            if (least == pos) {
+                return;
+            }
+            swap_at(pos, least);
+            pos = least;
+        }
+    }
+
+    /// Returns the least tracked count once every counter is taken, which bounds the count of any untracked value.
+    auto floor() const -> std::uint64_t {
+        return entries.size() == capacity ? count_at(0) : 0;
+    }
+
+    /// Rebuilds the heap and index from `entries`, keeping only the `capacity` largest counts.
+    auto rebuild(Vec<Entry> all) -> void {
+        if (all.size() > capacity) {
+            std::nth_element(all.begin(), all.begin() + static_cast<std::ptrdiff_t>(capacity), all.end(),
+                             [](const Entry& a, const Entry& b) { return a.count > b.count; });
+            all.resize(capacity);
+        }
+        entries = std::move(all);
+        heap.resize(0);
+        position.resize(0);
+        index.clear();
+        for (Size i = 0; i < entries.size(); i++) {
+            heap.push_back(i);
+            position.push_back(i);
+            index.emplace(entries.raw_ptr_begin()[i].key, i);
+        }
+        for (Size i = heap.size() / 2; i-- > 0;) {
+            sift_down(i);
+        }
+    }
+
+    /// Constructs an empty summary with `capacity` counters and room for `reserved` of them.
+    SpaceSaving(Size capacity, Size reserved) : capacity(capacity) {
+        if (capacity == 0 || capacity > max_capacity) {
+            throw error::InvalidArgument("SpaceSaving capacity must be within [1, max_capacity].");
+        }
+        entries.request_cap(reserved);
+        heap.request_cap(reserved);
+        position.request_cap(reserved);
+        index.reserve(reserved);
+    }
+public:
+    /// Constructs an empty summary with `capacity` counters.
+    /// @throws InvalidArgument if `capacity` is zero or exceeds `max_capacity`.
+    explicit SpaceSaving(Size capacity) : SpaceSaving(capacity, capacity) {}
+
+    /// Adds `count` occurrences of `key`.
+    auto add(const K& key, std::uint64_t count = 1) -> void {
+        total += count;
+        if (auto it = index.find(key); it != index.end()) {
+            entries.raw_ptr_begin()[it->second].count += count;
+            sift_down(position.raw_ptr_begin()[it->second]);
+            return;
+        }
+        if (entries.size() < capacity) {
+            Size slot = entries.size();
+            entries.push_back(Entry{key, count, 0});
+            heap.push_back(slot);
+            position.push_back(slot);
+            index.emplace(key, slot);
+            sift_up(slot);
+            return;
+        }
+        Size slot = heap.raw_ptr_begin()[0];
+        Entry& victim = entries.raw_ptr_begin()[slot];
+        index.erase(victim.key);
+        victim.key = key;
+        victim.error = victim.count;
+        victim.count += count;
+        index.emplace(key, slot);
+        sift_down(0);
+    }
+
+    /// Adds one occurrence of every element of `values`.
+    auto add_all(const Vec<K>& values) -> void {
+        for (const K& val : values) {
+            add(val);
+        }
+    }
+
+    /// Returns an upper bound on the occurrences of `key`: its count if tracked, otherwise the least tracked count.
+    auto estimate(const K& key) const -> std::uint64_t {
+        auto it = index.find(key);
+        return it == index.end() ? floor() : entries.raw_ptr_begin()[it->second].count;
+    }
+
+    /// Returns if `key` is tracked.
+    auto contains(const K& key) const -> bool {
+        return index.contains(key);
+    }
+
+    /// Returns the `n` tracked values of highest count, in descending order of count.
+    auto top(Size n) const -> Vec<Entry> {
+        auto result = Vec<Entry>::from(entries);
+        auto by_count = [](const Entry& a, const Entry& b) { return a.count > b.count; };
+        n = std::min(n, result.size());
+        std::partial_sort(result.begin(), result.begin() + static_cast<std::ptrdiff_t>(n), result.end(), by_count);
+        result.resize(n);
+        return result;
+    }
+
+    /// Returns the number of tracked values.
+    auto size() const -> Size {
+        return entries.size();
+    }
+
+    /// Returns the number of occurrences added.
+    auto count() const -> std::uint64_t {
+        return total;
+    }
+
+    /// Folds `other` into this summary, which then describes both streams with the same guarantees (Agarwal et al.,
+    /// "Mergeable summaries"): a value missing from one side is charged that side's least count as both count and error.
+    /// @throws InvalidArgument if the capacities differ.
+    auto merge(const SpaceSaving& other) -> void {
+        if (other.capacity != capacity) {
+            throw error::InvalidArgument("cannot merge SpaceSaving summaries of different capacity.");
+        }
+        std::uint64_t mine = floor();
+        std::uint64_t theirs = other.floor();
+        auto all = Vec<Entry>();
+        all.request_cap(entries.size() + other.entries.size());
+        for (const Entry& e : entries) {
+            auto it = other.index.find(e.key);
+            if (it == other.index.end()) {
+                all.push_back(Entry{e.key, e.count + theirs, e.error + theirs});
+            } else {
+                const Entry& o = other.entries.raw_ptr_begin()[it->second];
+                all.push_back(Entry{e.key, e.count + o.count, e.error + o.error});
+            }
+        }
+        for (const Entry& o : other.entries) {
+            if (!index.contains(o.key)) {
+                all.push_back(Entry{o.key, o.count + mine, o.error + mine});
+            }
+        }
+        total += other.total;
+        rebuild(std::move(all));
+    }
+
+    /// Resets the summary to empty.
+    auto clear() -> void {
+        total = 0;
+        rebuild(Vec<Entry>());
+    }
+
+    /// Returns the summary as bytes: a format tag, the capacity, the total and the tracked entries.
+    auto serialize() const -> Vec<std::uint8_t> requires (std::is_trivially_copyable_v<K>) {
+        auto bytes = Vec<std::uint8_t>();
+        auto writer = sketch::Writer(bytes);
+        writer.put(format);
+        writer.put(static_cast<std::uint64_t>(capacity));
+        writer.put(total);
+        writer.put(static_cast<std::uint64_t>(entries.size()));
+        for (const Entry& e : entries) {
+            writer.put(e.key);
+            writer.put(e.count);
+            writer.put(e.error);
+        }
+        return bytes;
+    }
+
+    /// Reads back a summary written by `serialize`. Storage is sized by the entries present rather than by the stored
+    /// capacity, so a small input cannot demand a large allocation.
+    /// @throws InvalidArgument if `bytes` is not a serialized `SpaceSaving` or its capacity exceeds `max_capacity`.
+    static auto deserialize(const Vec<std::uint8_t>& bytes) -> SpaceSaving requires (std::is_trivially_copyable_v<K>) {
+        auto reader = sketch::Reader(bytes);
+        if (reader.get<std::uint8_t>() != format) {
+            throw error::InvalidArgument("not a serialized SpaceSaving.");
+        }
+        auto capacity = static_cast<Size>(reader.get<std::uint64_t>());
+        auto total = reader.get<std::uint64_t>();
+        auto n = static_cast<Size>(reader.get<std::uint64_t>());
+        if (capacity == 0 || capacity > max_capacity || n > capacity
+            || n > bytes.size() / (sizeof(K) + 2 * sizeof(std::uint64_t))) {
+            throw error::InvalidArgument("malformed SpaceSaving data.");
+        }
+        auto result = SpaceSaving(capacity, n);
+        auto all = Vec<Entry>();
+        all.request_cap(n);
+        for (Size i = 0; i < n; i++) {
+            auto key = reader.get<K>();
+            auto count = reader.get<std::uint64_t>();
+            all.push_back(Entry{key, count, reader.get<std::uint64_t>()});
+        }
+        if (!reader.done()) {
+            throw error::InvalidArgument("trailing bytes after SpaceSaving.");
+        }
+        result.total = total;
+        result.rebuild(std::move(all));
+        return result;
+    }
+};
+
+#endif //TOOLS_SPACE_SAVING_H
@@ -0,0 +1,55 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+
+#include "../count_min.h"
+#include "../hyper_log_log.h"
+#include "../space_saving.h"
+#include "../../parallel/parallel.h"
+
+auto test() -> int {
+    // Four threads each sketch a quarter of the stream; the merged sketches describe all of it.
+    auto values = Vec<std::uint64_t>();
+    for (std::uint64_t i = 0; i < 40'000; i++) {
+        values.push_back(i % 10 == 0 ? 7 : i);
+    }
+    auto distinct = Vec<HyperLogLog>::of(4);
+    auto frequencies = Vec<CountMin>::of(4);
+    auto heavy = Vec<SpaceSaving<std::uint64_t>>::of(4, SpaceSaving<std::uint64_t>(16));
+    parallel::for_ranges(values.size(), 4, 1, [&](std::size_t t, std::size_t first, std::size_t last) {
+        auto part = Vec<std::uint64_t>::from(values.begin() + first, values.begin() + last);
+        distinct[t].add_all(part);
+        frequencies[t].add_all(part);
+        heavy[t].add_all(part);
+    });
+    for (std::size_t t = 1; t < 4; t++) {
+        distinct[0].merge(distinct[t]);
+        frequencies[0].merge(frequencies[t]);
+        heavy[0].merge(heavy[t]);
+    }
+    // distinct ~36001, 7 seen >= 4001 times, top 7
+    auto restored = HyperLogLog::deserialize(distinct[0].serialize());
+    std::cout << "distinct ~" << static_cast<long>(restored.estimate()) << ", 7 seen >= "
+              << CountMin::deserialize(frequencies[0].serialize()).estimate(std::uint64_t(7)) << " times, top "
+              << heavy[0].top(1)[0].key << '\n';
+    double estimate = restored.estimate();
+    if (estimate < 36'001 * 0.97 || estimate > 36'001 * 1.03) {
+        return 1;
+    }
+    if (frequencies[0].estimate(std::uint64_t(7)) < 4'001 || frequencies[0].count() != 40'000) {
+        return 1;
+    }
+    // A forged capacity is rejected before anything is allocated for it.
+    auto forged = heavy[0].serialize();
+    std::fill(forged.begin() + 1, forged.begin() + 9, std::uint8_t(0xFF));
+    try {
+        SpaceSaving<std::uint64_t>::deserialize(forged);
+        return 1;
+    } catch (const error::InvalidArgument&) {}
+    auto top = SpaceSaving<std::uint64_t>::deserialize(heavy[0].serialize()).top(1);
+    return top[0].key == 7 && top[0].count - top[0].error <= 4'001 && top[0].count >= 4'001 ? 0 : 1;
+}
+
+auto main() -> int {
+    return test();
+}
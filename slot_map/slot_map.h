@@ -0,0 +1,243 @@
+#ifndef TOOLS_SLOT_MAP_H
+#define TOOLS_SLOT_MAP_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <utility>
+
+#include "../vec/vec.h"
+
+namespace slot_map {
+    /// A generational reference to a value stored in a `SlotMap`. A handle stays valid until its value is removed;
+    /// afterwards, the map recognizes it as stale even if the slot is reused.
+    struct Handle {
+        std::uint32_t index = 0;
+        std::uint32_t generation = 0;
+
+        auto operator==(const Handle& other) const -> bool = default;
+    };
+}
+
+/// `SlotMap` stores values densely in a `Vec` and hands out stable, generational `Handle`s to them. Insertion,
+/// removal and lookup are O(1); iteration walks the dense storage.
+template <class T>
+class SlotMap {
+public:
+    using Handle = slot_map::Handle;
+    using ConstIterator = typename Vec<T>::ConstIterator;
+    using Iterator = typename Vec<T>::Iterator;
+    using Size = typename Vec<T>::Size;
+private:
+    /// An entry of the indirection table. While occupied (odd `generation`), `index` is the position of the value
+    /// in the dense storage; while free (even `generation`), `index` is the next free slot.
+    struct Slot {
+        std::uint32_t index;
+        std::uint32_t generation;
+    };
+
+    static constexpr std::uint32_t no_slot = std::numeric_limits<std::uint32_t>::max();
+
+    /// Dense value storage.
+    Vec<T> values;
+    /// The slot that owns each dense value.
+    Vec<std::uint32_t> owners;
+    /// The insertion sequence number of each dense value, used by `compact`.
+    Vec<std::uint64_t> sequence;
+    /// The indirection table.
+    Vec<Slot> slots;
+    std::uint32_t free_head = no_slot;
+    std::uint64_t next_sequence = 0;
+
+    auto slot_of(const Handle& handle) const -> const Slot* {
+        if (handle.index >= slots.size()) {
+            return nullptr;
+        }
+        const Slot* slot = slots.raw_ptr_begin() + handle.index;
+        return slot->generation == handle.generation && (slot->generation & 1u) ? slot : nullptr;
+    }
+public:
+    /// Inserts a copy of `val` and returns a handle to it.
+    auto insert(const T& val) -> Handle {
+        std::uint32_t index;
+        if (free_head != no_slot) {
+            index = free_head;
+            free_head = slots[index].index;
+        } else {
+            index = static_cast<std::uint32_t>(slots.size());
+            slots.push_back(Slot { 0, 0 });
+        }
+        Slot& slot = slots[index];
+        slot.index = static_cast<std::uint32_t>(values.size());
+        slot.generation++;
+        values.push_back(val);
+        owners.push_back(index);
+        sequence.push_back(next_sequence++);
+        return Handle { index, slot.generation };
+    }
+
+    /// Removes and returns the value referred to by `handle`. Returns `std::nullopt` if `handle` is stale.
+    /// The last dense value is moved into the vacated position, so iteration order is not preserved.
+    auto remove(const Handle& handle) -> std::optional<T> {
+        if (slot_of(handle) == nullptr) {
+            return std::nullopt;
+        }
+        Slot& slot = slots[handle.index];
+        std::uint32_t dense = slot.index;
+        std::uint32_t last = static_cast<std::uint32_t>(values.size() - 1);
+        T* data = values.raw_ptr_begin();
+        std::optional<T> result(std::move(data[dense]));
+        if (dense != last) {
+            data[dense] = std::move(data[last]);
+            owners[dense] = owners[last];
+            sequence[dense] = sequence[last];
+            slots[owners[dense]].index = dense;
+        }
+        values.remove(values.end() - 1);
+        owners.remove(owners.end() - 1);
+        sequence.remove(sequence.end() - 1);
+        slot.generation++;
+        slot.index = free_head;
+        free_head = handle.index;
+        return result;
+    }
+
+    /// Returns if `handle` refers to a live value.
+    auto contains(const Handle& handle) const -> bool {
+        return slot_of(handle) != nullptr;
+    }
+
+    /// Returns a pointer to the value referred to by `handle`, or `nullptr` if `handle` is stale.
+    auto find(const Handle& handle) -> T* {
+        const Slot* slot = slot_of(handle);
+        return slot ? values.raw_ptr_begin() + slot->index : nullptr;
+    }
+
+    /// Returns a pointer to the value referred to by `handle`, or `nullptr` if `handle` is stale.
+    auto find(const Handle& handle) const -> const T* {
+        const Slot* slot = slot_of(handle);
+        return slot ? values.raw_ptr_begin() + slot->index : nullptr;
+    }
+
+    /// Returns a reference to the value referred to by `handle`.
+    /// @throws NoSuchElement if `handle` is stale.
+    auto at(const Handle& handle) -> T& {
+        T* val = find(handle);
+        if (val == nullptr) {
+            throw error::NoSuchElement("stale slot map handle.");
+        }
+        return *val;
+    }
+
+    /// Returns a reference to the value referred to by `handle`.
+    /// @throws NoSuchElement if `handle` is stale.
+    auto at(const Handle& handle) const -> const T& {
+        const T* val = find(handle);
+        if (val == nullptr) {
+            throw error::NoSuchElement("stale slot map handle.");
+        }
+        return *val;
+    }
+
+    /// Returns the handle of the value at position `i` of the dense storage.
+    /// @throws IndexOutOfBounds if attempting to access an element at an invalid index.
+    auto handle_at(Size i) const -> Handle {
+        std::uint32_t index = owners.at(i);
+        return Handle { index, slots.raw_ptr_begin()[index].generation };
+    }
+
+    /// Reorders the dense storage so that iteration visits values in insertion order. Handles remain valid.
+    auto compact() -> void {
+        T* data = values.raw_ptr_begin();
+        std::uint32_t* owner = owners.raw_ptr_begin();
+        std::uint64_t* seq = sequence.raw_ptr_begin();
+        // Sequence numbers are unique, so ranking them yields the target position of every value.
+        auto target = Vec<std::uint32_t>::of(values.size());
+        for (Size i = 0; i < values.size(); i++) {
+            target[i] = static_cast<std::uint32_t>(i);
+        }
+        std::sort(target.begin(), target.end(), [seq](std::uint32_t a, std::uint32_t b) { return seq[a] < seq[b]; });
+        // `target` maps new positions to old ones; follow each cycle once.
+        std::uint32_t* from = target.raw_ptr_begin();
+        for (Size start = 0; start < values.size(); start++) {
+            if (from[start] == start) {
+                continue;
+            }
+            T val = std::move(data[start]);
+            std::uint32_t own = owner[start];
+            std::uint64_t sq = seq[start];
+            Size at = start;
+            while (from[at] != start) {
+                Size next = from[at];
+                data[at] = std::move(data[next]);
+                owner[at] = owner[next];
+                seq[at] = seq[next];
+                from[at] = static_cast<std::uint32_t>(at);
+                at = next;
+            }
+            data[at] = std::move(val);
+            owner[at] = own;
+            seq[at] = sq;
+            from[at] = static_cast<std::uint32_t>(at);
+        }
+        Slot* table = slots.raw_ptr_begin();
+        for (Size i = 0; i < values.size(); i++) {
+            table[owner[i]].index = static_cast<std::uint32_t>(i);
+        }
+    }
+
+    /// Removes all values. Every outstanding handle becomes stale.
+    auto clear() -> void {
+        while (!values.is_empty()) {
+            remove(handle_at(values.size() - 1));
+        }
+    }
+
+    /// Requests that the map be able to hold at least `n` values without reallocating.
+    auto request_cap(Size n) -> void {
+        values.request_cap(n);
+        owners.request_cap(n);
+        sequence.request_cap(n);
+        slots.request_cap(n);
+    }
+
+    /// Returns if the map is empty.
+    [[nodiscard]]
+    auto is_empty() const -> bool {
+        return values.is_empty();
+    }
+
+    /// Returns the number of live values.
+    auto size() const -> Size {
+        return values.size();
+    }
+
+    /// Returns an `Iterator` pointing to the first value in the dense storage.
+    auto begin() -> Iterator {
+        return values.begin();
+    }
+
+    /// Returns an `Iterator` pointing to the first value in the dense storage.
+    auto begin() const -> ConstIterator {
+        return values.begin();
+    }
+
+    /// Returns an `Iterator` referring to the past-the-end value in the dense storage.
+    auto end() -> Iterator {
+        return values.end();
+    }
+
+    /// Returns an `Iterator` referring to the past-the-end value in the dense storage.
+    auto end() const -> ConstIterator {
+        return values.end();
+    }
+
+    /// Send the dense values as a string to std::ostream.
+    friend auto operator<<(std::ostream& os, const SlotMap<T>& map) -> std::ostream& {
+        return os << map.values;
+    }
+};
+
+#endif //TOOLS_SLOT_MAP_H
@@ -0,0 +1,29 @@
+#include <iostream>
+
+#include "../slot_map.h"
+
+auto test() -> int {
+    auto map = SlotMap<int>();
+    auto a = map.insert(1);
+    auto b = map.insert(2);
+    auto c = map.insert(3);
+    map.remove(a);
+    auto d = map.insert(4);
+    // [3, 2, 4]
+    std::cout << map << '\n';
+    if (map.contains(a) || map.at(b) != 2 || map.at(d) != 4 || d.index != a.index) {
+        return 1;
+    }
+    map.compact();
+    // [2, 3, 4]
+    std::cout << map << '\n';
+    if (map.at(c) != 3 || *map.begin() != 2) {
+        return 1;
+    }
+    map.clear();
+    return map.contains(b) ? 1 : 0;
+}
+
+auto main() -> int {
+    return test();
+}
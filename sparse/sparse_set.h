@@ -0,0 +1,97 @@
+#ifndef TOOLS_SPARSE_SET_H
+#define TOOLS_SPARSE_SET_H
+
+#include <cstdint>
+#include <ostream>
+
+#include "../vec/vec.h"
+
+/// `SparseSet` is a set of unsigned integers drawn from [0, universe), stored as a dense `Vec` of members and a
+/// sparse `Vec` mapping each integer to its position among the members. Insertion, removal and membership tests are
+/// O(1); clearing and iteration are proportional to the number of members rather than to the universe.
+class SparseSet {
+public:
+    using Value = std::uint32_t;
+    using ConstIterator = Vec<Value>::ConstIterator;
+    using Size = Vec<Value>::Size;
+private:
+    Vec<Value> dense;
+    Vec<Value> sparse;
+public:
+    /// Constructs an empty set over the universe [0, `universe`).
+    explicit SparseSet(Size universe = 0) : sparse(Vec<Value>::of(universe)) {}
+
+    /// Adds `x` to the set, growing the universe if needed. Returns `false` if `x` was already a member.
+    auto insert(Value x) -> bool {
+        if (contains(x)) {
+            return false;
+        }
+        if (x >= sparse.size()) {
+            sparse.resize(static_cast<Size>(x) + 1);
+        }
+        sparse.raw_ptr_begin()[x] = static_cast<Value>(dense.size());
+        dense.push_back(x);
+        return true;
+    }
+
+    /// Removes `x` from the set by moving the last member into its position. Returns `false` if `x` was not a member.
+    auto remove(Value x) -> bool {
+        if (!contains(x)) {
+            return false;
+        }
+        Value* members = dense.raw_ptr_begin();
+        Value* positions = sparse.raw_ptr_begin();
+        Value last = members[dense.size() - 1];
+        members[positions[x]] = last;
+        positions[last] = positions[x];
+        dense.remove(dense.end() - 1);
+        return true;
+    }
+
+    /// Returns if `x` is a member of the set.
+    auto contains(Value x) const -> bool {
+        if (x >= sparse.size()) {
+            return false;
+        }
+        Value at = sparse.raw_ptr_begin()[x];
+        return at < dense.size() && dense.raw_ptr_begin()[at] == x;
+    }
+
+    /// Removes every member. The sparse array is left as is, since stale entries fail the membership test.
+    auto clear() -> void {
+        dense.clear();
+    }
+
+    /// Returns the size of the universe the set currently spans.
+    auto universe() const -> Size {
+        return sparse.size();
+    }
+
+    /// Returns if the set is empty.
+    [[nodiscard]]
+    auto is_empty() const -> bool {
+        return dense.is_empty();
+    }
+
+    /// Returns the number of members.
+    auto size() const -> Size {
+        return dense.size();
+    }
+
+    /// Returns a `ConstIterator` pointing to the first member, in insertion order (modulo removals).
+    auto begin() const -> ConstIterator {
+        return dense.begin();
+    }
+
+    /// Returns a `ConstIterator` referring to the past-the-end member.
+    auto end() const -> ConstIterator {
+        return dense.end();
+    }
+
+    /// Send the members as a string to std::ostream.
+    friend auto operator<<(std::ostream& os, const SparseSet& set) -> std::ostream& {
+        return os << set.dense;
+    }
+};
+
+#endif //TOOLS_SPARSE_SET_H
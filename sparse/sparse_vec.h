@@ -0,0 +1,211 @@
+#ifndef TOOLS_SPARSE_VEC_H
+#define TOOLS_SPARSE_VEC_H
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+
+#include "../vec/vec.h"
+
+/// `SparseVec` is a numeric vector of dimension `dim` that only stores its non-zero entries, as a sorted `Vec` of
+/// indices and a parallel `Vec` of values.
+template <class T>
+class SparseVec {
+public:
+    using Index = std::uint32_t;
+    using Size = typename Vec<T>::Size;
+private:
+    Size dimension = 0;
+    Vec<Index> indices;
+    Vec<T> values;
+
+    /// Returns the position of the first stored index not less than `i`.
+    auto lower_bound(Index i) const -> Size {
+        const Index* first = indices.raw_ptr_begin();
+        return static_cast<Size>(std::lower_bound(first, first + indices.size(), i) - first);
+    }
+
+    /// Merges `a` and `b`, which have the same dimension, entry by entry, combining values present in both with
+    /// `combine`.
+    template <class Combine>
+    static auto merge(const SparseVec<T>& a, const SparseVec<T>& b, T scale, Combine combine) -> SparseVec<T> {
+        auto result = SparseVec<T>(a.dimension);
+        result.indices.request_cap(a.nnz() + b.nnz());
+        result.values.request_cap(a.nnz() + b.nnz());
+        const Index* ai = a.indices.raw_ptr_begin();
+        const Index* bi = b.indices.raw_ptr_begin();
+        const T* av = a.values.raw_ptr_begin();
+        const T* bv = b.values.raw_ptr_begin();
+        Size i = 0;
+        Size j = 0;
+        while (i < a.nnz() || j < b.nnz()) {
+            if (j == b.nnz() || (i < a.nnz() && ai[i] < bi[j])) {
+                result.push_entry(ai[i], av[i]);
+                i++;
+            } else if (i == a.nnz() || bi[j] < ai[i]) {
+                result.push_entry(bi[j], combine(T(), scale * bv[j]));
+                j++;
+            } else {
+                result.push_entry(ai[i], combine(av[i], scale * bv[j]));
+                i++;
+                j++;
+            }
+        }
+        return result;
+    }
+
+    /// Appends an entry past the last stored index, dropping explicit zeros.
+    auto push_entry(Index i, const T& val) -> void {
+        if (val != T()) {
+            indices.push_back(i);
+            values.push_back(val);
+        }
+    }
+public:
+    /// Constructs a zero vector of dimension `dim`.
+    explicit SparseVec(Size dim = 0) : dimension(dim) {}
+
+    /// Constructs a sparse vector holding the non-zero entries of `dense`.
+    static auto from(const Vec<T>& dense) -> SparseVec<T> {
+        auto result = SparseVec<T>(dense.size());
+        const T* data = dense.raw_ptr_begin();
+        for (Size i = 0; i < dense.size(); i++) {
+            result.push_entry(static_cast<Index>(i), data[i]);
+        }
+        return result;
+    }
+
+    /// Returns the entry at index `i`, which is zero if not stored.
+    /// @throws IndexOutOfBounds if `i` is not less than the dimension.
+    auto get(Index i) const -> T {
+        if (i >= dimension) {
+            throw error::IndexOutOfBounds("index too large for sparse vector.");
+        }
+        Size at = lower_bound(i);
+        return at < indices.size() && indices.raw_ptr_begin()[at] == i ? values.raw_ptr_begin()[at] : T();
+    }
+
+    /// Sets the entry at index `i` to `val`. Storing a zero removes the entry. Inserting a new entry in the middle
+    /// of the vector is O(nnz); build vectors in index order (or with `from`) where possible.
+    /// @throws IndexOutOfBounds if `i` is not less than the dimension.
+    auto set(Index i, const T& val) -> void {
+        if (i >= dimension) {
+            throw error::IndexOutOfBounds("index too large for sparse vector.");
+        }
+        Size at = lower_bound(i);
+        bool stored = at < indices.size() && indices.raw_ptr_begin()[at] == i;
+        if (stored && val == T()) {
+            indices.remove(indices.begin() + at);
+            values.remove(values.begin() + at);
+        } else if (stored) {
+            values.raw_ptr_begin()[at] = val;
+        } else if (val != T()) {
+            indices.insert(indices.begin() + at, i);
+            values.insert(values.begin() + at, val);
+        }
+    }
+
+    /// Returns the dot product with the dense vector `dense`, touching only the stored entries.
+    /// @throws InvalidArgument if the dimensions differ.
+    auto dot(const Vec<T>& dense) const -> T {
+        if (dense.size() != dimension) {
+            throw error::InvalidArgument("dimension mismatch for sparse-dense dot product.");
+        }
+        const Index* idx = indices.raw_ptr_begin();
+        const T* val = values.raw_ptr_begin();
+        const T* data = dense.raw_ptr_begin();
+        T sum = T();
+        for (Size k = 0; k < indices.size(); k++) {
+            sum += val[k] * data[idx[k]];
+        }
+        return sum;
+    }
+
+    /// Returns the dot product with the sparse vector `other`, merging the two index lists.
+    /// @throws InvalidArgument if the dimensions differ.
+    auto dot(const SparseVec<T>& other) const -> T {
+        if (other.dimension != dimension) {
+            throw error::InvalidArgument("dimension mismatch for sparse dot product.");
+        }
+        const Index* ai = indices.raw_ptr_begin();
+        const Index* bi = other.indices.raw_ptr_begin();
+        Size i = 0;
+        Size j = 0;
+        T sum = T();
+        while (i < nnz() && j < other.nnz()) {
+            if (ai[i] < bi[j]) {
+                i++;
+            } else if (bi[j] < ai[i]) {
+                j++;
+            } else {
+                sum += values.raw_ptr_begin()[i++] * other.values.raw_ptr_begin()[j++];
+            }
+        }
+        return sum;
+    }
+
+    /// Adds `scale * this` into the dense vector `dense` (a scatter-add).
+    /// @throws InvalidArgument if the dimensions differ.
+    auto add_to(Vec<T>& dense, const T& scale = T(1)) const -> void {
+        if (dense.size() != dimension) {
+            throw error::InvalidArgument("dimension mismatch for sparse-dense addition.");
+        }
+        const Index* idx = indices.raw_ptr_begin();
+        const T* val = values.raw_ptr_begin();
+        T* data = dense.raw_ptr_begin();
+        for (Size k = 0; k < indices.size(); k++) {
+            data[idx[k]] += scale * val[k];
+        }
+    }
+
+    /// Returns `this + scale * other`, computed by merging the two index lists in a single pass.
+    /// @throws InvalidArgument if the dimensions differ.
+    auto merged(const SparseVec<T>& other, const T& scale = T(1)) const -> SparseVec<T> {
+        if (other.dimension != dimension) {
+            throw error::InvalidArgument("dimension mismatch for sparse addition.");
+        }
+        return merge(*this, other, scale, [](const T& a, const T& b) { return a + b; });
+    }
+
+    /// Returns the dense representation of the vector.
+    auto to_dense() const -> Vec<T> {
+        auto result = Vec<T>::of(dimension);
+        add_to(result);
+        return result;
+    }
+
+    /// Returns the dimension of the vector.
+    auto dim() const -> Size {
+        return dimension;
+    }
+
+    /// Returns the number of stored (non-zero) entries.
+    auto nnz() const -> Size {
+        return indices.size();
+    }
+
+    /// Returns the sorted indices of the stored entries.
+    auto stored_indices() const -> const Vec<Index>& {
+        return indices;
+    }
+
+    /// Returns the values of the stored entries, parallel to `stored_indices`.
+    auto stored_values() const -> const Vec<T>& {
+        return values;
+    }
+
+    /// Send the stored entries as a string of `index: value` pairs to std::ostream.
+    friend auto operator<<(std::ostream& os, const SparseVec<T>& vec) -> std::ostream& {
+        os << "{";
+        for (Size k = 0; k < vec.nnz(); k++) {
+            os << vec.indices.raw_ptr_begin()[k] << ": " << vec.values.raw_ptr_begin()[k];
+            if (k + 1 != vec.nnz()) {
+                os << ", ";
+            }
+        }
+        os << "}";
+        return os;
+    }
+};
+
+#endif //TOOLS_SPARSE_VEC_H
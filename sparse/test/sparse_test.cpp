@@ -0,0 +1,51 @@
+#include <iostream>
+
+#include "../sparse_set.h"
+#include "../sparse_vec.h"
+
+auto test_sparse_set() -> int {
+    auto set = SparseSet(16);
+    set.insert(3);
+    set.insert(7);
+    set.insert(40);
+    set.remove(3);
+    // [40, 7]
+    std::cout << set << '\n';
+    if (set.contains(3) || !set.contains(40) || set.size() != 2) {
+        return 1;
+    }
+    set.clear();
+    return set.contains(7) ? 1 : 0;
+}
+
+auto test_sparse_vec() -> int {
+    auto a = SparseVec<double>::from(Vec<double> { 0, 1, 0, 0, 2, 0 });
+    auto b = SparseVec<double>(6);
+    b.set(4, 3);
+    b.set(5, 1);
+    // {1: 1, 4: 2}
+    std::cout << a << '\n';
+    // {1: 1, 4: 5, 5: 1}
+    std::cout << a.merged(b) << '\n';
+    auto dense = Vec<double>::of(6, 1.0);
+    if (a.dot(dense) != 3 || a.dot(b) != 6 || a.merged(b, -1).get(5) != -1) {
+        return 1;
+    }
+    try {
+        a.dot(SparseVec<double>(7));
+        return 1;
+    } catch (const error::InvalidArgument&) {}
+    try {
+        a.dot(Vec<double>::of(5));
+        return 1;
+    } catch (const error::InvalidArgument&) {}
+    try {
+        a.merged(SparseVec<double>(7));
+        return 1;
+    } catch (const error::InvalidArgument&) {}
+    return a.to_dense().size() == 6 ? 0 : 1;
+}
+
+auto main() -> int {
+    return test_sparse_set() + test_sparse_vec();
+}
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <numbers>
+#include <random>
+
+#include "../kd_tree.h"
+#include "../spatial_grid.h"
+#include "../../bench/bench.h"
+#include "../../parallel/parallel.h"
+
+// k-nearest and radius queries over 1K to 10M uniform 3-D points: KdTree and SpatialGrid against a brute-force scan.
+
+using Point = spatial::Point<float, 3>;
+
+constexpr bench::Size k = 10;
+constexpr bench::Size queries = 1'000;
+/// Brute force scans about this many points in total per measurement, spread over as many queries as that allows.
+constexpr bench::Size brute_budget = 200'000'000;
+
+auto random_points(bench::Size n, std::mt19937_64& rng) -> Vec<Point> {
+    auto dist = std::uniform_real_distribution<float>(0, 1);
+    auto points = Vec<Point>();
+    points.request_cap(n);
+    for (bench::Size i = 0; i < n; i++) {
+        points.push_back(Point { dist(rng), dist(rng), dist(rng) });
+    }
+    return points;
+}
+
+/// Returns the `k` points nearest to `query` by scanning all of them with a bounded max-heap.
+auto brute_nearest(const Vec<Point>& points, const Point& query) -> Vec<spatial::Neighbour> {
+    auto heap = Vec<spatial::Neighbour>();
+    for (bench::Size i = 0; i < points.size(); i++) {
+        auto candidate = spatial::Neighbour { i, spatial::distance2(query, points.raw_ptr_begin()[i]) };
+        if (heap.size() < k) {
+            heap.push_back(candidate);
+            std::push_heap(heap.begin(), heap.end());
+        } else if (candidate < heap.raw_ptr_begin()[0]) {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.raw_ptr_begin()[k - 1] = candidate;
+            std::push_heap(heap.begin(), heap.end());
+        }
+    }
+    std::sort_heap(heap.begin(), heap.end());
+    return heap;
+}
+
+auto main() -> int {
+    std::cout << std::fixed << std::setprecision(3);
+    auto rng = std::mt19937_64(5);
+    auto probes = random_points(queries, rng);
+    for (bench::Size n : { 1'000, 10'000, 100'000, 1'000'000, 10'000'000 }) {
+        auto points = random_points(n, rng);
+        // A radius whose ball holds `k` points on average.
+        double radius = std::cbrt(static_cast<double>(k) / static_cast<double>(n) * 3 / (4 * std::numbers::pi));
+
+        auto tree = KdTree<float, 3>();
+        double build = bench::seconds([&] { tree = KdTree<float, 3>::from(points); }, 1);
+        double knn = bench::seconds([&] {
+            for (const Point& query : probes) {
+                bench::keep(tree.nearest(query, k));
+            }
+        });
+        double batch = bench::seconds([&] { bench::keep(tree.nearest_all(probes, k)); });
+        double ball = bench::seconds([&] {
+            for (const Point& query : probes) {
+                bench::keep(tree.within_radius(query, radius));
+            }
+        });
+
+        auto grid = SpatialGrid<float, 3>(2 * radius);
+        double grid_build = bench::seconds([&] {
+            for (const Point& p : points) {
+                grid.insert(p);
+            }
+        }, 1);
+        double grid_ball = bench::seconds([&] {
+            for (const Point& query : probes) {
+                bench::keep(grid.within_radius(query, radius));
+            }
+        });
+
+        // Brute force answers a prefix of the queries, which also checks the tree's answers.
+        bench::Size brute_queries = std::clamp<bench::Size>(brute_budget / n, 1, queries);
+        auto expected = Vec<Vec<spatial::Neighbour>>::of(brute_queries);
+        double brute = bench::seconds([&] {
+            for (bench::Size i = 0; i < brute_queries; i++) {
+                expected.raw_ptr_begin()[i] = brute_nearest(points, probes.raw_ptr_begin()[i]);
+            }
+        }, 1);
+        bool agree = true;
+        for (bench::Size i = 0; i < brute_queries; i++) {
+            auto found = tree.nearest(probes.raw_ptr_begin()[i], k);
+            for (bench::Size j = 0; j < k; j++) {
+                agree &= expected.raw_ptr_begin()[i].raw_ptr_begin()[j].id == found.raw_ptr_begin()[j].id;
+            }
+        }
+
+        auto us = [](double time, bench::Size count) {
+            return time / static_cast<double>(count) * 1e6;
+        };
+        std::cout << n << " points: KdTree build " << build * 1e3 << " ms, " << k << "-NN " << us(knn, queries)
+                  << " us (batched on " << parallel::hardware_threads() << " thread(s): " << us(batch, queries)
+                  << " us), radius " << us(ball, queries) << " us; SpatialGrid insert " << us(grid_build, n) * 1e3
+                  << " ns per point, radius " << us(grid_ball, queries) << " us; brute-force " << k << "-NN "
+                  << us(brute, brute_queries) << " us (" << us(brute, brute_queries) / us(knn, queries)
+                  << "x the tree)" << (agree ? "" : "; RESULTS DIFFER") << '\n';
+    }
+    return 0;
+}
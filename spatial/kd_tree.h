@@ -0,0 +1,248 @@
+#ifndef TOOLS_KD_TREE_H
+#define TOOLS_KD_TREE_H
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#include "../parallel/parallel.h"
+#include "../vec/vec.h"
+#include "point.h"
+
+/// `KdTree` is a static k-d tree over `D`-dimensional points. The tree is implicit: the points are reordered so that
+/// every range [lo, hi) has its median (by coordinate `depth % D`) at its middle, with smaller coordinates to the left
+/// and larger ones to the right. No nodes or pointers are stored, only the reordered points and their input indices.
+/// Ranges of at most `leaf_size` points are left unordered and scanned.
+template <class T, spatial::Size D>
+requires (std::is_arithmetic_v<T> && D > 0)
+class KdTree {
+public:
+    using Size = spatial::Size;
+    using Point = spatial::Point<T, D>;
+    using Neighbour = spatial::Neighbour;
+
+    static constexpr Size leaf_size = 8;
+private:
+    struct Entry {
+        Point point;
+        Size id;
+    };
+
+    Vec<Entry> entries;
+
+    /// A range still to be partitioned.
+    struct Task {
+        Size lo;
+        Size hi;
+        Size depth;
+    };
+
+    auto partition(Task task) -> Size {
+        Size mid = task.lo + (task.hi - task.lo) / 2;
+        Entry* data = entries.raw_ptr_begin();
+        Size dim = task.depth % D;
+        std::nth_element(data + task.lo, data + mid, data + task.hi,
+                         [dim](const Entry& a, const Entry& b) { return a.point[dim] < b.point[dim]; });
+        return mid;
+    }
+
+    auto build(Task task) -> void {
+        while (task.hi - task.lo > leaf_size) {
+            Size mid = partition(task);
+            build(Task{task.lo, mid, task.depth + 1});
+            task = Task{mid + 1, task.hi, task.depth + 1};
+        }
+    }
+
+    auto knn(const Point& query, Size k, Size lo, Size hi, Size depth, Vec<Neighbour>& heap) const -> void {
+        const Entry* data = entries.raw_ptr_begin();
+        auto offer = [&](const Entry& e) {
+            auto candidate = Neighbour{e.id, spatial::distance2(query, e.point)};
+            if (heap.size() < k) {
+                heap.push_back(candidate);
+                std::push_heap(heap.begin(), heap.end());
+            } else if (candidate < heap.raw_ptr_begin()[0]) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.raw_ptr_begin()[k - 1] = candidate;
+                std::push_heap(heap.begin(), heap.end());
+            }
+        };
+        while (hi - lo > leaf_size) {
+            Size mid = lo + (hi - lo) / 2;
+            offer(data[mid]);
+            double diff = static_cast<double>(query[depth % D]) - static_cast<double>(data[mid].point[depth % D]);
+            bool left_first = diff < 0;
+            Size near_lo = left_first ? lo : mid + 1;
+            Size near_hi = left_first ? mid : hi;
+            knn(query, k, near_lo, near_hi, depth + 1, heap);
+            double worst = heap.size() < k ? std::numeric_limits<double>::infinity() : heap.raw_ptr_begin()[0].distance2;
+            if (diff * diff > worst) {
+                return;
+            }
+            lo = left_first ? mid + 1 : lo;
+            hi = left_first ? hi : mid;
+            depth++;
+        }
+        for (Size i = lo; i < hi; i++) {
+            offer(data[i]);
+        }
+    }
+
+    auto within(const Point& query, double radius2, Size lo, Size hi, Size depth, Vec<Neighbour>& out) const -> void {
+        const Entry* data = entries.raw_ptr_begin();
+        while (hi - lo > leaf_size) {
+            Size mid = lo + (hi - lo) / 2;
+            double d2 = spatial::distance2(query, data[mid].point);
+            if (d2 <= radius2) {
+                out.push_back(Neighbour{data[mid].id, d2});
+            }
+            double diff = static_cast<double>(query[depth % D]) - static_cast<double>(data[mid].point[depth % D]);
+            if (diff * diff <= radius2) {
+                within(query, radius2, lo, mid, depth + 1, out);
+                lo = mid + 1;
+            } else if (diff < 0) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+            depth++;
+        }
+        for (Size i = lo; i < hi; i++) {
+            double d2 = spatial::distance2(query, data[i].point);
+            if (d2 <= radius2) {
+                out.push_back(Neighbour{data[i].id, d2});
+            }
+        }
+    }
+
+    auto in_box(const Point& lo_corner, const Point& hi_corner, Size lo, Size hi, Size depth, Vec<Size>& out) const
+        -> void {
+        const Entry* data = entries.raw_ptr_begin();
+        while (hi - lo > leaf_size) {
+            Size mid = lo + (hi - lo) / 2;
+            const Point& split = data[mid].point;
+            Size dim = depth % D;
+            if (spatial::in_box(split, lo_corner, hi_corner)) {
+                out.push_back(data[mid].id);
+            }
+            bool go_left = lo_corner[dim] <= split[dim];
+            bool go_right = split[dim] <= hi_corner[dim];
+            if (go_left && go_right) {
+                in_box(lo_corner, hi_corner, lo, mid, depth + 1, out);
+            }
+            if (go_right) {
+                lo = mid + 1;
+            } else if (go_left) {
+                hi = mid;
+            } else {
+                return;
+            }
+            depth++;
+        }
+        for (Size i = lo; i < hi; i++) {
+            if (spatial::in_box(data[i].point, lo_corner, hi_corner)) {
+                out.push_back(data[i].id);
+            }
+        }
+    }
+public:
+    KdTree() = default;
+
+    /// Builds a tree over `points`; queries identify a point by its index in `points`. The top levels are partitioned
+    /// on the calling thread until there are a few ranges per thread, and those ranges are then built in parallel.
+    static auto from(const Vec<Point>& points, Size threads = parallel::hardware_threads()) -> KdTree {
+        auto tree = KdTree();
+        tree.entries.request_cap(points.size());
+        for (Size i = 0; i < points.size(); i++) {
+            tree.entries.push_back(Entry{points.raw_ptr_begin()[i], i});
+        }
+        auto tasks = Vec<Task>();
+        tasks.push_back(Task{0, points.size(), 0});
+        Size wanted = threads > 1 ? 4 * threads : 1;
+        while (tasks.size() < wanted) {
+            auto next = Vec<Task>();
+            for (const Task& task : tasks) {
+                if (task.hi - task.lo <= leaf_size) {
+                    continue;
+                }
+                Size mid = tree.partition(task);
+                next.push_back(Task{task.lo, mid, task.depth + 1});
+                next.push_back(Task{mid + 1, task.hi, task.depth + 1});
+            }
+            if (next.is_empty()) {
+                tasks = Vec<Task>();
+                break;
+            }
+            tasks = std::move(next);
+        }
+        parallel::for_ranges(tasks.size(), threads, 1, [&](Size, Size first, Size last) {
+            for (Size i = first; i < last; i++) {
+                tree.build(tasks.raw_ptr_begin()[i]);
+            }
+        });
+        return tree;
+    }
+
+    /// Returns the number of points.
+    auto size() const -> Size {
+        return entries.size();
+    }
+
+    /// Returns the `k` points nearest to `query` in ascending order of distance (ties broken by index), or every
+    /// point if there are fewer than `k`.
+    auto nearest(const Point& query, Size k) const -> Vec<Neighbour> {
+        auto heap = Vec<Neighbour>();
+        if (k == 0) {
+            return heap;
+        }
+        heap.request_cap(std::min(k, entries.size()));
+        knn(query, k, 0, entries.size(), 0, heap);
+        std::sort_heap(heap.begin(), heap.end());
+        return heap;
+    }
+
+    /// Returns the points within `radius` of `query`, bounds included, in no particular order. A negative radius
+    /// finds nothing.
+    auto within_radius(const Point& query, double radius) const -> Vec<Neighbour> {
+        auto result = Vec<Neighbour>();
+        if (radius < 0) {
+            return result;
+        }
+        within(query, radius * radius, 0, entries.size(), 0, result);
+        return result;
+    }
+
+    /// Returns the indices of the points within the axis-aligned box [`lo`, `hi`], bounds included, in no particular
+    /// order.
+    auto within_box(const Point& lo, const Point& hi) const -> Vec<Size> {
+        auto result = Vec<Size>();
+        in_box(lo, hi, 0, entries.size(), 0, result);
+        return result;
+    }
+
+    /// Answers `nearest(queries[i], k)` for every query, spreading the queries over `threads` threads.
+    auto nearest_all(const Vec<Point>& queries, Size k, Size threads = parallel::hardware_threads()) const
+        -> Vec<Vec<Neighbour>> {
+        auto results = Vec<Vec<Neighbour>>::of(queries.size());
+        parallel::for_ranges(queries.size(), threads, 64, [&](Size, Size first, Size last) {
+            for (Size i = first; i < last; i++) {
+                results.raw_ptr_begin()[i] = nearest(queries.raw_ptr_begin()[i], k);
+            }
+        });
+        return results;
+    }
+
+    /// Answers `within_radius(queries[i], radius)` for every query, spreading the queries over `threads` threads.
+    auto within_radius_all(const Vec<Point>& queries, double radius, Size threads = parallel::hardware_threads()) const
+        -> Vec<Vec<Neighbour>> {
+        auto results = Vec<Vec<Neighbour>>::of(queries.size());
+        parallel::for_ranges(queries.size(), threads, 64, [&](Size, Size first, Size last) {
+            for (Size i = first; i < last; i++) {
+                results.raw_ptr_begin()[i] = within_radius(queries.raw_ptr_begin()[i], radius);
+            }
+        });
+        return results;
+    }
+};
+
+#endif //TOOLS_KD_TREE_H
@@ -0,0 +1,46 @@
+#ifndef TOOLS_POINT_H
+#define TOOLS_POINT_H
+
+#include <array>
+#include <cstddef>
+
+namespace spatial {
+    using Size = std::size_t;
+
+    /// A point with `D` coordinates of arithmetic type `T`.
+    template <class T, Size D>
+    using Point = std::array<T, D>;
+
+    /// A point found by a query: its index in the input and its squared distance from the query point.
+    struct Neighbour {
+        Size id;
+        double distance2;
+
+        auto operator<(const Neighbour& other) const -> bool {
+            return distance2 < other.distance2 || (distance2 == other.distance2 && id < other.id);
+        }
+    };
+
+    /// Returns the squared Euclidean distance between `a` and `b`, computed in double precision.
+    template <class T, Size D>
+    auto distance2(const Point<T, D>& a, const Point<T, D>& b) -> double {
+        double sum = 0;
+        for (Size d = 0; d < D; d++) {
+            double diff = static_cast<double>(a[d]) - static_cast<double>(b[d]);
+            sum += diff * diff;
+        }
+        return sum;
+    }
+
+    /// Returns if `p` lies within the axis-aligned box [`lo`, `hi`], bounds included.
+    template <class T, Size D>
+    auto in_box(const Point<T, D>& p, const Point<T, D>& lo, const Point<T, D>& hi) -> bool {
+        bool inside = true;
+        for (Size d = 0; d < D; d++) {
+            inside &= lo[d] <= p[d] && p[d] <= hi[d];
+        }
+        return inside;
+    }
+}
+
+#endif //TOOLS_POINT_H
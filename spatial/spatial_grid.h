@@ -0,0 +1,239 @@
+#ifndef TOOLS_SPATIAL_GRID_H
+#define TOOLS_SPATIAL_GRID_H
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <unordered_map>
+
+#include "../vec/vec.h"
+#include "point.h"
+
+namespace spatial {
+    /// The integer coordinates of a grid cell.
+    template <Size D>
+    using Cell = std::array<std::int64_t, D>;
+
+    template <Size D>
+    struct CellHash {
+        auto operator()(const Cell<D>& cell) const -> std::size_t {
+            std::uint64_t h = 0x9E3779B97F4A7C15ull;
+            for (std::int64_t c : cell) {
+                h = (h ^ static_cast<std::uint64_t>(c)) * 0xFF51AFD7ED558CCDull;
+                h ^= h >> 32;
+            }
+            return static_cast<std::size_t>(h);
+        }
+    };
+}
+
+/// `SpatialGrid` buckets moving points into a uniform grid of cubic cells of side `cell_size`. Only occupied cells are
+/// stored, in a hash map, so the grid is unbounded. Points are inserted, moved and removed in constant time, which
+/// suits dynamic scenes where rebuilding a `KdTree` every step would cost too much. Queries work best when the query
+/// radius is close to the cell size.
+template <class T, spatial::Size D>
+requires (std::is_arithmetic_v<T> && D > 0)
+class SpatialGrid {
+public:
+    using Size = spatial::Size;
+    using Point = spatial::Point<T, D>;
+    using Neighbour = spatial::Neighbour;
+private:
+    using Cell = spatial::Cell<D>;
+
+    struct Slot {
+        Point point;
+        /// The slot's position within its cell's bucket.
+        Size bucket_pos;
+        bool alive;
+    };
+
+    double cell_size;
+    Vec<Slot> slots;
+    Vec<Size> free_ids;
+    std::unordered_map<Cell, Vec<Size>, spatial::CellHash<D>> cells;
+    Size count = 0;
+
+    template <class U>
+    auto cell_of(const std::array<U, D>& p) const -> Cell {
+        Cell cell;
+        for (Size d = 0; d < D; d++) {
+            cell[d] = static_cast<std::int64_t>(std::floor(static_cast<double>(p[d]) / cell_size));
+        }
+        return cell;
+    }
+
+    auto link(Size id) -> void {
+        Vec<Size>& bucket = cells[cell_of(slots.raw_ptr_begin()[id].point)];
+        slots.raw_ptr_begin()[id].bucket_pos = bucket.size();
+        bucket.push_back(id);
+    }
+
+    auto unlink(Size id) -> void {
+        auto it = cells.find(cell_of(slots.raw_ptr_begin()[id].point));
+        Vec<Size>& bucket = it->second;
+        Size pos = slots.raw_ptr_begin()[id].bucket_pos;
+        Size last = bucket.raw_ptr_begin()[bucket.size() - 1];
+        bucket.raw_ptr_begin()[pos] = last;
+        slots.raw_ptr_begin()[last].bucket_pos = pos;
+        bucket.resize(bucket.size() - 1);
+        if (bucket.is_empty()) {
+            cells.erase(it);
+        }
+    }
+
+    auto check(Size id) const -> void {
+        if (!contains(id)) {
+            throw error::NoSuchElement("no point with this id in the grid.");
+        }
+    }
+
+    /// Calls `fn(bucket)` for every occupied cell that intersects the box [`lo`, `hi`]. When the box covers more
+    /// cells than are occupied, the occupied cells are scanned instead. An empty box, with `lo[d] > hi[d]` for some
+    /// `d`, visits nothing.
+    template <class U, class Fn>
+    auto for_each_cell(const std::array<U, D>& lo, const std::array<U, D>& hi, Fn fn) const -> void {
+        Cell first = cell_of(lo);
+        Cell last = cell_of(hi);
+        double covered = 1;
+        for (Size d = 0; d < D; d++) {
+            if (first[d] > last[d]) {
+                return;
+            }
+            covered *= static_cast<double>(last[d] - first[d] + 1);
+        }
+        if (covered > static_cast<double>(cells.size())) {
+            for (const auto& [cell, bucket] : cells) {
+                bool overlaps = true;
+                for (Size d = 0; d < D; d++) {
+                    overlaps &= first[d] <= cell[d] && cell[d] <= last[d];
+                }
+                if (overlaps) {
+                    fn(bucket);
+                }
+            }
+            return;
+        }
+        Cell cell = first;
+        while (true) {
+            if (auto it = cells.find(cell); it != cells.end()) {
+                fn(it->second);
+            }
+            Size d = 0;
+            while (d < D && cell[d] == last[d]) {
+                cell[d] = first[d];
+                d++;
+            }
+            if (d == D) {
+                return;
+            }
+            cell[d]++;
+        }
+    }
+public:
+    /// Constructs an empty grid with cells of side `cell_size`.
+    /// @throws InvalidArgument if `cell_size` is not positive.
+    explicit SpatialGrid(double cell_size) : cell_size(cell_size) {
+        if (!(cell_size > 0)) {
+            throw error::InvalidArgument("SpatialGrid cell size must be positive.");
+        }
+    }
+
+    /// Inserts `point` and returns its id. Ids of removed points are reused.
+    auto insert(const Point& point) -> Size {
+        Size id;
+        if (free_ids.is_empty()) {
+            id = slots.size();
+            slots.push_back(Slot{point, 0, true});
+        } else {
+            id = *free_ids.pop_back();
+            slots.raw_ptr_begin()[id] = Slot{point, 0, true};
+        }
+        link(id);
+        count++;
+        return id;
+    }
+
+    /// Moves the point `id` to `point`. Moves within a cell only update the coordinates.
+    /// @throws NoSuchElement if there is no point `id`.
+    auto move_to(Size id, const Point& point) -> void {
+        check(id);
+        Slot& slot = slots.raw_ptr_begin()[id];
+        if (cell_of(slot.point) == cell_of(point)) {
+            slot.point = point;
+            return;
+        }
+        unlink(id);
+        slot.point = point;
+        link(id);
+    }
+
+    /// Removes the point `id`.
+    /// @throws NoSuchElement if there is no point `id`.
+    auto remove(Size id) -> void {
+        check(id);
+        unlink(id);
+        slots.raw_ptr_begin()[id].alive = false;
+        free_ids.push_back(id);
+        count--;
+    }
+
+    /// Returns if there is a point `id`.
+    auto contains(Size id) const -> bool {
+        return id < slots.size() && slots.raw_ptr_begin()[id].alive;
+    }
+
+    /// Returns the position of the point `id`.
+    /// @throws NoSuchElement if there is no point `id`.
+    auto position(Size id) const -> const Point& {
+        check(id);
+        return slots.raw_ptr_begin()[id].point;
+    }
+
+    /// Returns the number of points.
+    auto size() const -> Size {
+        return count;
+    }
+
+    /// Returns the points within `radius` of `query`, bounds included, in no particular order. A negative radius
+    /// finds nothing.
+    auto within_radius(const Point& query, double radius) const -> Vec<Neighbour> {
+        if (radius < 0) {
+            return Vec<Neighbour>();
+        }
+        std::array<double, D> lo;
+        std::array<double, D> hi;
+        for (Size d = 0; d < D; d++) {
+            lo[d] = static_cast<double>(query[d]) - radius;
+            hi[d] = static_cast<double>(query[d]) + radius;
+        }
+        auto result = Vec<Neighbour>();
+        double radius2 = radius * radius;
+        for_each_cell(lo, hi, [&](const Vec<Size>& bucket) {
+            for (Size id : bucket) {
+                double d2 = spatial::distance2(query, slots.raw_ptr_begin()[id].point);
+                if (d2 <= radius2) {
+                    result.push_back(Neighbour{id, d2});
+                }
+            }
+        });
+        return result;
+    }
+
+    /// Returns the ids of the points within the axis-aligned box [`lo`, `hi`], bounds included, in no particular
+    /// order.
+    auto within_box(const Point& lo, const Point& hi) const -> Vec<Size> {
+        auto result = Vec<Size>();
+        for_each_cell(lo, hi, [&](const Vec<Size>& bucket) {
+            for (Size id : bucket) {
+                if (spatial::in_box(slots.raw_ptr_begin()[id].point, lo, hi)) {
+                    result.push_back(id);
+                }
+            }
+        });
+        return result;
+    }
+};
+
+#endif //TOOLS_SPATIAL_GRID_H
@@ -0,0 +1,46 @@
+#include <iostream>
+
+#include "../kd_tree.h"
+#include "../spatial_grid.h"
+
+auto test() -> int {
+    // A 10x10 lattice of points; point i sits at (i % 10, i / 10).
+    auto points = Vec<spatial::Point<double, 2>>();
+    for (int i = 0; i < 100; i++) {
+        points.push_back({ double(i % 10), double(i / 10) });
+    }
+    auto tree = KdTree<double, 2>::from(points, 2);
+    auto nearest = tree.nearest({ 4.2, 6.9 }, 3);
+    // nearest 74 75 64
+    std::cout << "nearest " << nearest.at(0).id << ' ' << nearest.at(1).id << ' ' << nearest.at(2).id << '\n';
+    if (nearest.at(0).id != 74 || nearest.at(1).id != 75 || nearest.at(2).id != 64) {
+        return 1;
+    }
+    // The point itself and its four lattice neighbours.
+    if (tree.within_radius({ 5, 5 }, 1).size() != 5 || tree.within_box({ 2, 2 }, { 4, 3 }).size() != 6) {
+        return 1;
+    }
+    auto batch = tree.nearest_all(Vec<spatial::Point<double, 2>> { { 0, 0 }, { 9.4, 9.4 } }, 1, 2);
+    if (batch.at(0).at(0).id != 0 || batch.at(1).at(0).id != 99) {
+        return 1;
+    }
+
+    auto grid = SpatialGrid<double, 2>(1.5);
+    auto a = grid.insert({ 0, 0 });
+    auto b = grid.insert({ 10, 10 });
+    grid.move_to(b, { 0.5, 0.5 });
+    grid.remove(a);
+    auto found = grid.within_radius({ 0, 0 }, 1);
+    // An inverted box or a negative radius is empty rather than an endless walk over cells.
+    if (!grid.within_box({ 5, 5 }, { -5, -5 }).is_empty() || !grid.within_radius({ 0, 0 }, -1).is_empty()
+        || !tree.within_box({ 4, 3 }, { 2, 2 }).is_empty() || !tree.within_radius({ 5, 5 }, -1).is_empty()) {
+        return 1;
+    }
+    // grid 1 point(s)
+    std::cout << "grid " << found.size() << " point(s)\n";
+    return found.size() == 1 && found.at(0).id == b && grid.within_box({ 9, 9 }, { 11, 11 }).is_empty() ? 0 : 1;
+}
+
+auto main() -> int {
+    return test();
+}
@@ -0,0 +1,225 @@
+#ifndef TOOLS_BIT_VECTOR_H
+#define TOOLS_BIT_VECTOR_H
+
+#include <bit>
+#include <cstdint>
+#include <ostream>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+#include "../vec/vec.h"
+
+namespace succinct {
+    using Size = std::size_t;
+
+    /// Returns the position of the `k`th (0-based) set bit of `word`, which must have more than `k` set bits.
+    inline auto select_in_word(std::uint64_t word, unsigned k) -> unsigned {
+#if defined(__BMI2__)
+        return static_cast<unsigned>(std::countr_zero(_pdep_u64(std::uint64_t(1) << k, word)));
+#else
+        unsigned base = 0;
+        for (unsigned ones = std::popcount(word & 0xFF); ones <= k; ones = std::popcount(word & 0xFF)) {
+            k -= ones;
+            word >>= 8;
+            base += 8;
+        }
+        for (; k > 0; k--) {
+            word &= word - 1;
+        }
+        return base + static_cast<unsigned>(std::countr_zero(word));
+#endif
+    }
+}
+
+/// `BitVector` is an immutable bit sequence with constant-time rank and near-constant-time select. Besides the bits
+/// themselves, it stores the number of ones before every 512-bit block (12.5% extra space) and the block holding
+/// every 512th one and zero (at most 12.5% more), so queries scan at most one block's eight words.
+class BitVector {
+public:
+    using Size = succinct::Size;
+private:
+    static constexpr Size block_words = 8;
+    static constexpr Size block_bits = block_words * 64;
+    static constexpr Size sample_rate = 512;
+
+    Vec<std::uint64_t> words;
+    Size length = 0;
+    /// The number of ones before each block, plus a final entry holding the total.
+    Vec<std::uint64_t> block_ranks;
+    /// The block holding the (i * sample_rate)th one, and the same for zeros.
+    Vec<std::uint32_t> one_samples;
+    Vec<std::uint32_t> zero_samples;
+
+    auto ones_before_block(Size block, bool bit) const -> Size {
+        Size ones = block_ranks.raw_ptr_begin()[block];
+        return bit ? ones : block * block_bits - ones;
+    }
+
+    /// Returns the position of the `k`th one (if `bit`) or zero.
+    auto select(Size k, bool bit) const -> Size {
+        if (k >= (bit ? count_ones() : length - count_ones())) {
+            throw error::IndexOutOfBounds("select past the last matching bit.");
+        }
+        const Vec<std::uint32_t>& samples = bit ? one_samples : zero_samples;
+        // The sample bounds the search to the blocks between two sampled positions.
+        Size block = samples.raw_ptr_begin()[k / sample_rate];
+        Size last = k / sample_rate + 1 < samples.size() ? samples.raw_ptr_begin()[k / sample_rate + 1]
+                                                         : block_ranks.size() - 2;
+        while (block < last && ones_before_block(block + 1, bit) <= k) {
+            block++;
+        }
+        k -= ones_before_block(block, bit);
+        const std::uint64_t* data = words.raw_ptr_begin();
+        for (Size w = block * block_words; ; w++) {
+            std::uint64_t word = bit ? data[w] : ~data[w];
+            auto ones = static_cast<Size>(std::popcount(word));
+            if (k < ones) {
+                return w * 64 + succinct::select_in_word(word, static_cast<unsigned>(k));
+            }
+            k -= ones;
+        }
+    }
+
+    /// Builds the rank and select directories over `words`.
+    auto index() -> void {
+        // Pad to whole blocks so that rank and select never read past the end.
+        Size blocks = (length + block_bits - 1) / block_bits;
+        words.resize(std::max<Size>(blocks, 1) * block_words);
+        block_ranks = Vec<std::uint64_t>();
+        block_ranks.request_cap(blocks + 1);
+        one_samples = Vec<std::uint32_t>();
+        zero_samples = Vec<std::uint32_t>();
+        const std::uint64_t* data = words.raw_ptr_begin();
+        Size ones = 0;
+        for (Size b = 0; b < blocks; b++) {
+            block_ranks.push_back(ones);
+            Size block_ones = 0;
+            for (Size w = b * block_words; w < (b + 1) * block_words; w++) {
+                block_ones += std::popcount(data[w]);
+            }
+            Size zeros_before = b * block_bits - ones;
+            Size valid_bits = std::min(block_bits, length - b * block_bits);
+            Size block_zeros = valid_bits - block_ones;
+            // Record this block for every sampled one and zero falling inside it.
+            while (one_samples.size() * sample_rate < ones + block_ones) {
+                one_samples.push_back(static_cast<std::uint32_t>(b));
+            }
+            while (zero_samples.size() * sample_rate < zeros_before + block_zeros) {
+                zero_samples.push_back(static_cast<std::uint32_t>(b));
+            }
+            ones += block_ones;
+        }
+        block_ranks.push_back(ones);
+    }
+public:
+    /// Constructs an empty bit vector.
+    BitVector() {
+        index();
+    }
+
+    /// Constructs a bit vector holding the first `n` bits of `bits`, where bit `i` is bit `i % 64` of word `i / 64`.
+    /// Bits past `n` are ignored.
+    /// @throws IndexOutOfBounds if `bits` holds fewer than `n` bits.
+    static auto from_words(Vec<std::uint64_t> bits, Size n) -> BitVector {
+        if (bits.size() * 64 < n) {
+            throw error::IndexOutOfBounds("too few words for bit vector of requested size.");
+        }
+        auto result = BitVector();
+        result.words = std::move(bits);
+        result.length = n;
+        result.words.resize((n + 63) / 64);
+        if (n % 64 != 0) {
+            result.words.raw_ptr_begin()[n / 64] &= (std::uint64_t(1) << (n % 64)) - 1;
+        }
+        result.index();
+        return result;
+    }
+
+    /// Constructs a bit vector holding a copy of each of the elements in `bits`, in the same order.
+    static auto from(const Vec<bool>& bits) -> BitVector {
+        auto packed = Vec<std::uint64_t>::of((bits.size() + 63) / 64);
+        Size i = 0;
+        for (bool bit : bits) {
+            packed.raw_ptr_begin()[i / 64] |= std::uint64_t(bit) << (i % 64);
+            i++;
+        }
+        return from_words(std::move(packed), bits.size());
+    }
+
+    /// Returns bit `i`.
+    /// @throws IndexOutOfBounds if attempting to access a bit at an invalid index.
+    auto get(Size i) const -> bool {
+        if (i >= length) {
+            throw error::IndexOutOfBounds("index too large for bit vector.");
+        }
+        return (words.raw_ptr_begin()[i / 64] >> (i % 64)) & 1;
+    }
+
+    /// Returns the number of ones in positions [0, `i`).
+    /// @throws IndexOutOfBounds if `i` is greater than the size.
+    auto rank1(Size i) const -> Size {
+        if (i > length) {
+            throw error::IndexOutOfBounds("rank past the end of bit vector.");
+        }
+        Size block = i / block_bits;
+        Size result = block_ranks.raw_ptr_begin()[block];
+        const std::uint64_t* data = words.raw_ptr_begin();
+        for (Size w = block * block_words; w < i / 64; w++) {
+            result += std::popcount(data[w]);
+        }
+        if (i % 64 != 0) {
+            result += std::popcount(data[i / 64] & ((std::uint64_t(1) << (i % 64)) - 1));
+        }
+        return result;
+    }
+
+    /// Returns the number of zeros in positions [0, `i`).
+    /// @throws IndexOutOfBounds if `i` is greater than the size.
+    auto rank0(Size i) const -> Size {
+        return i - rank1(i);
+    }
+
+    /// Returns the position of the `k`th (0-based) one.
+    /// @throws IndexOutOfBounds if there are not more than `k` ones.
+    auto select1(Size k) const -> Size {
+        return select(k, true);
+    }
+
+    /// Returns the position of the `k`th (0-based) zero.
+    /// @throws IndexOutOfBounds if there are not more than `k` zeros.
+    auto select0(Size k) const -> Size {
+        return select(k, false);
+    }
+
+    /// Returns the number of ones.
+    auto count_ones() const -> Size {
+        return block_ranks.raw_ptr_begin()[block_ranks.size() - 1];
+    }
+
+    /// Returns the number of bits.
+    auto size() const -> Size {
+        return length;
+    }
+
+    /// Returns the packed bits, 64 per word; words past the size are zero.
+    auto raw_words() const -> const Vec<std::uint64_t>& {
+        return words;
+    }
+
+    /// Returns the number of bits of memory used by the bits and their directories.
+    auto size_in_bits() const -> Size {
+        return 64 * (words.size() + block_ranks.size()) + 32 * (one_samples.size() + zero_samples.size());
+    }
+
+    /// Send the bits as a string of 0s and 1s to std::ostream.
+    friend auto operator<<(std::ostream& os, const BitVector& bits) -> std::ostream& {
+        for (Size i = 0; i < bits.length; i++) {
+            os << bits.get(i);
+        }
+        return os;
+    }
+};
+
+#endif //TOOLS_BIT_VECTOR_H
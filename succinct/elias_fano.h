@@ -0,0 +1,210 @@
+#ifndef TOOLS_ELIAS_FANO_H
+#define TOOLS_ELIAS_FANO_H
+
+#include <bit>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <ostream>
+
+#include "../vec/vec.h"
+#include "bit_vector.h"
+
+/// `EliasFano` is an immutable, compressed encoding of a non-decreasing sequence of `n` integers below `u`, using
+/// about `n * (2 + log2(u / n))` bits, within a few percent of the information-theoretic minimum. Each value is split
+/// into `low_bits` low bits, stored verbatim, and the remaining high bits, stored in unary as gaps in a `BitVector`
+/// whose select queries give random access.
+class EliasFano {
+public:
+    using Size = succinct::Size;
+    using Value = std::uint64_t;
+private:
+    Size length = 0;
+    unsigned low_bits = 0;
+    Vec<std::uint64_t> lows;
+    /// Value `i` sets bit `(value >> low_bits) + i`.
+    BitVector highs;
+
+    auto low(Size i) const -> Value {
+        if (low_bits == 0) {
+            return 0;
+        }
+        const std::uint64_t* data = lows.raw_ptr_begin();
+        Size bit = i * low_bits;
+        Value result = data[bit / 64] >> (bit % 64);
+        if (bit % 64 + low_bits > 64) {
+            result |= data[bit / 64 + 1] << (64 - bit % 64);
+        }
+        return result & ((Value(1) << low_bits) - 1);
+    }
+
+    /// Returns the position of the first set bit of `highs` at or after `from`, which must exist.
+    auto next_one(Size from) const -> Size {
+        const std::uint64_t* words = highs.raw_words().raw_ptr_begin();
+        Size w = from / 64;
+        std::uint64_t word = words[w] & (~std::uint64_t(0) << (from % 64));
+        while (word == 0) {
+            word = words[++w];
+        }
+        return w * 64 + static_cast<Size>(std::countr_zero(word));
+    }
+public:
+    /// A forward iterator over the values, decoding the high bits sequentially instead of with select.
+    class ConstIterator {
+        friend class EliasFano;
+
+        const EliasFano* sequence = nullptr;
+        Size index = 0;
+        /// The position of the set bit in `highs` that encodes value `index`.
+        Size position = 0;
+
+        ConstIterator(const EliasFano* owner, Size i, Size at) : sequence(owner), index(i), position(at) {}
+    public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = Value;
+        using iterator_category = std::forward_iterator_tag;
+
+        ConstIterator() = default;
+
+        auto operator*() const -> Value {
+            return ((position - index) << sequence->low_bits) | sequence->low(index);
+        }
+
+        auto operator++() -> ConstIterator& {
+            if (++index < sequence->length) {
+                position = sequence->next_one(position + 1);
+            }
+            return *this;
+        }
+
+        auto operator++(int) -> ConstIterator {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        auto operator==(const ConstIterator& other) const -> bool {
+            return index == other.index;
+        }
+    };
+
+    /// Constructs an empty sequence.
+    EliasFano() = default;
+
+    /// Encodes the non-decreasing `values`.
+    /// @throws InvalidArgument if `values` is not sorted.
+    static auto from(const Vec<Value>& values) -> EliasFano {
+        const Value* data = values.raw_ptr_begin();
+        Size n = values.size();
+        for (Size i = 1; i < n; i++) {
+            if (data[i] < data[i - 1]) {
+                throw error::InvalidArgument("Elias-Fano values must be non-decreasing.");
+            }
+        }
+        auto result = EliasFano();
+        result.length = n;
+        if (n == 0) {
+            return result;
+        }
+        // floor(log2(max / n)) low bits; no `max + 1`, which would wrap for a maximum of UINT64_MAX. The high part,
+        // `max >> low_bits`, is then below 2n, so `high_size` cannot overflow.
+        Value ratio = data[n - 1] / n;
+        result.low_bits = ratio > 0 ? static_cast<unsigned>(std::bit_width(ratio) - 1) : 0;
+        result.lows = Vec<std::uint64_t>::of((n * result.low_bits + 63) / 64 + 1);
+        Size high_size = n + (data[n - 1] >> result.low_bits) + 1;
+        auto high = Vec<std::uint64_t>::of((high_size + 63) / 64);
+        std::uint64_t* low_words = result.lows.raw_ptr_begin();
+        Value mask = result.low_bits == 0 ? 0 : (Value(1) << result.low_bits) - 1;
+        for (Size i = 0; i < n; i++) {
+            Size bit = i * result.low_bits;
+            Value low = data[i] & mask;
+            if (result.low_bits != 0) {
+                low_words[bit / 64] |= low << (bit % 64);
+                if (bit % 64 + result.low_bits > 64) {
+                    low_words[bit / 64 + 1] |= low >> (64 - bit % 64);
+                }
+            }
+            Size position = (data[i] >> result.low_bits) + i;
+            high.raw_ptr_begin()[position / 64] |= std::uint64_t(1) << (position % 64);
+        }
+        result.highs = BitVector::from_words(std::move(high), high_size);
+        return result;
+    }
+
+    /// Returns value `i`.
+    /// @throws IndexOutOfBounds if attempting to access a value at an invalid index.
+    auto at(Size i) const -> Value {
+        if (i >= length) {
+            throw error::IndexOutOfBounds("index too large for Elias-Fano sequence.");
+        }
+        return ((highs.select1(i) - i) << low_bits) | low(i);
+    }
+
+    /// Returns the index of the first value not less than `x`, or `std::nullopt` if every value is less than `x`.
+    /// The high bits of `x` locate its bucket with one select; only the values in that bucket are decoded.
+    auto next_geq_index(Value x) const -> std::optional<Size> {
+        Value bucket = x >> low_bits;
+        if (bucket >= highs.size() - length) {
+            return std::nullopt;
+        }
+        // Bucket `b` starts after the `b`th zero, and the ones before it are the values in earlier buckets.
+        Size start = bucket == 0 ? 0 : highs.select0(bucket - 1) + 1;
+        Size i = start - bucket;
+        if (i == length) {
+            return std::nullopt;
+        }
+        for (auto iter = ConstIterator(this, i, next_one(start)); iter != end(); ++iter) {
+            if (*iter >= x) {
+                return iter.index;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// Returns the first value not less than `x`, or `std::nullopt` if every value is less than `x`.
+    auto next_geq(Value x) const -> std::optional<Value> {
+        auto i = next_geq_index(x);
+        return i ? std::optional<Value>(at(*i)) : std::nullopt;
+    }
+
+    /// Returns a `ConstIterator` pointing to the first value.
+    auto begin() const -> ConstIterator {
+        return ConstIterator(this, 0, length == 0 ? 0 : highs.select1(0));
+    }
+
+    /// Returns a `ConstIterator` referring to the past-the-end value.
+    auto end() const -> ConstIterator {
+        return ConstIterator(this, length, 0);
+    }
+
+    /// Returns if the sequence is empty.
+    [[nodiscard]]
+    auto is_empty() const -> bool {
+        return length == 0;
+    }
+
+    /// Returns the number of values.
+    auto size() const -> Size {
+        return length;
+    }
+
+    /// Returns the number of bits of memory used by the encoding, including the select directories.
+    auto size_in_bits() const -> Size {
+        return 64 * lows.size() + highs.size_in_bits();
+    }
+
+    /// Send the values as a string to std::ostream.
+    friend auto operator<<(std::ostream& os, const EliasFano& sequence) -> std::ostream& {
+        os << "[";
+        for (auto iter = sequence.begin(); iter != sequence.end();) {
+            os << *iter;
+            if (++iter != sequence.end()) {
+                os << ", ";
+            }
+        }
+        os << "]";
+        return os;
+    }
+};
+
+#endif //TOOLS_ELIAS_FANO_H
@@ -0,0 +1,38 @@
+#include <cstdint>
+#include <iostream>
+
+#include "../bit_vector.h"
+#include "../elias_fano.h"
+
+auto test_bit_vector() -> int {
+    auto bits = BitVector::from(Vec<bool> { true, false, false, true, true, false, true });
+    // 1001101
+    std::cout << bits << '\n';
+    if (bits.rank1(4) != 2 || bits.rank0(7) != 3 || bits.select1(2) != 4 || bits.select0(2) != 5) {
+        return 1;
+    }
+    auto words = Vec<std::uint64_t>::of(100, 0x8000000000000001ull);
+    auto large = BitVector::from_words(words, 6400);
+    return large.rank1(6400) == 200 && large.select1(199) == 6399 && large.select0(0) == 1 ? 0 : 1;
+}
+
+auto test_elias_fano() -> int {
+    auto sequence = EliasFano::from(Vec<std::uint64_t> { 2, 3, 5, 7, 11, 13, 24, 1000 });
+    // [2, 3, 5, 7, 11, 13, 24, 1000]
+    std::cout << sequence << '\n';
+    if (sequence.at(6) != 24 || sequence.next_geq(14) != 24 || sequence.next_geq(1001).has_value()) {
+        return 1;
+    }
+    // The largest value is a valid value.
+    constexpr std::uint64_t max = ~std::uint64_t(0);
+    auto single = EliasFano::from(Vec<std::uint64_t> { max });
+    auto extremes = EliasFano::from(Vec<std::uint64_t> { 0, max, max });
+    if (single.at(0) != max || extremes.at(0) != 0 || extremes.at(2) != max || extremes.next_geq(1) != max) {
+        return 1;
+    }
+    return sequence.next_geq(0) == 2 ? 0 : 1;
+}
+
+auto main() -> int {
+    return test_bit_vector() + test_elias_fano();
+}
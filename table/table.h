@@ -0,0 +1,313 @@
+#ifndef TOOLS_TABLE_H
+#define TOOLS_TABLE_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+
+#include "../parallel/parallel.h"
+#include "../vec/vec.h"
+
+namespace table {
+    using Size = std::size_t;
+    /// The position of a row in a table.
+    using Row = std::uint32_t;
+    /// A list of row positions, such as the rows that passed a filter or a sort order.
+    using Selection = Vec<Row>;
+
+    /// A read-only window over a contiguous range of a column's values. Copies nothing.
+    template <class T>
+    class ColumnView {
+    private:
+        const T* first;
+        Size count;
+    public:
+        ColumnView(const T* data, Size size) : first(data), count(size) {}
+
+        auto operator[](Size i) const -> const T& {
+            return first[i];
+        }
+
+        auto begin() const -> const T* {
+            return first;
+        }
+
+        auto end() const -> const T* {
+            return first + count;
+        }
+
+        auto size() const -> Size {
+            return count;
+        }
+    };
+
+    /// The type-erased interface of a column, for the operations that treat every column alike.
+    class ColumnBase {
+    public:
+        virtual ~ColumnBase() = default;
+
+        virtual auto type() const -> const std::type_info& = 0;
+
+        /// Returns a new column holding the values at `rows`, in order.
+        virtual auto take(const Selection& rows) const -> std::unique_ptr<ColumnBase> = 0;
+
+        /// Compares the values at rows `a` and `b`, returning a negative, zero or positive number.
+        virtual auto compare(Row a, Row b) const -> int = 0;
+
+        virtual auto print(std::ostream& os, Size row) const -> void = 0;
+    };
+
+    template <class T>
+    class Column : public ColumnBase {
+    public:
+        Vec<T> values;
+
+        explicit Column(Vec<T> vals) : values(std::move(vals)) {}
+
+        auto type() const -> const std::type_info& override {
+            return typeid(T);
+        }
+
+        auto take(const Selection& rows) const -> std::unique_ptr<ColumnBase> override {
+            auto result = Vec<T>();
+            result.request_cap(rows.size());
+            const T* data = values.raw_ptr_begin();
+            for (Row row : rows) {
+                result.push_back(data[row]);
+            }
+            return std::make_unique<Column<T>>(std::move(result));
+        }
+
+        auto compare(Row a, Row b) const -> int override {
+            const T* data = values.raw_ptr_begin();
+            return data[a] < data[b] ? -1 : data[b] < data[a] ? 1 : 0;
+        }
+
+        auto print(std::ostream& os, Size row) const -> void override {
+            os << values.raw_ptr_begin()[row];
+        }
+    };
+
+    /// A sort key: a column name and a direction.
+    struct Order {
+        std::string column;
+        bool descending = false;
+    };
+}
+
+/// `Table` is a columnar table: a list of named columns, each a typed `Vec` of the same length. Columns are accessed
+/// directly (no copy), filters produce selection vectors of matching rows, sorts produce permutations, and column
+/// expressions are evaluated in parallel chunks of rows.
+class Table {
+public:
+    using Size = table::Size;
+    using Row = table::Row;
+    using Selection = table::Selection;
+private:
+    Vec<std::string> names;
+    std::unordered_map<std::string, std::unique_ptr<table::ColumnBase>> columns;
+    Size row_count = 0;
+
+    auto base(const std::string& name) const -> const table::ColumnBase& {
+        auto found = columns.find(name);
+        if (found == columns.end()) {
+            throw error::NoSuchElement("no column with that name.");
+        }
+        return *found->second;
+    }
+
+    template <class T>
+    auto typed(const std::string& name) const -> const table::Column<T>& {
+        const table::ColumnBase& col = base(name);
+        if (col.type() != typeid(T)) {
+            throw error::InvalidArgument("column does not hold the requested type.");
+        }
+        return static_cast<const table::Column<T>&>(col);
+    }
+
+    auto add(const std::string& name, std::unique_ptr<table::ColumnBase> col, Size size) -> void {
+        if (columns.count(name)) {
+            throw error::InvalidArgument("a column with that name already exists.");
+        }
+        if (!names.is_empty() && size != row_count) {
+            throw error::InvalidArgument("column length does not match the table.");
+        }
+        row_count = size;
+        names.push_back(name);
+        columns.emplace(name, std::move(col));
+    }
+public:
+    /// Constructs an empty table.
+    Table() = default;
+
+    /// Appends the column `name` holding `values`.
+    /// @throws InvalidArgument if the name is taken or the length differs from the other columns.
+    template <class T>
+    auto add_column(const std::string& name, Vec<T> values) -> void {
+        Size size = values.size();
+        add(name, std::make_unique<table::Column<T>>(std::move(values)), size);
+    }
+
+    /// Returns the values of column `name`.
+    /// @throws NoSuchElement if there is no such column.
+    /// @throws InvalidArgument if the column does not hold values of type `T`.
+    template <class T>
+    auto column(const std::string& name) const -> const Vec<T>& {
+        return typed<T>(name).values;
+    }
+
+    /// Returns the values of column `name` for modification. The length must not be changed.
+    /// @throws NoSuchElement if there is no such column.
+    /// @throws InvalidArgument if the column does not hold values of type `T`.
+    template <class T>
+    auto column_mut(const std::string& name) -> Vec<T>& {
+        return const_cast<table::Column<T>&>(typed<T>(name)).values;
+    }
+
+    /// Returns a view of the rows [`first`, `last`) of column `name`.
+    /// @throws IndexOutOfBounds if the range is not within the table.
+    template <class T>
+    auto rows(const std::string& name, Size first, Size last) const -> table::ColumnView<T> {
+        if (first > last || last > row_count) {
+            throw error::IndexOutOfBounds("invalid row range for table.");
+        }
+        return table::ColumnView<T>(column<T>(name).raw_ptr_begin() + first, last - first);
+    }
+
+    /// Returns the rows whose value in column `name` satisfies `pred`. The loop writes every row position and only
+    /// advances past it when `pred` holds, so it runs without a branch per row.
+    template <class T, class Pred>
+    auto filter(const std::string& name, Pred pred) const -> Selection {
+        auto result = Selection::of(row_count);
+        Row* out = result.raw_ptr_begin();
+        const T* data = column<T>(name).raw_ptr_begin();
+        Size kept = 0;
+        for (Size row = 0; row < row_count; row++) {
+            out[kept] = static_cast<Row>(row);
+            kept += static_cast<bool>(pred(data[row]));
+        }
+        result.resize(kept);
+        return result;
+    }
+
+    /// Returns the rows of `selection` whose value in column `name` also satisfies `pred`, for chaining filters.
+    template <class T, class Pred>
+    auto refine(const Selection& selection, const std::string& name, Pred pred) const -> Selection {
+        auto result = Selection::of(selection.size());
+        Row* out = result.raw_ptr_begin();
+        const Row* in = selection.raw_ptr_begin();
+        const T* data = column<T>(name).raw_ptr_begin();
+        Size kept = 0;
+        for (Size i = 0; i < selection.size(); i++) {
+            out[kept] = in[i];
+            kept += static_cast<bool>(pred(data[in[i]]));
+        }
+        result.resize(kept);
+        return result;
+    }
+
+    /// Returns the permutation of rows that sorts the table by `keys`, in order of priority. The sort is stable.
+    /// @throws NoSuchElement if a key names no column.
+    auto sort_by(const Vec<table::Order>& keys) const -> Selection {
+        auto order = Vec<std::pair<const table::ColumnBase*, bool>>();
+        for (const auto& key : keys) {
+            order.push_back({ &base(key.column), key.descending });
+        }
+        auto result = Selection::of(row_count);
+        for (Size row = 0; row < row_count; row++) {
+            result.raw_ptr_begin()[row] = static_cast<Row>(row);
+        }
+        std::stable_sort(result.begin(), result.end(), [&order](Row a, Row b) {
+            for (const auto& [col, descending] : order) {
+                int cmp = col->compare(a, b);
+                if (cmp != 0) {
+                    return descending ? cmp > 0 : cmp < 0;
+                }
+            }
+            return false;
+        });
+        return result;
+    }
+
+    /// Returns a new table holding the rows at `selection` (a filter result or a sort permutation), in order.
+    /// @throws IndexOutOfBounds if a selected row is not within the table.
+    auto take(const Selection& selection) const -> Table {
+        for (Row row : selection) {
+            if (row >= row_count) {
+                throw error::IndexOutOfBounds("selected row outside of table.");
+            }
+        }
+        auto result = Table();
+        for (const auto& name : names) {
+            result.add(name, columns.at(name)->take(selection), selection.size());
+        }
+        if (names.is_empty()) {
+            result.row_count = selection.size();
+        }
+        return result;
+    }
+
+    /// Appends the column `output` whose value in each row is `fn` applied to that row's values in the columns
+    /// `inputs` (of types `Ts`). Rows are split into chunks evaluated on `threads` threads.
+    /// @throws NoSuchElement if an input names no column.
+    /// @throws InvalidArgument if an input does not hold its type, or `output` is taken.
+    template <class U, class... Ts, class Fn>
+    auto compute(const std::string& output, const std::array<std::string, sizeof...(Ts)>& inputs, Fn fn,
+                 Size threads = 1) -> void {
+        auto result = Vec<U>::of(row_count);
+        U* out = result.raw_ptr_begin();
+        std::tuple<const Ts*...> data = [&]<std::size_t... I>(std::index_sequence<I...>) {
+            return std::tuple<const Ts*...>(column<Ts>(inputs[I]).raw_ptr_begin()...);
+        }(std::index_sequence_for<Ts...>());
+        parallel::for_ranges(row_count, threads, 4096, [=](Size, Size first, Size last) {
+            for (Size row = first; row < last; row++) {
+                out[row] = std::apply([row, &fn](const Ts*... cols) { return fn(cols[row]...); }, data);
+            }
+        });
+        add_column(output, std::move(result));
+    }
+
+    /// Returns the names of the columns, in order.
+    auto column_names() const -> const Vec<std::string>& {
+        return names;
+    }
+
+    /// Returns if the table has a column named `name`.
+    auto has_column(const std::string& name) const -> bool {
+        return columns.count(name) != 0;
+    }
+
+    /// Returns the number of rows.
+    auto size() const -> Size {
+        return row_count;
+    }
+
+    /// Returns the number of columns.
+    auto width() const -> Size {
+        return names.size();
+    }
+
+    /// Send the table as a string, one row per line, to std::ostream.
+    friend auto operator<<(std::ostream& os, const Table& tab) -> std::ostream& {
+        for (Size i = 0; i < tab.names.size(); i++) {
+            os << (i == 0 ? "" : ", ") << tab.names.raw_ptr_begin()[i];
+        }
+        for (Size row = 0; row < tab.row_count; row++) {
+            os << '\n';
+            for (Size i = 0; i < tab.names.size(); i++) {
+                os << (i == 0 ? "" : ", ");
+                tab.columns.at(tab.names.raw_ptr_begin()[i])->print(os, row);
+            }
+        }
+        return os;
+    }
+};
+
+#endif //TOOLS_TABLE_H
@@ -0,0 +1,29 @@
+#include <iostream>
+#include <string>
+
+#include "../table.h"
+
+auto test() -> int {
+    auto tab = Table();
+    tab.add_column("item", Vec<std::string> { "pen", "ink", "pad", "nib" });
+    tab.add_column("price", Vec<double> { 1.5, 7.25, 3.0, 0.5 });
+    tab.add_column("qty", Vec<int> { 10, 2, 0, 40 });
+    tab.compute<double, double, int>("total", { "price", "qty" }, [](double p, int q) { return p * q; }, 2);
+
+    auto in_stock = tab.filter<int>("qty", [](int q) { return q > 0; });
+    auto cheap = tab.refine<double>(in_stock, "price", [](double p) { return p < 5; });
+    auto sorted = tab.take(cheap).sort_by(Vec<table::Order> { { "total", true } });
+    // item, price, qty, total
+    // nib, 0.5, 40, 20
+    // pen, 1.5, 10, 15
+    std::cout << tab.take(cheap).take(sorted) << '\n';
+    if (cheap.size() != 2 || tab.column<double>("total").at(1) != 14.5) {
+        return 1;
+    }
+    auto middle = tab.rows<int>("qty", 1, 3);
+    return middle.size() == 2 && middle[0] == 2 ? 0 : 1;
+}
+
+auto main() -> int {
+    return test();
+}
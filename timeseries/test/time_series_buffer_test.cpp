@@ -0,0 +1,29 @@
+#include <iostream>
+
+#include "../time_series_buffer.h"
+
+auto test() -> int {
+    // Raw samples for the last 8 pushes; tiers of 4 and 16 samples, 8 buckets each.
+    auto buffer = TimeSeriesBuffer<int>(8, 4, 2, 8);
+    for (int i = 0; i < 100; i++) {
+        buffer.push_back(i % 10);
+    }
+    auto recent = buffer.summary(95, 100);
+    // min 5, max 9, sum 35
+    std::cout << "min " << recent.min << ", max " << recent.max << ", sum " << recent.sum << '\n';
+    if (recent.count != 5 || recent.sum != 35) {
+        return 1;
+    }
+    // Samples 64-95 are no longer raw but fill whole 16-sample buckets, so the summary stays exact.
+    auto older = buffer.summary(64, 96);
+    if (older.count != 32 || older.first != 64 || older.last != 96 || older.min != 0 || older.max != 9) {
+        return 1;
+    }
+    // Sample 3 is only retained inside the 16-sample bucket [0, 16), so the summary widens to start at 0.
+    auto widened = buffer.summary(3, 100);
+    return widened.first == 0 && widened.count == 100 && widened.sum == 450 ? 0 : 1;
+}
+
+auto main() -> int {
+    return test();
+}
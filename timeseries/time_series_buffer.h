@@ -0,0 +1,275 @@
+#ifndef TOOLS_TIME_SERIES_BUFFER_H
+#define TOOLS_TIME_SERIES_BUFFER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "../vec/vec.h"
+
+namespace timeseries {
+    using Size = std::size_t;
+
+    /// Aggregates of the samples in a range. `first` and `last` delimit the samples actually summarized, which may
+    /// be wider than the range asked for if part of it is only retained at a coarse resolution, or narrower if part
+    /// of it is no longer retained at all.
+    template <class T>
+    struct Summary {
+        using Sum = std::conditional_t<std::is_floating_point_v<T>, double, std::int64_t>;
+
+        T min = std::numeric_limits<T>::max();
+        T max = std::numeric_limits<T>::lowest();
+        Sum sum = 0;
+        Size count = 0;
+        Size first = std::numeric_limits<Size>::max();
+        Size last = 0;
+
+        /// Returns the mean of the summarized samples, or zero if there are none.
+        auto mean() const -> double {
+            return count == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(count);
+        }
+    };
+}
+
+/// `TimeSeriesBuffer` keeps the most recent samples of a metric in a ring, plus a number of downsampling tiers. Tier
+/// `k` stores, per bucket of `factor^k` consecutive samples, the bucket's minimum, maximum, sum and count, in a ring of
+/// its own. Every tier is updated incrementally as samples are pushed, so coarse tiers cover long histories in little
+/// memory without ever being rebuilt. Samples are numbered from 0 in push order.
+template <class T>
+requires (std::is_arithmetic_v<T>)
+class TimeSeriesBuffer {
+public:
+    using Size = timeseries::Size;
+    using Summary = timeseries::Summary<T>;
+    using Sum = typename Summary::Sum;
+private:
+    /// A ring of per-bucket aggregates, stored as one `Vec` per aggregate so scans run over contiguous values.
+    struct Tier {
+        Size width;
+        Vec<T> mins;
+        Vec<T> maxs;
+        Vec<Sum> sums;
+        Vec<std::uint32_t> counts;
+    };
+
+    Size raw_capacity;
+    Vec<T> raw;
+    Vec<Tier> tiers;
+    Size total = 0;
+
+    /// Returns the number of the oldest sample still retained at `level` (0 being the raw samples).
+    auto oldest(Size level) const -> Size {
+        if (level == 0) {
+            return total > raw_capacity ? total - raw_capacity : 0;
+        }
+        const Tier& tier = tiers.raw_ptr_begin()[level - 1];
+        Size buckets = (total + tier.width - 1) / tier.width;
+        Size capacity = tier.counts.size();
+        return buckets > capacity ? (buckets - capacity) * tier.width : 0;
+    }
+
+    /// Folds the ring positions [first, last) (taken modulo the ring size) of `values` into `fn`, as at most two
+    /// contiguous runs.
+    template <class U, class Fn>
+    static auto scan(const Vec<U>& values, Size first, Size last, Fn fn) -> void {
+        Size capacity = values.size();
+        Size begin = first % capacity;
+        Size length = last - first;
+        const U* data = values.raw_ptr_begin();
+        Size head = std::min(length, capacity - begin);
+        fn(data + begin, head);
+        if (head < length) {
+            fn(data, length - head);
+        }
+    }
+
+    static auto cover(Summary& summary, Size first, Size last) -> void {
+        summary.first = std::min(summary.first, first);
+        summary.last = std::max(summary.last, last);
+    }
+
+    /// Adds the raw samples [first, last), which must be retained.
+    auto add_raw(Summary& summary, Size first, Size last) const -> void {
+        T low = summary.min;
+        T high = summary.max;
+        Sum sum = 0;
+        scan(raw, first, last, [&](const T* data, Size n) {
+            for (Size i = 0; i < n; i++) {
+                low = std::min(low, data[i]);
+                high = std::max(high, data[i]);
+                sum += data[i];
+            }
+        });
+        summary.min = low;
+        summary.max = high;
+        summary.sum += sum;
+        summary.count += last - first;
+        cover(summary, first, last);
+    }
+
+    /// Adds the buckets [first, last) of tier `level`, which must be retained.
+    auto add_buckets(Summary& summary, Size level, Size first, Size last) const -> void {
+        const Tier& tier = tiers.raw_ptr_begin()[level - 1];
+        T low = summary.min;
+        T high = summary.max;
+        Sum sum = 0;
+        Size count = 0;
+        scan(tier.mins, first, last, [&low](const T* data, Size n) {
+            for (Size i = 0; i < n; i++) {
+                low = std::min(low, data[i]);
+            }
+        });
+        scan(tier.maxs, first, last, [&high](const T* data, Size n) {
+            for (Size i = 0; i < n; i++) {
+                high = std::max(high, data[i]);
+            }
+        });
+        scan(tier.sums, first, last, [&sum](const Sum* data, Size n) {
+            for (Size i = 0; i < n; i++) {
+                sum += data[i];
+            }
+        });
+        scan(tier.counts, first, last, [&count](const std::uint32_t* data, Size n) {
+            for (Size i = 0; i < n; i++) {
+                count += data[i];
+            }
+        });
+        summary.min = low;
+        summary.max = high;
+        summary.sum += sum;
+        summary.count += count;
+        cover(summary, first * tier.width, std::min(last * tier.width, total));
+    }
+
+    /// Summarizes the samples [first, last), all retained at `level`, using whole buckets of `level` for the aligned
+    /// middle of the range and the next finer level that retains them for the unaligned ends. An end that no finer
+    /// level retains is taken from the `level` bucket containing it.
+    auto add_range(Summary& summary, Size level, Size first, Size last) const -> void {
+        if (first >= last) {
+            return;
+        }
+        if (level == 0) {
+            add_raw(summary, first, last);
+            return;
+        }
+        Size width = tiers.raw_ptr_begin()[level - 1].width;
+        Size aligned_first = (first + width - 1) / width * width;
+        Size aligned_last = last / width * width;
+        auto add_end = [&](Size from, Size to) {
+            if (from >= to) {
+                return;
+            }
+            for (Size finer = level; finer-- > 0;) {
+                if (from >= oldest(finer)) {
+                    add_range(summary, finer, from, to);
+                    return;
+                }
+            }
+            add_buckets(summary, level, from / width, (to + width - 1) / width);
+        };
+        if (aligned_first < aligned_last) {
+            add_buckets(summary, level, aligned_first / width, aligned_last / width);
+            add_end(first, aligned_first);
+            add_end(aligned_last, last);
+        } else {
+            add_end(first, last);
+        }
+    }
+public:
+    /// Constructs a buffer keeping the latest `raw_capacity` samples, plus `tier_count` tiers of `tier_capacity`
+    /// buckets each, where a bucket of tier `k` (from 1) spans `factor^k` samples.
+    /// @throws InvalidArgument if a capacity is zero or `factor` is less than 2.
+    explicit TimeSeriesBuffer(Size raw_capacity, Size factor = 16, Size tier_count = 3, Size tier_capacity = 0)
+        : raw_capacity(raw_capacity) {
+        tier_capacity = tier_capacity == 0 ? raw_capacity : tier_capacity;
+        if (raw_capacity == 0 || tier_capacity == 0 || factor < 2) {
+            throw error::InvalidArgument("invalid time series buffer configuration.");
+        }
+        raw = Vec<T>::of(raw_capacity);
+        Size width = 1;
+        for (Size k = 0; k < tier_count; k++) {
+            width *= factor;
+            tiers.push_back(Tier {
+                width,
+                Vec<T>::of(tier_capacity),
+                Vec<T>::of(tier_capacity),
+                Vec<Sum>::of(tier_capacity),
+                Vec<std::uint32_t>::of(tier_capacity)
+            });
+        }
+    }
+
+    /// Appends a sample and folds it into the current bucket of every tier.
+    auto push_back(const T& val) -> void {
+        raw.raw_ptr_begin()[total % raw_capacity] = val;
+        for (Tier& tier : tiers) {
+            Size slot = total / tier.width % tier.counts.size();
+            T& low = tier.mins.raw_ptr_begin()[slot];
+            T& high = tier.maxs.raw_ptr_begin()[slot];
+            Sum& sum = tier.sums.raw_ptr_begin()[slot];
+            std::uint32_t& count = tier.counts.raw_ptr_begin()[slot];
+            if (total % tier.width == 0) {
+                low = val;
+                high = val;
+                sum = val;
+                count = 1;
+            } else {
+                low = std::min(low, val);
+                high = std::max(high, val);
+                sum += val;
+                count++;
+            }
+        }
+        total++;
+    }
+
+    /// Returns the aggregates of samples [`first`, `last`). Long ranges are answered mostly from whole buckets of the
+    /// coarsest tier, so their cost depends on the number of tiers rather than on the length of the range. Samples
+    /// no longer retained at any resolution are left out, and the summary's `first` and `last` report the range
+    /// actually covered.
+    auto summary(Size first, Size last) const -> Summary {
+        auto result = Summary();
+        last = std::min(last, total);
+        Size coarsest = tiers.size();
+        first = std::max(first, oldest(coarsest));
+        add_range(result, coarsest, first, last);
+        if (result.count == 0) {
+            result.first = first;
+            result.last = first;
+        }
+        return result;
+    }
+
+    /// Returns sample `i`.
+    /// @throws IndexOutOfBounds if sample `i` was not pushed or is no longer retained at full resolution.
+    auto at(Size i) const -> const T& {
+        if (i >= total || i < oldest(0)) {
+            throw error::IndexOutOfBounds("sample not retained at full resolution.");
+        }
+        return raw.raw_ptr_begin()[i % raw_capacity];
+    }
+
+    /// Returns the number of the oldest sample retained at full resolution.
+    auto oldest_raw() const -> Size {
+        return oldest(0);
+    }
+
+    /// Returns the number of the oldest sample retained at any resolution.
+    auto oldest_retained() const -> Size {
+        return oldest(tiers.size());
+    }
+
+    /// Returns if no sample was pushed.
+    [[nodiscard]]
+    auto is_empty() const -> bool {
+        return total == 0;
+    }
+
+    /// Returns the number of samples pushed so far.
+    auto size() const -> Size {
+        return total;
+    }
+};
+
+#endif //TOOLS_TIME_SERIES_BUFFER_H
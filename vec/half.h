@@ -0,0 +1,300 @@
+#ifndef TOOLS_HALF_H
+#define TOOLS_HALF_H
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+
+#if defined(__F16C__) || defined(__AVX512BF16__)
+#include <immintrin.h>
+#endif
+
+#include "vec.h"
+
+namespace vector {
+    /// An IEEE 754 half-precision float (binary16): 1 sign, 5 exponent and 10 mantissa bits. It holds about three
+    /// significant decimal digits, up to 65504, in half the space of a `float`. Arithmetic is done by converting to
+    /// `float`.
+    struct f16 {
+        std::uint16_t bits;
+
+        f16() = default;
+
+        /// Rounds `x` to the nearest half, ties to even. Values of 65520 or more in magnitude become infinities.
+        explicit f16(float x) : bits(from_float(x)) {}
+
+        /// Converts to `float`, which holds every half exactly.
+        explicit operator float() const {
+            return to_float(bits);
+        }
+
+        /// Returns the half whose representation is `bits`.
+        static auto from_bits(std::uint16_t bits) -> f16 {
+            f16 h;
+            h.bits = bits;
+            return h;
+        }
+
+        /// Compares as floats, so `-0 == 0` and NaN equals nothing.
+        friend auto operator==(f16 a, f16 b) -> bool {
+            return float(a) == float(b);
+        }
+
+        friend auto operator<<(std::ostream& os, f16 h) -> std::ostream& {
+            return os << float(h);
+        }
+    private:
+        // The conversions follow F. Giesen's branch-light versions, which match the F16C instructions bit for bit.
+        static auto from_float(float x) -> std::uint16_t {
+            auto u = std::bit_cast<std::uint32_t>(x);
+            std::uint32_t sign = u & 0x80000000u;
+            u ^= sign;
+            std::uint32_t h;
+            if (u >= 0x47800000u) {
+                // 2^16 or more, infinity or NaN. NaNs are quieted and keep the top of their payload.
+                h = u > 0x7F800000u ? 0x7E00u | ((u >> 13) & 0x3FFu) : 0x7C00u;
+            } else if (u < 0x38800000u) {
+                // Below 2^-14, so subnormal or zero: adding 0.5 lines the mantissa up and rounds it.
+                h = std::bit_cast<std::uint32_t>(std::bit_cast<float>(u) + 0.5f) - 0x3F000000u;
+            } else {
+                // Rebias the exponent and round to nearest even; a carry out of the mantissa bumps the exponent.
+                h = (u + 0xC8000FFFu + ((u >> 13) & 1)) >> 13;
+            }
+            return static_cast<std::uint16_t>(h | (sign >> 16));
+        }
+
+        static auto to_float(std::uint16_t h) -> float {
+            constexpr std::uint32_t exponent = 0x7C00u << 13;
+            std::uint32_t u = (h & 0x7FFFu) << 13;
+            std::uint32_t exp = u & exponent;
+            u += (127 - 15) << 23;
+            if (exp == exponent) {
+                // Infinity or NaN; NaNs are quieted.
+                u += (128 - 16) << 23;
+                u |= (u & 0x7FFFFFu) ? 0x400000u : 0;
+            } else if (exp == 0) {
+                // Zero or subnormal: renormalize through a float subtraction.
+                float renormalized = std::bit_cast<float>(u + (1u << 23)) - std::bit_cast<float>(113u << 23);
+                u = std::bit_cast<std::uint32_t>(renormalized);
+            }
+            return std::bit_cast<float>(u | (std::uint32_t(h & 0x8000u) << 16));
+        }
+    };
+
+    /// A bfloat16: the top 16 bits of a `float`, with its 8-bit exponent and 7 of its mantissa bits. It covers the
+    /// whole range of `float` with about two significant decimal digits, which suits weights and embeddings.
+    struct bf16 {
+        std::uint16_t bits;
+
+        bf16() = default;
+
+        /// Rounds `x` to the nearest bfloat16, ties to even. NaNs are quieted.
+        explicit bf16(float x) : bits(from_float(x)) {}
+
+        /// Converts to `float`, which holds every bfloat16 exactly.
+        explicit operator float() const {
+            return std::bit_cast<float>(std::uint32_t(bits) << 16);
+        }
+
+        /// Returns the bfloat16 whose representation is `bits`.
+        static auto from_bits(std::uint16_t bits) -> bf16 {
+            bf16 b;
+            b.bits = bits;
+            return b;
+        }
+
+        /// Compares as floats, so `-0 == 0` and NaN equals nothing.
+        friend auto operator==(bf16 a, bf16 b) -> bool {
+            return float(a) == float(b);
+        }
+
+        friend auto operator<<(std::ostream& os, bf16 b) -> std::ostream& {
+            return os << float(b);
+        }
+    private:
+        static auto from_float(float x) -> std::uint16_t {
+            auto u = std::bit_cast<std::uint32_t>(x);
+            if ((u & 0x7FFFFFFFu) > 0x7F800000u) {
+                return static_cast<std::uint16_t>((u >> 16) | 0x40u);
+            }
+            return static_cast<std::uint16_t>((u + 0x7FFFu + ((u >> 16) & 1)) >> 16);
+        }
+    };
+
+    /// The element types the half-precision kernels read and write: `float` and the two compact formats.
+    template <class T>
+    concept IsKernelFloat = std::same_as<T, float> || std::same_as<T, f16> || std::same_as<T, bf16>;
+
+    /// Converts `n` floats to halves. With F16C, eight are converted per instruction. `Vec<float>::cast<f16>()` runs
+    /// through this.
+    inline auto convert_block(const float* from, f16* to, std::size_t n) -> void {
+        std::size_t i = 0;
+#if defined(__F16C__)
+        for (; i + 8 <= n; i += 8) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(to + i),
+                             _mm256_cvtps_ph(_mm256_loadu_ps(from + i), _MM_FROUND_TO_NEAREST_INT));
+        }
+#endif
+        for (; i < n; i++) {
+            to[i] = f16(from[i]);
+        }
+    }
+
+    /// Converts `n` halves to floats. With F16C, eight are converted per instruction.
+    inline auto convert_block(const f16* from, float* to, std::size_t n) -> void {
+        std::size_t i = 0;
+#if defined(__F16C__)
+        for (; i + 8 <= n; i += 8) {
+            _mm256_storeu_ps(to + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i))));
+        }
+#endif
+        for (; i < n; i++) {
+            to[i] = float(from[i]);
+        }
+    }
+
+    /// Converts `n` floats to bfloat16s. With AVX-512 BF16, sixteen are converted per instruction; note that the
+    /// instruction flushes subnormal floats to zero, while the portable loop (which compilers also vectorize) rounds
+    /// them like any other value.
+    inline auto convert_block(const float* from, bf16* to, std::size_t n) -> void {
+        std::size_t i = 0;
+#if defined(__AVX512BF16__)
+        for (; i + 16 <= n; i += 16) {
+            __m256bh packed = _mm512_cvtneps_pbh(_mm512_loadu_ps(from + i));
+            std::memcpy(to + i, &packed, sizeof(packed));
+        }
+#endif
+        for (; i < n; i++) {
+            to[i] = bf16(from[i]);
+        }
+    }
+
+    /// Converts `n` bfloat16s to floats, which is a 16-bit shift that compilers vectorize.
+    inline auto convert_block(const bf16* from, float* to, std::size_t n) -> void {
+        for (std::size_t i = 0; i < n; i++) {
+            to[i] = float(from[i]);
+        }
+    }
+
+    namespace detail {
+        /// Elements are widened to floats this many at a time, into buffers the kernels then loop over.
+        inline constexpr std::size_t step = 16;
+
+        template <IsKernelFloat T>
+        auto widen(const T* from, float* to, std::size_t n) -> void {
+            if constexpr (std::same_as<T, float>) {
+                std::memcpy(to, from, n * sizeof(float));
+            } else {
+                convert_block(from, to, n);
+            }
+        }
+
+        template <IsKernelFloat T>
+        auto narrow(const float* from, T* to, std::size_t n) -> void {
+            if constexpr (std::same_as<T, float>) {
+                std::memcpy(to, from, n * sizeof(float));
+            } else {
+                convert_block(from, to, n);
+            }
+        }
+
+        /// Adds up the lanes of `acc` pairwise.
+        inline auto reduce(float* acc) -> float {
+            for (std::size_t width = step / 2; width > 0; width /= 2) {
+                for (std::size_t j = 0; j < width; j++) {
+                    acc[j] += acc[j + width];
+                }
+            }
+            return acc[0];
+        }
+    }
+
+    /// Returns the dot product of the `n` elements at `a` and at `b`, computed in `float`. Elements are widened
+    /// sixteen at a time and accumulated in sixteen independent lanes, so the loop vectorizes without reassociating
+    /// a single running sum.
+    template <IsKernelFloat A, IsKernelFloat B>
+    auto dot(const A* a, const B* b, std::size_t n) -> float {
+        float acc[detail::step] = {};
+        float x[detail::step];
+        float y[detail::step];
+        for (std::size_t i = 0; i < n; i += detail::step) {
+            std::size_t count = std::min(detail::step, n - i);
+            if (count < detail::step) {
+                std::fill(x + count, x + detail::step, 0.0f);
+                std::fill(y + count, y + detail::step, 0.0f);
+            }
+            detail::widen(a + i, x, count);
+            detail::widen(b + i, y, count);
+            for (std::size_t j = 0; j < detail::step; j++) {
+                acc[j] += x[j] * y[j];
+            }
+        }
+        return detail::reduce(acc);
+    }
+
+    /// Returns the sum of the `n` elements at `a`, computed in `float` as in `dot`.
+    template <IsKernelFloat A>
+    auto sum(const A* a, std::size_t n) -> float {
+        float acc[detail::step] = {};
+        float x[detail::step];
+        for (std::size_t i = 0; i < n; i += detail::step) {
+            std::size_t count = std::min(detail::step, n - i);
+            if (count < detail::step) {
+                std::fill(x + count, x + detail::step, 0.0f);
+            }
+            detail::widen(a + i, x, count);
+            for (std::size_t j = 0; j < detail::step; j++) {
+                acc[j] += x[j];
+            }
+        }
+        return detail::reduce(acc);
+    }
+
+    /// Sets `y[i] += alpha * x[i]` for the `n` elements at `x` and `y`, computed in `float` and rounded once into `y`.
+    template <IsKernelFloat X, IsKernelFloat Y>
+    auto axpy(float alpha, const X* x, Y* y, std::size_t n) -> void {
+        float xs[detail::step];
+        float ys[detail::step];
+        for (std::size_t i = 0; i < n; i += detail::step) {
+            std::size_t count = std::min(detail::step, n - i);
+            detail::widen(x + i, xs, count);
+            detail::widen(y + i, ys, count);
+            for (std::size_t j = 0; j < count; j++) {
+                ys[j] += alpha * xs[j];
+            }
+            detail::narrow(ys, y + i, count);
+        }
+    }
+
+    /// Returns the dot product of `a` and `b`.
+    /// @throws InvalidArgument if `a` and `b` differ in length.
+    template <IsKernelFloat A, class AllocA, IsKernelFloat B, class AllocB>
+    auto dot(const Vec<A, AllocA>& a, const Vec<B, AllocB>& b) -> float {
+        if (a.size() != b.size()) {
+            throw error::InvalidArgument("vectors differ in length.");
+        }
+        return dot(a.raw_ptr_begin(), b.raw_ptr_begin(), a.size());
+    }
+
+    /// Returns the sum of the elements of `a`.
+    template <IsKernelFloat A, class Alloc>
+    auto sum(const Vec<A, Alloc>& a) -> float {
+        return sum(a.raw_ptr_begin(), a.size());
+    }
+
+    /// Sets `y[i] += alpha * x[i]` for each `i`.
+    /// @throws InvalidArgument if `x` and `y` differ in length.
+    template <IsKernelFloat X, class AllocX, IsKernelFloat Y, class AllocY>
+    auto axpy(float alpha, const Vec<X, AllocX>& x, Vec<Y, AllocY>& y) -> void {
+        if (x.size() != y.size()) {
+            throw error::InvalidArgument("vectors differ in length.");
+        }
+        axpy(alpha, x.raw_ptr_begin(), y.raw_ptr_begin(), x.size());
+    }
+}
+
+#endif //TOOLS_HALF_H
@@ -0,0 +1,54 @@
+#ifndef TOOLS_HASHED_VEC_H
+#define TOOLS_HASHED_VEC_H
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+#include "vec.h"
+
+/// `HashedVec` is an immutable `Vec` that computes its hash once, on construction. Use it as the key of unordered
+/// containers when long keys are hashed or compared often: hashing is free, and unequal keys are usually told apart by
+/// their hashes without touching their elements.
+template <class T, class Alloc = std::allocator<T>>
+class HashedVec {
+private:
+    Vec<T, Alloc> elements;
+    std::size_t cached;
+public:
+    /// Takes ownership of `vec` and hashes it.
+    explicit HashedVec(Vec<T, Alloc> vec) : elements(std::move(vec)), cached(std::hash<Vec<T, Alloc>>()(elements)) {}
+
+    /// Returns the wrapped vector.
+    auto get() const -> const Vec<T, Alloc>& {
+        return elements;
+    }
+
+    /// Returns the cached hash, equal to `std::hash<Vec<T, Alloc>>()(get())`.
+    auto hash() const -> std::size_t {
+        return cached;
+    }
+
+    /// Returns the number of elements.
+    auto size() const -> typename Vec<T, Alloc>::Size {
+        return elements.size();
+    }
+
+    /// Compares the cached hashes first and the elements only if those match.
+    friend auto operator==(const HashedVec& a, const HashedVec& b) -> bool {
+        return a.cached == b.cached && a.elements == b.elements;
+    }
+
+    friend auto operator<=>(const HashedVec& a, const HashedVec& b) {
+        return a.elements <=> b.elements;
+    }
+};
+
+template <class T, class Alloc>
+struct std::hash<HashedVec<T, Alloc>> {
+    auto operator()(const HashedVec<T, Alloc>& vec) const -> std::size_t {
+        return vec.hash();
+    }
+};
+
+#endif //TOOLS_HASHED_VEC_H
@@ -1,11 +1,100 @@
+#include <cstdint>
 #include <iostream>
+#include <string>
+#include <unordered_map>
 
+#include "../half.h"
+#include "../hashed_vec.h"
 #include "../vec.h"
 
 auto test() -> int {
     auto vec = Vec<int>::of(10);
     std::cout << vec << '\n';
-    return 0;
+
+    // Vecs compare lexicographically and can key unordered containers.
+    auto counts = std::unordered_map<Vec<int>, int>();
+    counts[Vec<int> { 1, 2, 3 }]++;
+    counts[Vec<int> { 1, 2, 3 }]++;
+    counts[Vec<int> { 1, 2 }]++;
+    if (counts.size() != 2 || counts[Vec<int> { 1, 2, 3 }] != 2) {
+        return 1;
+    }
+    if (!(Vec<int> { 1, 2 } < Vec<int> { 1, 3 }) || !(Vec<int> { 1, 2 } < Vec<int> { 1, 2, 0 })
+        || vec != Vec<int>::of(10)) {
+        return 1;
+    }
+    // Concatenation allocates once, and a part may be the vector being extended.
+    auto joined = Vec<int>::concat(Vec<int> { 1, 2 }, Vec<int> { 3 }, Vec<int> {});
+    joined.extend_many(Vec<Vec<int>> { Vec<int> { 4 }, Vec<int> { 5, 6 } });
+    joined.extend_many(joined);
+    std::cout << joined << '\n';
+    if (joined.size() != 12 || joined.at(6) != 1) {
+        return 1;
+    }
+
+    // Partitions return the split point and views of each side.
+    auto split = joined.stable_partition([](int x) { return x % 2 == 0; });
+    std::cout << joined << '\n';
+    auto [evens, odds] = Vec<int> { 5, 2, 8, 1 }.partition_copy([](int x) { return x % 2 == 0; });
+    if (split.point != 6 || split.rest.front() != 1 || evens.size() != 2 || odds.at(1) != 1
+        || joined.partition([](int x) { return x > 4; }).matching.size() != 4) {
+        return 1;
+    }
+
+    // Reversing, rotating and byte-swapping.
+    auto order = Vec<int> { 1, 2, 3, 4, 5 };
+    order.reverse();
+    order.rotate(2);
+    std::cout << order << '\n';
+    auto words = Vec<std::uint32_t> { 0x11223344 };
+    words.byteswap_all();
+    if (order.at(0) != 3 || order.at(4) != 4 || words.at(0) != 0x44332211) {
+        return 1;
+    }
+
+    // Deduplication, by adjacent comparison or by hashing.
+    auto ids = Vec<int> { 4, 1, 4, 2, 1, 3 };
+    ids.unique_stable();
+    std::cout << ids << '\n';
+    auto names = Vec<std::string> { "b", "a", "b" };
+    names.unique_unordered();
+    auto sorted = Vec<int> { 1, 1, 2, 3, 3, 3 };
+    sorted.unique_sorted();
+    if (ids.size() != 4 || ids.at(1) != 1 || names.size() != 2 || sorted.size() != 3) {
+        return 1;
+    }
+
+    // Reordering by indices.
+    auto letters = Vec<char> { 'a', 'b', 'c', 'd' };
+    auto picked = letters.gather(Vec<int> { 3, 0, 0 });
+    letters.scatter(Vec<int> { 1, 1 }, Vec<char> { 'x', 'y' });
+    letters.apply_permutation(Vec<std::uint32_t> { 3, 2, 1, 0 });
+    std::cout << letters << '\n';
+    if (picked.at(0) != 'd' || picked.at(2) != 'a' || letters.at(2) != 'y' || letters.at(0) != 'd') {
+        return 1;
+    }
+
+    // Converting element types, with or without saturation.
+    auto levels = Vec<int> { -5, 100, 300 };
+    auto bytes = levels.saturate_cast<std::uint8_t>();
+    auto reals = Vec<float>();
+    levels.cast_into(reals);
+    if (bytes.at(0) != 0 || bytes.at(2) != 255 || reals.at(1) != 100.0f) {
+        return 1;
+    }
+
+    // Half-precision storage, with kernels that read it directly.
+    auto weights = Vec<float> { 0.5f, -1.0f, 2.0f }.cast<vector::f16>();
+    auto inputs = Vec<float> { 4.0f, 1.0f, 0.25f }.cast<vector::bf16>();
+    vector::axpy(2.0f, inputs, weights);
+    std::cout << weights << '\n';
+    if (vector::dot(weights, inputs) != 35.625f || vector::sum(inputs) != 5.25f) {
+        return 1;
+    }
+
+    auto key = HashedVec<char>(Vec<char>::from({ 'a', 'b' }));
+    bool same = key == HashedVec<char>(Vec<char>::from({ 'a', 'b' }));
+    return same && key.hash() == std::hash<Vec<char>>()(key.get()) ? 0 : 1;
 }
 
 auto main() -> int {
@@ -1,18 +1,36 @@
 #ifndef TOOLS_VEC_H
 #define TOOLS_VEC_H
 
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <compare>
+#include <cstdint>
+#include <cstring>
 #include <exception>
 #include <concepts>
+#include <functional>
 #include <limits>
+#include <memory>
 #include <optional>
 #include <ostream>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 #include "../concepts/concepts.h"
+#include "../parallel/parallel.h"
 
 /// `Vec` is a wrapper over `std::vector` with additional functionality.
 /// Most methods from the `std::vector` class are available, but some have different (more appropriate) names.
-template <class T>
+/// Memory comes from `Alloc`, `std::allocator` by default (see `memory::Allocator` for arenas and pools).
+template <class T, class Alloc = std::allocator<T>>
 class Vec;
 
 namespace error {
@@ -39,6 +57,18 @@ namespace error {
             return message;
         }
     };
+
+    class InvalidArgument : public std::exception {
+    private:
+        const char* message;
+    public:
+        explicit InvalidArgument(const char* msg) : message(msg) {}
+
+        [[nodiscard]]
+        const char* what() const noexcept override {
+            return message;
+        }
+    };
 }
 
 namespace pattern {
@@ -58,14 +88,763 @@ namespace pattern {
     Pattern<T> Mult = [](const T& val) -> T { return val * by; };
 }
 
-template <class T>
+namespace vector {
+    /// Scrambles `h` so that every output bit depends on every input bit (the splitmix64 finalizer).
+    constexpr auto mix(std::uint64_t h) -> std::uint64_t {
+        h ^= h >> 30;
+        h *= 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 27;
+        h *= 0x94D049BB133111EBull;
+        return h ^ (h >> 31);
+    }
+
+    /// Returns the index of the first byte where [`a`, `a + n`) and [`b`, `b + n`) differ, or `n` if they are equal.
+    /// Whole 64-byte blocks are compared with `memcmp`, which the standard library vectorizes.
+    inline auto mismatch_bytes(const void* a, const void* b, std::size_t n) -> std::size_t {
+        const auto* x = static_cast<const unsigned char*>(a);
+        const auto* y = static_cast<const unsigned char*>(b);
+        std::size_t i = 0;
+        while (i + 64 <= n && std::memcmp(x + i, y + i, 64) == 0) {
+            i += 64;
+        }
+        while (i < n && x[i] == y[i]) {
+            i++;
+        }
+        return i;
+    }
+
+    /// Hashes [`data`, `data + n`). Four independent 64-bit lanes each absorb 8 bytes per step, so a 32-byte stride
+    /// keeps several multipliers busy at once; the lanes and length are then folded and finalized (splitmix64).
+    inline auto hash_bytes(const void* data, std::size_t n, std::uint64_t seed = 0) -> std::uint64_t {
+        constexpr std::uint64_t mul = 0x9FB21C651E98DF25ull;
+        const auto* p = static_cast<const unsigned char*>(data);
+        std::uint64_t lanes[4] = {
+            seed ^ 0x243F6A8885A308D3ull, seed ^ 0x13198A2E03707344ull,
+            seed ^ 0xA4093822299F31D0ull, seed ^ 0x082EFA98EC4E6C89ull,
+        };
+        auto absorb = [](std::uint64_t lane, std::uint64_t word) {
+            return std::rotl((lane ^ word) * mul, 29);
+        };
+        std::size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            for (int l = 0; l < 4; l++) {
+                std::uint64_t word;
+                std::memcpy(&word, p + i + 8 * l, 8);
+                lanes[l] = absorb(lanes[l], word);
+            }
+        }
+        for (int l = 0; i < n; i += 8, l++) {
+            std::uint64_t word = 0;
+            std::memcpy(&word, p + i, std::min<std::size_t>(8, n - i));
+            lanes[l] = absorb(lanes[l], word);
+        }
+        std::uint64_t h = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12)
+            + std::rotl(lanes[3], 18) + n;
+        return mix(h);
+    }
+
+    /// Where a partition put the boundary between the elements that satisfied its predicate and those that did not.
+    /// The views refer to the partitioned vector, and are invalidated along with its iterators.
+    template <class T>
+    struct Split {
+        /// The number of elements that satisfied the predicate, which is also the index of the first that did not.
+        std::size_t point;
+        /// The elements that satisfied the predicate.
+        std::span<T> matching;
+        /// The elements that did not.
+        std::span<T> rest;
+    };
+
+    /// Partitions [`first`, `last`) so the elements satisfying `pred` come first, and returns the end of them. For
+    /// arithmetic elements, each element is swapped with the one at the boundary, which then advances by the result
+    /// of `pred`; the loop has no branch that depends on the data.
+    template <class T, class Pred>
+    auto partition_block(T* first, T* last, Pred& pred) -> T* {
+        if constexpr (std::is_arithmetic_v<T>) {
+            T* mid = first;
+            for (T* it = first; it != last; it++) {
+                T val = *it;
+                bool matches = pred(std::as_const(val));
+                *it = *mid;
+                *mid = val;
+                mid += matches;
+            }
+            return mid;
+        } else {
+            return std::partition(first, last, [&](const T& val) { return bool(pred(val)); });
+        }
+    }
+
+    /// Copies each element of [`first`, `last`) to `yes` if its flag in `matches` is set, or to `no` otherwise,
+    /// keeping their order. The destination is selected rather than branched on.
+    template <class T>
+    auto scatter_block(const T* first, const T* last, const bool* matches, T* yes, T* no) -> void {
+        for (; first != last; first++, matches++) {
+            T* out = *matches ? yes : no;
+            *out = *first;
+            yes += *matches;
+            no += !*matches;
+        }
+    }
+
+    /// Returns `x` with its bytes in reverse order. The shifts and masks are the patterns compilers turn into a single
+    /// byte-swap instruction, or a byte shuffle when the surrounding loop is vectorized.
+    template <std::unsigned_integral U>
+    constexpr auto byteswap(U x) -> U {
+        if constexpr (sizeof(U) == 1) {
+            return x;
+        } else if constexpr (sizeof(U) == 2) {
+            return static_cast<U>((x >> 8) | (x << 8));
+        } else if constexpr (sizeof(U) == 4) {
+            return (x >> 24) | ((x >> 8) & 0x0000FF00u) | ((x << 8) & 0x00FF0000u) | (x << 24);
+        } else {
+            static_assert(sizeof(U) == 8, "byteswap takes 1, 2, 4 or 8 byte integers");
+            return (U(byteswap(std::uint32_t(x))) << 32) | byteswap(std::uint32_t(x >> 32));
+        }
+    }
+
+    /// Reverses the bytes of each of the `n` elements at `data`, which are 1, 2, 4 or 8 bytes long.
+    template <class T>
+    auto byteswap_block(T* data, std::size_t n) -> void {
+        using Word = std::conditional_t<sizeof(T) == 1, std::uint8_t,
+                     std::conditional_t<sizeof(T) == 2, std::uint16_t,
+                     std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>>>;
+        auto* bytes = reinterpret_cast<unsigned char*>(data);
+        for (std::size_t i = 0; i < n; i++) {
+            Word word;
+            std::memcpy(&word, bytes + i * sizeof(T), sizeof(T));
+            word = byteswap(word);
+            std::memcpy(bytes + i * sizeof(T), &word, sizeof(T));
+        }
+    }
+
+    /// Swaps [`a`, `a + n`) with [`b`, `b + n`), which must not overlap, through a 256-byte buffer, so each step is
+    /// three fixed-size copies.
+    template <class T>
+    auto swap_blocks(T* a, T* b, std::size_t n) -> void {
+        constexpr std::size_t step = std::max<std::size_t>(1, 256 / sizeof(T));
+        alignas(T) unsigned char buffer[step * sizeof(T)];
+        std::size_t i = 0;
+        for (; i + step <= n; i += step) {
+            std::memcpy(buffer, a + i, sizeof(buffer));
+            std::memcpy(a + i, b + i, sizeof(buffer));
+            std::memcpy(b + i, buffer, sizeof(buffer));
+        }
+        if (i < n) {
+            std::memcpy(buffer, a + i, (n - i) * sizeof(T));
+            std::memcpy(a + i, b + i, (n - i) * sizeof(T));
+            std::memcpy(b + i, buffer, (n - i) * sizeof(T));
+        }
+    }
+
+    /// Swaps the `i`th of the `n` elements at `front` with the `i`th of the `n` elements ending at `back`, counting
+    /// backwards, which reverses them into each other. Elements move a 64-byte block at a time: both blocks are
+    /// copied out, then written back in reverse order by fixed-length loops the compiler can vectorize.
+    template <class T>
+    auto reverse_swap(T* front, T* back, std::size_t n) -> void {
+        constexpr std::size_t step = std::max<std::size_t>(1, 64 / sizeof(T));
+        std::size_t i = 0;
+        for (; i + step <= n; i += step) {
+            T head[step];
+            T tail[step];
+            std::memcpy(head, front + i, sizeof(head));
+            std::memcpy(tail, back - i - step, sizeof(tail));
+            for (std::size_t j = 0; j < step; j++) {
+                front[i + j] = tail[step - 1 - j];
+                back[-std::ptrdiff_t(i + step) + std::ptrdiff_t(j)] = head[step - 1 - j];
+            }
+        }
+        for (; i < n; i++) {
+            std::swap(front[i], back[-std::ptrdiff_t(i) - 1]);
+        }
+    }
+
+    /// Removes adjacent repeats from [`first`, `last`) in place and returns how many elements are left. Every element
+    /// is written to the next free position, which advances only if the element differs from its predecessor, so
+    /// the loop has no branch that depends on the data.
+    template <class T>
+    auto unique_block(T* first, T* last) -> std::size_t {
+        if (first == last) {
+            return 0;
+        }
+        T prev = *first;
+        std::size_t kept = 1;
+        for (T* it = first + 1; it != last; it++) {
+            T val = *it;
+            first[kept] = val;
+            kept += !(val == prev);
+            prev = val;
+        }
+        return kept;
+    }
+
+    /// Hints that the cache line holding `ptr` will be read soon. Does nothing where the compiler offers no prefetch.
+    inline auto prefetch(const void* ptr) -> void {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(ptr);
+#else
+        (void) ptr;
+#endif
+    }
+
+    /// How many elements ahead the indexed loops prefetch.
+    inline constexpr std::size_t prefetch_distance = 16;
+
+    /// Sources at least this large are read a slice at a time by the partitioned gather and scatter.
+    inline constexpr std::size_t partition_bytes = std::size_t(1) << 25;
+
+    /// The size of one slice: small enough to stay in a core's L2 cache.
+    inline constexpr std::size_t slice_bytes = std::size_t(1) << 18;
+
+    /// Sets `out[i] = src[idx[i]]` for `i` in [0, `n`), prefetching the source `prefetch_distance` elements ahead.
+    /// With AVX2, 4-byte elements under 4-byte indices (into fewer than 2^31 elements) and 8-byte elements under
+    /// 8-byte indices are loaded eight or four at a time by hardware gathers. `src` holds `src_n` elements.
+    template <class T, class I>
+    auto gather_indexed(const T* src, std::size_t src_n, const I* idx, T* out, std::size_t n) -> void {
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        if constexpr (sizeof(T) == 4 && sizeof(I) == 4) {
+            if (src_n <= std::size_t(std::numeric_limits<std::int32_t>::max())) {
+                for (; i + 8 <= n; i += 8) {
+                    __m256i at = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + i));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                                        _mm256_i32gather_epi32(reinterpret_cast<const int*>(src), at, 4));
+                }
+            }
+        } else if constexpr (sizeof(T) == 8 && sizeof(I) == 8) {
+            for (; i + 4 <= n; i += 4) {
+                __m256i at = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                                    _mm256_i64gather_epi64(reinterpret_cast<const long long*>(src), at, 8));
+            }
+        }
+#else
+        (void) src_n;
+#endif
+        for (; i < n; i++) {
+            if (i + prefetch_distance < n) {
+                prefetch(src + idx[i + prefetch_distance]);
+            }
+            out[i] = src[idx[i]];
+        }
+    }
+
+    /// Sets `dst[idx[i]] = values[i]` for `i` in [0, `n`), in order, prefetching the destination `prefetch_distance`
+    /// elements ahead.
+    template <class T, class I>
+    auto scatter_indexed(T* dst, const I* idx, const T* values, std::size_t n) -> void {
+        for (std::size_t i = 0; i < n; i++) {
+            if (i + prefetch_distance < n) {
+                prefetch(dst + idx[i + prefetch_distance]);
+            }
+            dst[idx[i]] = values[i];
+        }
+    }
+
+    /// Counting-sorts [0, `n`) by the slice of `slice_bytes` that `idx[i]` falls in, among `count` elements, keeping
+    /// positions in order within a slice.
+    template <class T, class I>
+    auto order_by_slice(const I* idx, std::size_t n, std::size_t count) -> std::unique_ptr<std::size_t[]> {
+        constexpr int shift = std::countr_zero(std::bit_floor(std::max<std::size_t>(1, slice_bytes / sizeof(T))));
+        auto starts = std::vector<std::size_t>((count >> shift) + 2, 0);
+        for (std::size_t i = 0; i < n; i++) {
+            starts[(static_cast<std::size_t>(idx[i]) >> shift) + 1]++;
+        }
+        for (std::size_t b = 1; b < starts.size(); b++) {
+            starts[b] += starts[b - 1];
+        }
+        auto order = std::unique_ptr<std::size_t[]>(new std::size_t[n]);
+        for (std::size_t i = 0; i < n; i++) {
+            order[starts[static_cast<std::size_t>(idx[i]) >> shift]++] = i;
+        }
+        return order;
+    }
+
+    /// Like `gather_indexed`, for a source too large for the cache. Positions are grouped by the slice of the source
+    /// they read, and filled a slice at a time so each slice is read while cached; within a slice they are filled in
+    /// order, so the writes to `out` move forward.
+    template <class T, class I>
+    auto gather_partitioned(const T* src, std::size_t src_n, const I* idx, T* out, std::size_t n) -> void {
+        auto order = order_by_slice<T>(idx, n, src_n);
+        for (std::size_t k = 0; k < n; k++) {
+            if (k + prefetch_distance < n) {
+                prefetch(src + idx[order[k + prefetch_distance]]);
+            }
+            std::size_t i = order[k];
+            out[i] = src[idx[i]];
+        }
+    }
+
+    /// Like `scatter_indexed`, for a destination too large for the cache, grouping the writes by the slice of the
+    /// destination they land in. Writes to the same element stay in order, so the last still wins.
+    template <class T, class I>
+    auto scatter_partitioned(T* dst, std::size_t dst_n, const I* idx, const T* values, std::size_t n) -> void {
+        auto order = order_by_slice<T>(idx, n, dst_n);
+        for (std::size_t k = 0; k < n; k++) {
+            if (k + prefetch_distance < n) {
+                prefetch(dst + idx[order[k + prefetch_distance]]);
+            }
+            std::size_t i = order[k];
+            dst[idx[i]] = values[i];
+        }
+    }
+
+    /// Pairs of element types with a bulk conversion `convert_block(const T*, U*, n)`, found by argument-dependent
+    /// lookup (e.g. `float` to and from the half-precision types in `half.h`). `Vec::cast` uses it instead of
+    /// converting one element at a time.
+    template <class T, class U>
+    concept HasConvertBlock = requires (const T* from, U* to, std::size_t n) {
+        convert_block(from, to, n);
+    };
+
+    /// Arithmetic types other than `bool`, which `saturate_cast` converts between.
+    template <class T>
+    concept IsSaturable = std::is_arithmetic_v<T> && !std::same_as<T, bool>;
+
+    /// Converts `x` to `U`, clamping it to the nearest value `U` holds instead of wrapping or overflowing. Floating
+    /// point values are clamped before conversion (infinities included, to the largest finite values), and NaN
+    /// becomes zero in an integer type. The selects compile to min/max or blends, so loops over it vectorize.
+    template <IsSaturable U, IsSaturable T>
+    constexpr auto saturate_cast(T x) -> U {
+        using Limits = std::numeric_limits<U>;
+        if constexpr (std::is_integral_v<U> && std::is_integral_v<T>) {
+            return std::cmp_less(x, Limits::min()) ? Limits::min()
+                 : std::cmp_greater(x, Limits::max()) ? Limits::max()
+                 : static_cast<U>(x);
+        } else if constexpr (std::is_integral_v<U>) {
+            // Limits::min() is 0 or a negative power of two, and 2^digits is one past Limits::max(); T holds both.
+            constexpr T low = static_cast<T>(Limits::min());
+            constexpr T past_high = static_cast<T>(2) * static_cast<T>(std::uint64_t(1) << (Limits::digits - 1));
+            return x != x ? U(0) : x <= low ? Limits::min() : x >= past_high ? Limits::max() : static_cast<U>(x);
+        } else if constexpr (std::is_floating_point_v<T> && sizeof(T) > sizeof(U)) {
+            return x < T(Limits::lowest()) ? Limits::lowest()
+                 : x > T(Limits::max()) ? Limits::max()
+                 : static_cast<U>(x);
+        } else {
+            return static_cast<U>(x);
+        }
+    }
+}
+
+template <class T, class Alloc>
 class Vec {
 protected:
     /// An alias to the wrapped type.
-    using Underlying = std::vector<T>;
+    using Underlying = std::vector<T, Alloc>;
 private:
-    std::vector<T> self;
+    Underlying self;
+
+    /// Bulk operations on at least this many bytes are split across threads.
+    static constexpr std::size_t parallel_bytes = std::size_t(1) << 22;
+
+    /// Whether elements can be copied as bytes into default-initialized storage, which the bulk operations need.
+    static constexpr bool bulk_copyable = std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>;
+
+    /// Where the per-thread ranges of a stable split send their elements. `matches` holds the result of the predicate
+    /// for each element, so it is called once per element.
+    struct Placement {
+        std::unique_ptr<bool[]> matches;
+        std::size_t threads = 0;
+        std::size_t point = 0;
+        /// Where range `t`'s matching elements start among all matching elements, and likewise for the others.
+        std::vector<std::size_t> yes;
+        std::vector<std::size_t> no;
+    };
+
+    /// Appends copies of `count` vectors, given by pointer, after one reallocation. Large trivially copyable inputs
+    /// are copied in parallel, each thread taking an equal share of the output. Pointers are only read after the
+    /// reallocation, so a part may be this vector itself.
+    auto append_all(const Vec* const* parts, std::size_t count) -> void {
+        std::size_t old_size = self.size();
+        auto sizes = std::vector<std::size_t>(count);
+        std::size_t total = old_size;
+        for (std::size_t i = 0; i < count; i++) {
+            sizes[i] = parts[i]->size();
+            total += sizes[i];
+        }
+        if constexpr (bulk_copyable) {
+            if ((total - old_size) * sizeof(T) >= parallel_bytes) {
+                self.resize(total);
+                // starts[i] is where part i goes in the output.
+                auto starts = std::vector<std::size_t>(count + 1, old_size);
+                for (std::size_t i = 0; i < count; i++) {
+                    starts[i + 1] = starts[i] + sizes[i];
+                }
+                T* out = self.data();
+                parallel::for_ranges(total - old_size, parallel::hardware_threads(), 4096,
+                                     [&](std::size_t, std::size_t first, std::size_t last) {
+                    first += old_size;
+                    last += old_size;
+                    auto part = static_cast<std::size_t>(std::upper_bound(starts.begin(), starts.end(), first)
+                                                         - starts.begin()) - 1;
+                    while (first < last) {
+                        std::size_t stop = std::min(last, starts[part + 1]);
+                        if (stop > first) {
+                            std::memcpy(out + first, parts[part]->self.data() + (first - starts[part]),
+                                        (stop - first) * sizeof(T));
+                        }
+                        first = stop;
+                        part++;
+                    }
+                });
+                return;
+            }
+        }
+        self.reserve(total);
+        for (std::size_t i = 0; i < count; i++) {
+            if (parts[i] == this) {
+                // Copy by index: the reserve above guarantees that these push_backs do not reallocate.
+                for (std::size_t k = 0; k < sizes[i]; k++) {
+                    self.push_back(self[k]);
+                }
+            } else {
+                self.insert(self.end(), parts[i]->self.begin(), parts[i]->self.end());
+            }
+        }
+    }
+
+    auto append_one(const Vec& part) -> void {
+        const Vec* list[] = { &part };
+        append_all(list, 1);
+    }
+
+    auto append_one(Vec&& part) -> void {
+        self.insert(self.end(), std::make_move_iterator(part.self.begin()), std::make_move_iterator(part.self.end()));
+    }
+
+    /// The number of threads a bulk operation over `count` elements should use.
+    static auto bulk_threads(std::size_t count) -> std::size_t {
+        return count * sizeof(T) >= parallel_bytes ? parallel::hardware_threads() : 1;
+    }
+
+    /// Swaps [`a`, `a + n`) with [`b`, `b + n`), which must not overlap, on several threads if `n` is large.
+    static auto swap_ranges(T* a, T* b, std::size_t n) -> void {
+        parallel::for_ranges(n, bulk_threads(n), 4096, [=](std::size_t, std::size_t first, std::size_t last) {
+            vector::swap_blocks(a + first, b + first, last - first);
+        });
+    }
+
+    auto split_at(std::size_t point) -> vector::Split<T> {
+        return { point, std::span<T>(self.data(), point), std::span<T>(self.data() + point, self.size() - point) };
+    }
+
+    /// Partitions each per-thread range on its own, then swaps the misplaced elements across the boundary: those not
+    /// matching before it with those matching after it. There are as many of each, and the `k`th of one is swapped
+    /// with the `k`th of the other, so the swaps are split across threads too.
+    template <class Pred>
+    auto partition_in_place(Pred& pred, std::size_t threads) -> std::size_t {
+        T* data = self.data();
+        auto firsts = std::vector<std::size_t>(threads);
+        auto mids = std::vector<std::size_t>(threads);
+        auto lasts = std::vector<std::size_t>(threads);
+        threads = parallel::for_ranges(self.size(), threads, 4096,
+                                       [&](std::size_t t, std::size_t first, std::size_t last) {
+            firsts[t] = first;
+            mids[t] = static_cast<std::size_t>(vector::partition_block(data + first, data + last, pred) - data);
+            lasts[t] = last;
+        });
+        std::size_t point = 0;
+        for (std::size_t t = 0; t < threads; t++) {
+            point += mids[t] - firsts[t];
+        }
+        using Run = std::pair<std::size_t, std::size_t>;
+        auto left = std::vector<Run>();
+        auto right = std::vector<Run>();
+        for (std::size_t t = 0; t < threads; t++) {
+            if (mids[t] < std::min(lasts[t], point)) {
+                left.emplace_back(mids[t], std::min(lasts[t], point));
+            }
+            if (std::max(firsts[t], point) < mids[t]) {
+                right.emplace_back(std::max(firsts[t], point), mids[t]);
+            }
+        }
+        // starts[i] counts the misplaced elements before run i.
+        auto starts_of = [](const std::vector<Run>& runs) {
+            auto starts = std::vector<std::size_t>(runs.size() + 1, 0);
+            for (std::size_t i = 0; i < runs.size(); i++) {
+                starts[i + 1] = starts[i] + runs[i].second - runs[i].first;
+            }
+            return starts;
+        };
+        auto left_starts = starts_of(left);
+        auto right_starts = starts_of(right);
+        auto locate = [](const std::vector<std::size_t>& starts, std::size_t k) {
+            return static_cast<std::size_t>(std::upper_bound(starts.begin(), starts.end(), k) - starts.begin()) - 1;
+        };
+        parallel::for_ranges(left_starts.back(), threads, 4096, [&](std::size_t, std::size_t first, std::size_t last) {
+            if (first == last) {
+                return;
+            }
+            std::size_t l = locate(left_starts, first);
+            std::size_t r = locate(right_starts, first);
+            std::size_t i = left[l].first + (first - left_starts[l]);
+            std::size_t j = right[r].first + (first - right_starts[r]);
+            for (std::size_t k = first; k < last; k++) {
+                if (i == left[l].second) {
+                    i = left[++l].first;
+                }
+                if (j == right[r].second) {
+                    j = right[++r].first;
+                }
+                std::swap(data[i++], data[j++]);
+            }
+        });
+        return point;
+    }
+
+    /// Evaluates `pred` on every element and works out where each per-thread range sends its elements. The ranges are
+    /// those `parallel::for_ranges(size(), threads, 4096, ...)` uses, which are the same on every call.
+    template <class Pred>
+    auto place(Pred& pred, std::size_t threads) const -> Placement {
+        const T* data = self.data();
+        auto placement = Placement();
+        placement.matches.reset(new bool[self.size()]);
+        bool* matches = placement.matches.get();
+        auto firsts = std::vector<std::size_t>(threads);
+        auto counts = std::vector<std::size_t>(threads);
+        threads = parallel::for_ranges(self.size(), threads, 4096,
+                                       [&](std::size_t t, std::size_t first, std::size_t last) {
+            std::size_t count = 0;
+            for (std::size_t i = first; i < last; i++) {
+                matches[i] = pred(data[i]);
+                count += matches[i];
+            }
+            firsts[t] = first;
+            counts[t] = count;
+        });
+        placement.threads = threads;
+        placement.yes.resize(threads);
+        placement.no.resize(threads);
+        for (std::size_t t = 0; t < threads; t++) {
+            placement.yes[t] = placement.point;
+            placement.no[t] = firsts[t] - placement.point;
+            placement.point += counts[t];
+        }
+        return placement;
+    }
+
+    /// Copies the matching elements to `yes` and the others to `no`, each in order, as `placement` planned.
+    auto scatter_placed(const Placement& placement, T* yes, T* no) const -> void {
+        const T* data = self.data();
+        parallel::for_ranges(self.size(), placement.threads, 4096,
+                             [&](std::size_t t, std::size_t first, std::size_t last) {
+            vector::scatter_block(data + first, data + last, placement.matches.get() + first,
+                                  yes + placement.yes[t], no + placement.no[t]);
+        });
+    }
+
+    /// Hash tables with more slots than fit in this many bytes miss the cache often enough that sorting is faster.
+    static constexpr std::size_t table_bytes = std::size_t(1) << 22;
+
+    /// Hashes `val`, mixing the result of `std::hash` (the identity for integers) so that its low bits are usable.
+    static auto hash_of(const T& val) -> std::uint64_t {
+        return vector::mix(static_cast<std::uint64_t>(std::hash<T>()(val)));
+    }
+
+    /// An open-addressing set of element positions, probed linearly. Elements are compared at their stored positions,
+    /// so none are copied. The table starts with room for `expected` positions and doubles when it would pass half
+    /// full.
+    class PositionSet {
+        static constexpr std::size_t empty = std::numeric_limits<std::size_t>::max();
+        std::vector<std::size_t> slots;
+        std::size_t count = 0;
+
+        auto place(std::size_t pos, std::uint64_t hash) -> void {
+            std::size_t mask = slots.size() - 1;
+            std::size_t at = hash & mask;
+            while (slots[at] != empty) {
+                at = (at + 1) & mask;
+            }
+            slots[at] = pos;
+        }
+    public:
+        explicit PositionSet(std::size_t expected)
+            : slots(std::bit_ceil(std::max<std::size_t>(16, expected * 2)), empty) {}
+
+        /// Adds `pos` unless an element equal to `val` is already stored, and returns whether it was added. `hash_at`
+        /// returns the hash of the element at a stored position, to rehash when the table grows.
+        template <class HashAt>
+        auto insert(const T* data, const T& val, std::uint64_t hash, std::size_t pos, HashAt hash_at) -> bool {
+            if ((count + 1) * 2 > slots.size()) {
+                auto old = std::exchange(slots, std::vector<std::size_t>(slots.size() * 2, empty));
+                for (std::size_t stored : old) {
+                    if (stored != empty) {
+                        place(stored, hash_at(stored));
+                    }
+                }
+            }
+            std::size_t mask = slots.size() - 1;
+            for (std::size_t at = hash & mask; slots[at] != empty; at = (at + 1) & mask) {
+                if (data[slots[at]] == val) {
+                    return false;
+                }
+            }
+            place(pos, hash);
+            count++;
+            return true;
+        }
+    };
+
+    /// Estimates the number of distinct elements from the hashes of up to 1024 evenly spaced ones. If `d` distinct
+    /// values are seen among `s` samples, `f1` of them once, the estimate is `sqrt(n / s) * f1 + d - f1` (GEE).
+    auto estimate_distinct() const -> std::size_t {
+        std::size_t n = self.size();
+        std::size_t s = std::min<std::size_t>(n, 1024);
+        auto sample = std::vector<std::uint64_t>(s);
+        for (std::size_t i = 0; i < s; i++) {
+            sample[i] = hash_of(self[i * n / s]);
+        }
+        std::sort(sample.begin(), sample.end());
+        std::size_t distinct = 0;
+        std::size_t once = 0;
+        for (std::size_t i = 0; i < s;) {
+            std::size_t j = i + 1;
+            while (j < s && sample[j] == sample[i]) {
+                j++;
+            }
+            distinct++;
+            once += j - i == 1;
+            i = j;
+        }
+        double estimate = s == 0 ? 0.0 : std::sqrt(double(n) / double(s)) * double(once) + double(distinct - once);
+        return std::clamp<std::size_t>(static_cast<std::size_t>(estimate), distinct, n);
+    }
+
+    /// Keeps the first occurrence of each distinct element, in order. Large trivially copyable vectors are split by
+    /// hash into one shard per thread: each thread marks the first occurrences in its shards with its own table, and
+    /// the marked elements are then gathered as in `stable_partition`.
+    auto unique_hashed(std::size_t expected) -> void {
+        if constexpr (bulk_copyable) {
+            std::size_t threads = bulk_threads(self.size());
+            if (threads > 1) {
+                auto keep = std::unique_ptr<bool[]>(new bool[self.size()]);
+                mark_first_occurrences(threads, expected, keep.get());
+                const T* data = self.data();
+                auto kept = [&](const T& val) { return keep[static_cast<std::size_t>(&val - data)]; };
+                auto placement = place(kept, threads);
+                auto scratch = std::unique_ptr<T[]>(new T[self.size()]);
+                scatter_placed(placement, scratch.get(), scratch.get() + placement.point);
+                std::memcpy(self.data(), scratch.get(), placement.point * sizeof(T));
+                self.resize(placement.point);
+                return;
+            }
+        }
+        T* data = self.data();
+        auto seen = PositionSet(expected);
+        auto hash_at = [&](std::size_t pos) { return hash_of(data[pos]); };
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < self.size(); i++) {
+            if (seen.insert(data, data[i], hash_of(data[i]), kept, hash_at)) {
+                if (kept != i) {
+                    data[kept] = std::move(data[i]);
+                }
+                kept++;
+            }
+        }
+        self.erase(self.begin() + static_cast<std::ptrdiff_t>(kept), self.end());
+    }
+
+    /// Sets `keep[i]` for the first occurrence of each distinct element, using `threads` threads. Elements are
+    /// hashed and counted per shard, their positions are scattered into shard order (ascending within each shard),
+    /// and each shard is then scanned with a table sized for its share of `expected`.
+    auto mark_first_occurrences(std::size_t threads, std::size_t expected, bool* keep) const -> void {
+        const T* data = self.data();
+        std::size_t n = self.size();
+        std::size_t shards = threads;
+        auto shard_of = [shards](std::uint64_t hash) {
+            return static_cast<std::size_t>(((hash >> 32) * shards) >> 32);
+        };
+        auto hashes = std::unique_ptr<std::uint64_t[]>(new std::uint64_t[n]);
+        // next[t * shards + s] counts, and later places, range t's elements in shard s.
+        auto next = std::vector<std::size_t>(threads * shards, 0);
+        parallel::for_ranges(n, threads, 4096, [&](std::size_t t, std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; i++) {
+                hashes[i] = hash_of(data[i]);
+                next[t * shards + shard_of(hashes[i])]++;
+            }
+        });
+        auto starts = std::vector<std::size_t>(shards + 1, n);
+        std::size_t at = 0;
+        for (std::size_t s = 0; s < shards; s++) {
+            starts[s] = at;
+            for (std::size_t t = 0; t < threads; t++) {
+                at += std::exchange(next[t * shards + s], at);
+            }
+        }
+        auto order = std::unique_ptr<std::size_t[]>(new std::size_t[n]);
+        parallel::for_ranges(n, threads, 4096, [&](std::size_t t, std::size_t first, std::size_t last) {
+            std::size_t* to = next.data() + t * shards;
+            for (std::size_t i = first; i < last; i++) {
+                order[to[shard_of(hashes[i])]++] = i;
+            }
+        });
+        auto hash_at = [&](std::size_t pos) { return hashes[pos]; };
+        parallel::for_ranges(shards, threads, 1, [&](std::size_t, std::size_t first, std::size_t last) {
+            for (std::size_t s = first; s < last; s++) {
+                auto seen = PositionSet(expected / shards);
+                for (std::size_t k = starts[s]; k < starts[s + 1]; k++) {
+                    std::size_t i = order[k];
+                    keep[i] = seen.insert(data, data[i], hashes[i], i, hash_at);
+                }
+            }
+        });
+    }
+
+    /// Whether `i` is a position in a vector of `n` elements.
+    template <std::integral I>
+    static auto in_bounds(I i, std::size_t n) -> bool {
+        if constexpr (std::is_signed_v<I>) {
+            if (i < 0) {
+                return false;
+            }
+        }
+        return static_cast<std::make_unsigned_t<I>>(i) < n;
+    }
+
+    /// @throws IndexOutOfBounds if any of the `n` indices at `idx` is not a position in this vector.
+    template <std::integral I>
+    auto check_indices(const I* idx, std::size_t n) const -> void {
+        for (std::size_t i = 0; i < n; i++) {
+            if (!in_bounds(idx[i], self.size())) {
+                throw error::IndexOutOfBounds("index outside of vector.");
+            }
+        }
+    }
+
+    /// Whether indexed reads or writes of `n` elements should be grouped by slice of this vector: it must be too
+    /// large for the cache, and hit often enough that each slice is reused.
+    auto partitions(std::size_t n) const -> bool {
+        std::size_t bytes = self.size() * sizeof(T);
+        return bytes >= vector::partition_bytes && n >= 16 * (bytes / vector::slice_bytes);
+    }
+
+    /// Resizes `out` to the size of this vector and sets each of its elements to `convert` of the corresponding
+    /// element here. Trivially copyable conversions run as one flat loop per thread, which compilers vectorize with
+    /// the target's conversion instructions; large vectors use several threads.
+    template <class U, class OutAlloc, class Convert>
+    auto convert_into(Vec<U, OutAlloc>& out, Convert convert) const -> void {
+        if constexpr (bulk_copyable && std::is_trivially_copyable_v<U> && std::is_default_constructible_v<U>) {
+            out.resize(self.size());
+            const T* from = self.data();
+            U* to = out.raw_ptr_begin();
+            std::size_t bytes = self.size() * std::max(sizeof(T), sizeof(U));
+            std::size_t threads = bytes >= parallel_bytes ? parallel::hardware_threads() : 1;
+            parallel::for_ranges(self.size(), threads, 4096, [=](std::size_t, std::size_t first, std::size_t last) {
+                for (std::size_t i = first; i < last; i++) {
+                    to[i] = convert(from[i]);
+                }
+            });
+        } else {
+            out.clear();
+            out.request_cap(self.size());
+            for (const T& val : self) {
+                out.push_back(convert(val));
+            }
+        }
+    }
 public:
+    /// The allocator type of the vector.
+    using Allocator = Alloc;
     /// A constant iterator to the wrapped type.
     using ConstIterator = typename Underlying::const_iterator;
     /// A constant reference to an element in the wrapped type.
@@ -83,31 +862,110 @@ public:
     /// emplace-constructed from its corresponding element in that range, in the same order.
     template <typename SomeIterator>
     requires(vector::IsValidIterator<SomeIterator, T>)
-    static auto from(SomeIterator begin, SomeIterator end) -> Vec<T> {
-        auto result = Vec<T>();
-        result.self = Underlying(begin, end);
+    static auto from(SomeIterator begin, SomeIterator end, const Alloc& alloc = Alloc()) -> Vec {
+        auto result = Vec(alloc);
+        result.self.assign(begin, end);
         return result;
     }
 
     /// Constructs a container with a copy of each of the elements in `other`, in the same order.
-    static auto from(const Vec<T>& other) -> Vec<T> {
-        auto result = Vec<T>();
+    static auto from(const Vec& other) -> Vec {
+        auto result = Vec(other.get_allocator());
         result.self = Underlying(other.self);
         return result;
     }
 
     /// Constructs a container with a copy of each of the elements in `list`, in the same order.
-    static auto from(std::initializer_list<T> list) -> Vec<T> {
+    static auto from(std::initializer_list<T> list) -> Vec {
         return Vec(list);
     }
 
     /// Constructs a container with `n` elements. Each element is a copy of `default_val` (if provided).
-    static auto of(Size n, const T& default_val = T()) -> Vec<T> {
-        auto result = Vec<T>();
-        result.self = Underlying(n, default_val);
+    static auto of(Size n, const T& default_val = T(), const Alloc& alloc = Alloc()) -> Vec {
+        auto result = Vec(alloc);
+        result.self.assign(n, default_val);
+        return result;
+    }
+
+    /// Constructs a container holding the elements of `first` and then of each of `rest`, allocating once from a copy
+    /// of `first`'s allocator. Elements of rvalue parts are moved rather than copied.
+    template <class First, class... Rest>
+    requires (std::same_as<std::remove_cvref_t<First>, Vec> && (std::same_as<std::remove_cvref_t<Rest>, Vec> && ...))
+    static auto concat(First&& first, Rest&&... rest) -> Vec {
+        auto result = Vec(first.get_allocator());
+        result.extend_many(std::forward<First>(first), std::forward<Rest>(rest)...);
         return result;
     }
 
+    /// Constructs a container holding the elements of each vector in `parts` in turn, allocating once from `alloc`.
+    template <std::ranges::forward_range Range>
+    requires (std::same_as<std::ranges::range_value_t<Range>, Vec>)
+    static auto concat(const Range& parts, const Alloc& alloc) -> Vec {
+        auto result = Vec(alloc);
+        result.extend_many(parts);
+        return result;
+    }
+
+    /// Constructs a container holding the elements of each vector in `parts` in turn, allocating once from a copy of
+    /// the first part's allocator, or from a default-constructed one if `parts` is empty.
+    /// @throws InvalidArgument if `parts` is empty and `Alloc` is not default constructible.
+    template <std::ranges::forward_range Range>
+    requires (std::same_as<std::ranges::range_value_t<Range>, Vec>)
+    static auto concat(const Range& parts) -> Vec {
+        auto first = std::ranges::begin(parts);
+        if (first != std::ranges::end(parts)) {
+            return concat(parts, first->get_allocator());
+        }
+        if constexpr (std::default_initializable<Alloc>) {
+            return Vec(Alloc());
+        } else {
+            throw error::InvalidArgument("no allocator to concatenate an empty range of vectors with.");
+        }
+    }
+
+    /// Reorders the vector so element `i` becomes the element previously at `perm[i]`, as `gather(perm)` would
+    /// return, without a second vector. Each cycle of the permutation is followed once, so every element is moved
+    /// once; a bit per element records which are still to move, and the next element of a cycle is prefetched while
+    /// the current one moves.
+    /// @throws InvalidArgument if `perm` is not a permutation of the positions in the vector.
+    template <std::integral I, class IndexAlloc>
+    auto apply_permutation(const Vec<I, IndexAlloc>& perm) -> void {
+        Size n = self.size();
+        const I* p = perm.raw_ptr_begin();
+        if (perm.size() != n) {
+            throw error::InvalidArgument("permutation and vector differ in length.");
+        }
+        auto pending = std::vector<bool>(n, false);
+        for (Size i = 0; i < n; i++) {
+            if (!in_bounds(p[i], n) || pending[static_cast<Size>(p[i])]) {
+                throw error::InvalidArgument("not a permutation of the positions in the vector.");
+            }
+            pending[static_cast<Size>(p[i])] = true;
+        }
+        T* data = self.data();
+        for (Size start = 0; start < n; start++) {
+            if (!pending[start]) {
+                continue;
+            }
+            pending[start] = false;
+            auto from = static_cast<Size>(p[start]);
+            if (from == start) {
+                continue;
+            }
+            T first = std::move(data[start]);
+            Size to = start;
+            while (from != start) {
+                auto next = static_cast<Size>(p[from]);
+                vector::prefetch(data + next);
+                data[to] = std::move(data[from]);
+                pending[from] = false;
+                to = from;
+                from = next;
+            }
+            data[to] = std::move(first);
+        }
+    }
+
     /// Returns a reference to the element at position `i` in the vector.
     /// @throws IndexOutOfBounds if attempting to access an element at an invalid index.
     auto at(Size i) -> Reference {
@@ -128,6 +986,18 @@ public:
         return self.at(i);
     }
 
+    /// Reverses the bytes of every element, e.g. to convert big-endian data to the host's byte order after loading it.
+    /// Large vectors are converted on several threads.
+    auto byteswap_all() -> void
+    requires (std::is_trivially_copyable_v<T>
+              && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)) {
+        T* data = self.data();
+        parallel::for_ranges(self.size(), bulk_threads(self.size()), 4096,
+                             [=](Size, Size first, Size last) {
+            vector::byteswap_block(data + first, last - first);
+        });
+    }
+
     /// Returns an `Iterator` pointing to the first element in the vector.
     auto begin() -> Iterator {
         return self.begin();
@@ -138,11 +1008,74 @@ public:
         return self.begin();
     }
 
+    /// Returns the elements at `indices`, in their order: element `i` of the result is element `indices[i]` of this
+    /// vector. Loads are prefetched ahead, or use hardware gathers where AVX2 is available; if the vector is too large
+    /// for the cache, they are grouped by slice of it. Large results are filled on several threads.
+    /// @throws IndexOutOfBounds if an index is negative or not less than the size of the vector.
+    template <std::integral I, class IndexAlloc>
+    auto gather(const Vec<I, IndexAlloc>& indices) const -> Vec {
+        const I* idx = indices.raw_ptr_begin();
+        Size n = indices.size();
+        check_indices(idx, n);
+        auto out = Vec(self.get_allocator());
+        if constexpr (bulk_copyable) {
+            out.self.resize(n);
+            const T* src = self.data();
+            T* dst = out.self.data();
+            parallel::for_ranges(n, bulk_threads(n), 4096, [&](Size, Size first, Size last) {
+                if (partitions(last - first)) {
+                    vector::gather_partitioned(src, self.size(), idx + first, dst + first, last - first);
+                } else {
+                    vector::gather_indexed(src, self.size(), idx + first, dst + first, last - first);
+                }
+            });
+        } else {
+            out.self.reserve(n);
+            for (Size i = 0; i < n; i++) {
+                out.self.push_back(self[static_cast<Size>(idx[i])]);
+            }
+        }
+        return out;
+    }
+
+    /// Returns a copy of the vector's allocator.
+    auto get_allocator() const -> Alloc {
+        return self.get_allocator();
+    }
+
     /// Returns the capacity of the vector.
     auto cap() const -> Size {
         return self.capacity();
     }
 
+    /// Returns a vector of each element converted to `U` with `static_cast`, e.g. `int32_t` to `float` or `uint8_t` to
+    /// `int32_t`. Out-of-range values behave as `static_cast` does; see `saturate_cast` to clamp them instead.
+    template <class U>
+    requires (std::is_constructible_v<U, const T&>)
+    auto cast() const -> Vec<U> {
+        auto out = Vec<U>();
+        cast_into(out);
+        return out;
+    }
+
+    /// Like `cast`, but writes into `out`, replacing its contents and reusing its storage, so that converting batch
+    /// after batch allocates only while `out` grows.
+    template <class U, class OutAlloc>
+    requires (std::is_constructible_v<U, const T&>)
+    auto cast_into(Vec<U, OutAlloc>& out) const -> void {
+        if constexpr (vector::HasConvertBlock<T, U>) {
+            out.resize(self.size());
+            const T* from = self.data();
+            U* to = out.raw_ptr_begin();
+            std::size_t threads = bulk_threads(self.size());
+            parallel::for_ranges(self.size(), threads, 4096, [=](Size, Size first, Size last) {
+                convert_block(from + first, to + first, last - first);
+            });
+        } else {
+            convert_into(out, [](const T& val) { return static_cast<U>(val); });
+        }
+    }
+
     /// Returns a `ConstIterator` pointing to the first element in the vector.
     auto cbegin() const -> ConstIterator {
         return self.cbegin();
@@ -193,6 +1126,31 @@ public:
         return self.end();
     }
 
+    /// Appends the elements of each of `parts` in turn, growing the vector once. Elements of rvalue parts are moved;
+    /// large trivially copyable inputs are copied in parallel.
+    template <class... Parts>
+    requires (sizeof...(Parts) > 0 && (std::same_as<std::remove_cvref_t<Parts>, Vec> && ...))
+    auto extend_many(Parts&&... parts) -> void {
+        if constexpr (std::is_trivially_copyable_v<T> || (std::is_lvalue_reference_v<Parts> && ...)) {
+            const Vec* list[] = { &parts... };
+            append_all(list, sizeof...(Parts));
+        } else {
+            self.reserve(self.size() + (parts.size() + ...));
+            (append_one(std::forward<Parts>(parts)), ...);
+        }
+    }
+
+    /// Appends the elements of each vector in `parts` in turn, growing the vector once.
+    template <std::ranges::forward_range Range>
+    requires (std::same_as<std::ranges::range_value_t<Range>, Vec>)
+    auto extend_many(const Range& parts) -> void {
+        auto list = std::vector<const Vec*>();
+        for (const Vec& part : parts) {
+            list.push_back(&part);
+        }
+        append_all(list.data(), list.size());
+    }
+
     /// Inserts a sequence of elements of length `n` at position `at`. Each element is a copy of `val`.
     auto fill(ConstIterator at, Size n, const T& val) -> Iterator {
         return self.insert(at, n, val);
@@ -226,6 +1184,41 @@ public:
         return self.max_size();
     }
 
+    /// Reorders the vector so the elements satisfying `pred` come before those that do not, and returns where the two
+    /// meet. Relative order is not kept. Large vectors of trivially copyable elements are partitioned on several
+    /// threads, so `pred` must then be safe to call concurrently.
+    template <class Pred>
+    requires (std::predicate<Pred&, const T&>)
+    auto partition(Pred pred) -> vector::Split<T> {
+        if constexpr (bulk_copyable) {
+            return split_at(partition_in_place(pred, bulk_threads(self.size())));
+        } else {
+            auto mid = std::partition(self.begin(), self.end(), [&](const T& val) { return bool(pred(val)); });
+            return split_at(static_cast<Size>(mid - self.begin()));
+        }
+    }
+
+    /// Returns copies of the elements satisfying `pred` and of those that do not, each in their original order. Large
+    /// vectors of trivially copyable elements are split on several threads, so `pred` must then be safe to call
+    /// concurrently.
+    template <class Pred>
+    requires (std::predicate<Pred&, const T&>)
+    auto partition_copy(Pred pred) const -> std::pair<Vec, Vec> {
+        auto yes = Vec(self.get_allocator());
+        auto no = Vec(self.get_allocator());
+        if constexpr (bulk_copyable) {
+            auto placement = place(pred, bulk_threads(self.size()));
+            yes.self.resize(placement.point);
+            no.self.resize(self.size() - placement.point);
+            scatter_placed(placement, yes.self.data(), no.self.data());
+        } else {
+            for (const T& val : self) {
+                (pred(val) ? yes : no).self.push_back(val);
+            }
+        }
+        return { std::move(yes), std::move(no) };
+    }
+
     /// Returns the last element in the vector.
     /// @throws NoSuchElement if the vector is empty.
     auto peek_back() -> Reference {
@@ -296,7 +1289,7 @@ public:
 
     /// Assigns the contents of the `other` vector to the current vector. The old contents of the vector are replaced
     /// and the size is modified accordingly.
-    auto reassign(const Vec<T>& other) -> void {
+    auto reassign(const Vec& other) -> void {
         self.assign(other.self);
     }
 
@@ -331,6 +1324,111 @@ public:
         self.resize(n, val);
     }
 
+    /// Reverses the order of the elements. Trivially copyable elements are swapped in blocks, and large vectors are
+    /// reversed on several threads.
+    auto reverse() -> void {
+        if constexpr (bulk_copyable) {
+            T* data = self.data();
+            Size n = self.size();
+            parallel::for_ranges(n / 2, bulk_threads(n), 4096, [=](Size, Size first, Size last) {
+                vector::reverse_swap(data + first, data + n - first, last - first);
+            });
+        } else {
+            std::reverse(self.begin(), self.end());
+        }
+    }
+
+    /// Rotates the elements left by `k` places (modulo the size), so the element at `k` becomes the first.
+    /// Trivially copyable elements are rotated by block swaps (Gries-Mills): the shorter of the two sides is swapped
+    /// into its final place, which leaves a smaller rotation to do. Every swap is between two contiguous blocks, and
+    /// large swaps are split across threads. If one side is at most 4 KiB it is set aside in a buffer instead, and
+    /// the other side is moved with a single `memmove`.
+    auto rotate(Size k) -> void {
+        Size n = self.size();
+        if (n == 0 || k % n == 0) {
+            return;
+        }
+        k %= n;
+        if constexpr (bulk_copyable) {
+            T* data = self.data();
+            constexpr Size small = std::max<Size>(1, 4096 / sizeof(T));
+            if (k <= small) {
+                T buffer[small];
+                std::memcpy(buffer, data, k * sizeof(T));
+                std::memmove(data, data + k, (n - k) * sizeof(T));
+                std::memcpy(data + n - k, buffer, k * sizeof(T));
+                return;
+            }
+            if (n - k <= small) {
+                T buffer[small];
+                std::memcpy(buffer, data + k, (n - k) * sizeof(T));
+                std::memmove(data + n - k, data, k * sizeof(T));
+                std::memcpy(data, buffer, (n - k) * sizeof(T));
+                return;
+            }
+            // [data, data + left) is rotated with [data + left, data + left + right); each swap settles one side.
+            T* first = data;
+            Size left = k;
+            Size right = n - k;
+            while (left != right) {
+                if (left < right) {
+                    swap_ranges(first, first + right, left);
+                    right -= left;
+                } else {
+                    swap_ranges(first, first + left, right);
+                    first += right;
+                    left -= right;
+                }
+            }
+            swap_ranges(first, first + left, left);
+        } else {
+            std::rotate(self.begin(), self.begin() + static_cast<std::ptrdiff_t>(k), self.end());
+        }
+    }
+
+    /// Returns a vector of each element converted to `U` by `vector::saturate_cast`: values outside `U`'s range become
+    /// its nearest limit, e.g. 300 becomes 255 in a `uint8_t`, and NaN becomes zero in an integer type.
+    template <vector::IsSaturable U>
+    requires (vector::IsSaturable<T>)
+    auto saturate_cast() const -> Vec<U> {
+        auto out = Vec<U>();
+        saturate_cast_into(out);
+        return out;
+    }
+
+    /// Like `saturate_cast`, but writes into `out`, replacing its contents and reusing its storage.
+    template <vector::IsSaturable U, class OutAlloc>
+    requires (vector::IsSaturable<T>)
+    auto saturate_cast_into(Vec<U, OutAlloc>& out) const -> void {
+        convert_into(out, [](T val) { return vector::saturate_cast<U>(val); });
+    }
+
+    /// Sets element `indices[i]` of this vector to `values[i]` for each `i` in turn, so the last write to a repeated
+    /// index wins. Stores are prefetched ahead; if the vector is too large for the cache, they are grouped by slice of
+    /// it.
+    /// @throws InvalidArgument if `indices` and `values` differ in length.
+    /// @throws IndexOutOfBounds if an index is negative or not less than the size of the vector.
+    template <std::integral I, class IndexAlloc>
+    auto scatter(const Vec<I, IndexAlloc>& indices, const Vec& values) -> void {
+        const I* idx = indices.raw_ptr_begin();
+        Size n = indices.size();
+        if (values.size() != n) {
+            throw error::InvalidArgument("indices and values differ in length.");
+        }
+        check_indices(idx, n);
+        if constexpr (bulk_copyable) {
+            if (partitions(n)) {
+                vector::scatter_partitioned(self.data(), self.size(), idx, values.self.data(), n);
+            } else {
+                vector::scatter_indexed(self.data(), idx, values.self.data(), n);
+            }
+        } else {
+            for (Size i = 0; i < n; i++) {
+                self[static_cast<Size>(idx[i])] = values.self[i];
+            }
+        }
+    }
+
     /// Returns the size of the vector.
     auto size() const -> Size {
         return self.size();
@@ -341,18 +1439,108 @@ public:
         self.shrink_to_fit();
     }
 
+    /// Reorders the vector so the elements satisfying `pred` come before those that do not, keeping the relative order
+    /// within each side, and returns where the two meet. Large vectors of trivially copyable elements are split on
+    /// several threads, so `pred` must then be safe to call concurrently.
+    template <class Pred>
+    requires (std::predicate<Pred&, const T&>)
+    auto stable_partition(Pred pred) -> vector::Split<T> {
+        if constexpr (bulk_copyable) {
+            auto placement = place(pred, bulk_threads(self.size()));
+            auto scratch = std::unique_ptr<T[]>(new T[self.size()]);
+            scatter_placed(placement, scratch.get(), scratch.get() + placement.point);
+            T* data = self.data();
+            parallel::for_ranges(self.size(), placement.threads, 4096, [&](Size, Size first, Size last) {
+                if (first < last) {
+                    std::memcpy(data + first, scratch.get() + first, (last - first) * sizeof(T));
+                }
+            });
+            return split_at(placement.point);
+        } else {
+            auto mid = std::stable_partition(self.begin(), self.end(), [&](const T& val) { return bool(pred(val)); });
+            return split_at(static_cast<Size>(mid - self.begin()));
+        }
+    }
+
     /// Exchanges the content of the vector by the content of the `other` vector of the same type.
     /// Sizes may differ.
     auto swap(Vec& other) -> void {
         self.swap(other);
     }
 
+    /// Removes repeats of adjacent equal elements, which in a sorted vector leaves one of each distinct element. For
+    /// trivially copyable elements, each per-thread range is compacted without data-dependent branches, and the
+    /// compacted ranges are then joined. Large vectors use several threads.
+    auto unique_sorted() -> void
+    requires (std::equality_comparable<T>) {
+        if constexpr (bulk_copyable) {
+            T* data = self.data();
+            std::size_t threads = bulk_threads(self.size());
+            auto firsts = std::vector<Size>(threads);
+            auto counts = std::vector<Size>(threads);
+            threads = parallel::for_ranges(self.size(), threads, 4096, [&](Size t, Size first, Size last) {
+                firsts[t] = first;
+                counts[t] = vector::unique_block(data + first, data + last);
+            });
+            // A range's first element is dropped if it repeats the last one kept before it.
+            Size kept = 0;
+            for (Size t = 0; t < threads; t++) {
+                const T* from = data + firsts[t];
+                Size count = counts[t];
+                if (count > 0 && kept > 0 && data[kept - 1] == *from) {
+                    from++;
+                    count--;
+                }
+                if (count > 0 && from != data + kept) {
+                    std::memmove(data + kept, from, count * sizeof(T));
+                }
+                kept += count;
+            }
+            self.resize(kept);
+        } else {
+            self.erase(std::unique(self.begin(), self.end()), self.end());
+        }
+    }
+
+    /// Removes duplicate elements, keeping the first occurrence of each in its original order. Duplicates are found
+    /// with a flat hash table sized from an estimate of the number of distinct elements; large trivially copyable
+    /// vectors are split by hash across threads.
+    auto unique_stable() -> void
+    requires (std::equality_comparable<T> && vector::IsHashable<T>) {
+        unique_hashed(estimate_distinct());
+    }
+
+    /// Removes duplicate elements, leaving one of each in no particular order. The strategy follows an estimate of
+    /// the number of distinct elements: if a hash table of them would outgrow the cache and the vector is not large
+    /// enough to split across threads, the vector is sorted and `unique_sorted` applied; otherwise duplicates are
+    /// removed as in `unique_stable`. Elements that are only hashable, or only ordered, always take the one way
+    /// available to them.
+    auto unique_unordered() -> void
+    requires (std::equality_comparable<T> && (vector::IsHashable<T> || std::totally_ordered<T>)) {
+        if constexpr (vector::IsHashable<T>) {
+            Size expected = estimate_distinct();
+            if constexpr (std::totally_ordered<T>) {
+                if (bulk_threads(self.size()) > 1 || expected * 2 * sizeof(std::size_t) <= table_bytes) {
+                    unique_hashed(expected);
+                    return;
+                }
+            } else {
+                unique_hashed(expected);
+                return;
+            }
+        }
+        if constexpr (std::totally_ordered<T>) {
+            std::sort(self.begin(), self.end());
+            unique_sorted();
+        }
+    }
+
     /// Applies a `Pattern` to the vector, modifying each element to satisfy the pattern.
     /// @note This method is only available to vectors of a numeric type (e.g. int, char).
     /// @see Pattern
     template <class U>
     requires (std::numeric_limits<U>::is_integer)
-    auto with(const pattern::Pattern<U>& pat) -> Vec<T> {
+    auto with(const pattern::Pattern<U>& pat) -> Vec {
         for (Size i = 1; i < self.size(); i++) {
             self[i] = pat(self[i - 1]);
         }
@@ -360,7 +1548,7 @@ public:
     }
 
     /// Send the contents of the vector as a string to std::ostream.
-    friend auto operator<<(std::ostream& os, const Vec<T>& vec) -> std::ostream& {
+    friend auto operator<<(std::ostream& os, const Vec& vec) -> std::ostream& {
         os << "[";
         for (auto iter = vec.cbegin(); iter != vec.cend(); iter++) {
             os << *iter;
@@ -372,6 +1560,35 @@ public:
         return os;
     }
 
+    /// Returns if `a` and `b` have the same elements in the same order. Bitwise comparable elements are compared with
+    /// `memcmp`.
+    friend auto operator==(const Vec& a, const Vec& b) -> bool requires (std::equality_comparable<T>) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        if constexpr (vector::IsBitwiseComparable<T>) {
+            return a.is_empty() || std::memcmp(a.self.data(), b.self.data(), a.size() * sizeof(T)) == 0;
+        } else {
+            return std::equal(a.self.begin(), a.self.end(), b.self.begin());
+        }
+    }
+
+    /// Compares `a` and `b` lexicographically. For bitwise comparable elements, the first differing element is found
+    /// by comparing bytes in blocks.
+    friend auto operator<=>(const Vec& a, const Vec& b) requires (std::three_way_comparable<T>) {
+        if constexpr (vector::IsBitwiseComparable<T>) {
+            Size common = std::min(a.size(), b.size());
+            Size at = 0;
+            if (common > 0) {
+                at = vector::mismatch_bytes(a.self.data(), b.self.data(), common * sizeof(T)) / sizeof(T);
+            }
+            return at < common ? std::compare_three_way()(a.self[at], b.self[at])
+                               : std::compare_three_way_result_t<T>(a.size() <=> b.size());
+        } else {
+            return std::lexicographical_compare_three_way(a.self.begin(), a.self.end(), b.self.begin(), b.self.end());
+        }
+    }
+
     /// Access the `i`th element of the vector.
     /// @throws IndexOutOfBounds if attempting to access an element at an invalid index.
     auto operator[](Size i) -> Reference {
@@ -387,6 +1604,26 @@ public:
 
     /// Constructs a vector with a copy of each of the elements in `list`, in the same order.
     Vec(std::initializer_list<T> list) { self = Underlying(list); }
+
+    /// Construct an empty vector that allocates from `alloc`.
+    explicit Vec(const Alloc& alloc) : self(alloc) {}
+};
+
+/// Hashes a `Vec` so that it can key unordered containers. Bitwise comparable elements are hashed as one block of
+/// bytes with `vector::hash_bytes`; other elements are hashed with `std::hash<T>` and combined.
+template <class T, class Alloc>
+struct std::hash<Vec<T, Alloc>> {
+    auto operator()(const Vec<T, Alloc>& vec) const -> std::size_t {
+        if constexpr (::vector::IsBitwiseComparable<T>) {
+            return static_cast<std::size_t>(::vector::hash_bytes(vec.raw_ptr_begin(), vec.size() * sizeof(T)));
+        } else {
+            std::uint64_t h = vec.size();
+            for (const T& val : vec) {
+                h = std::rotl((h ^ static_cast<std::uint64_t>(std::hash<T>()(val))) * 0x9FB21C651E98DF25ull, 29);
+            }
+            return static_cast<std::size_t>(h ^ (h >> 32));
+        }
+    }
 };
 
 #endif //TOOLS_VEC_H